@@ -208,13 +208,10 @@ void BasescapeState::init()
 	_edtBase->setText(_base->getName());
 
 	// Get area
-	for (std::vector<Region*>::iterator i = _game->getSavedGame()->getRegions()->begin(); i != _game->getSavedGame()->getRegions()->end(); ++i)
+	Region *region = _game->getSavedGame()->locateRegion(_base->getLongitude(), _base->getLatitude(), _game->getRuleset());
+	if (region)
 	{
-		if ((*i)->getRules()->insideRegion(_base->getLongitude(), _base->getLatitude()))
-		{
-			_txtLocation->setText(tr((*i)->getRules()->getType()));
-			break;
-		}
+		_txtLocation->setText(tr(region->getRules()->getType()));
 	}
 
 	_txtFunds->setText(tr("STR_FUNDS").arg(Text::formatFunding(_game->getSavedGame()->getFunds())));
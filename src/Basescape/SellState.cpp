@@ -331,9 +331,10 @@ void SellState::btnOkClick(Action *)
 				}
 
 				// Remove items from craft
-				for (std::map<std::string, int>::iterator it = craft->getItems()->getContents()->begin(); it != craft->getItems()->getContents()->end(); ++it)
+				const std::vector<int> &items = craft->getItems()->getContents();
+				for (size_t it = 0; it < items.size(); ++it)
 				{
-					_base->getItems()->addItem(it->first, it->second);
+					_base->getItems()->addItem(it, items[it]);
 				}
 
 				// Remove soldiers from craft
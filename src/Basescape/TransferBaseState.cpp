@@ -106,13 +106,10 @@ TransferBaseState::TransferBaseState(Base *base) : _base(base), _bases()
 		{
 			// Get area
 			std::wstring area = L"";
-			for (std::vector<Region*>::iterator j = _game->getSavedGame()->getRegions()->begin(); j != _game->getSavedGame()->getRegions()->end(); ++j)
+			Region *region = _game->getSavedGame()->locateRegion((*i)->getLongitude(), (*i)->getLatitude(), _game->getRuleset());
+			if (region)
 			{
-				if ((*j)->getRules()->insideRegion((*i)->getLongitude(), (*i)->getLatitude()))
-				{
-					area = tr((*j)->getRules()->getType());
-					break;
-				}
+				area = tr(region->getRules()->getType());
 			}
 
 			_lstBases->addRow(2, (*i)->getName().c_str(), area.c_str());
@@ -35,6 +35,9 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/Options.h"
+#include "../Engine/ThreadPool.h"
+#include "../Engine/Profiler.h"
 #include "../Ruleset/Armor.h"
 #include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
@@ -52,7 +55,7 @@ namespace OpenXcom
  */
 AlienBAIState::AlienBAIState(SavedBattleGame *save, BattleUnit *unit, Node *node) : BattleAIState(save, unit), _aggroTarget(0), _knownEnemies(0), _visibleEnemies(0), _spottingEnemies(0),
 																				_escapeTUs(0), _ambushTUs(0), _reserveTUs(0), _rifle(false), _melee(false), _blaster(false),
-																				_wasHit(false), _didPsi(false), _AIMode(AI_PATROL), _closestDist(100), _fromNode(node), _toNode(0)
+																				_wasHit(false), _didPsi(false), _AIMode(AI_PATROL), _closestDist(100), _fromNode(node), _toNode(0), _reachableTUs(0), _reachableWithAttackTUs(-1)
 {
 	_traceAI = Options::traceAI;
 
@@ -141,6 +144,10 @@ void AlienBAIState::exit()
  */
 void AlienBAIState::think(BattleAction *action)
 {
+	Profiler::Scope profile(Profiler::PHASE_AI);
+	// think with a stream of our own, so the battle's stream moves on the same however long we deliberate
+	RNG::Stream rng = RNG::split();
+	RNG::StreamScope scope(&rng);
  	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon();
@@ -155,7 +162,8 @@ void AlienBAIState::think(BattleAction *action)
 	_melee = false;
 	_rifle = false;
 	_blaster = false;
-	_reachable = _save->getPathfinding()->findReachable(_unit, _unit->getTimeUnits());
+	_reachableTUs = _unit->getTimeUnits();
+	_reachableWithAttackTUs = -1;
 	if(_unit->getCharging() && _unit->getCharging()->isOut())
 	{
 		_unit->setCharging(0);
@@ -191,18 +199,18 @@ void AlienBAIState::think(BattleAction *action)
 			if (!rule->isWaypoint())
 			{
 				_rifle = true;
-				_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, _unit->getTimeUnits() - _unit->getActionTUs(BA_SNAPSHOT, action->weapon));
+				_reachableWithAttackTUs = std::max(0, _unit->getTimeUnits() - _unit->getActionTUs(BA_SNAPSHOT, action->weapon));
 			}
 			else
 			{
 				_blaster = true;
-				_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, _unit->getTimeUnits() - _unit->getActionTUs(BA_AIMEDSHOT, action->weapon));
+				_reachableWithAttackTUs = std::max(0, _unit->getTimeUnits() - _unit->getActionTUs(BA_AIMEDSHOT, action->weapon));
 			}
 		}
 		else if (rule->getBattleType() == BT_MELEE)
 		{
 			_melee = true;
-			_reachableWithAttack = _save->getPathfinding()->findReachable(_unit, _unit->getTimeUnits() - _unit->getActionTUs(BA_HIT, action->weapon));
+			_reachableWithAttackTUs = std::max(0, _unit->getTimeUnits() - _unit->getActionTUs(BA_HIT, action->weapon));
 		}
 	}
 
@@ -265,7 +273,7 @@ void AlienBAIState::think(BattleAction *action)
 	}
 	if (_spottingEnemies > 2
 		|| _unit->getHealth() < 2 * _unit->getStats()->health / 3
-		|| (_aggroTarget && _aggroTarget->getTurnsSinceSpotted() > _intelligence))
+		|| (_aggroTarget && !isKnown(_aggroTarget)))
 	{
 		evaluate = true;
 	}
@@ -573,60 +581,52 @@ void AlienBAIState::setupAmbush()
 
 	if (selectClosestKnownEnemy())
 	{
-		Position target;
-		const int BASE_SYSTEMATIC_SUCCESS = 100;
-		const int COVER_BONUS = 25;
 		const int FAST_PASS_THRESHOLD = 80;
 		Position origin = _save->getTileEngine()->getSightOriginVoxel(_aggroTarget);
 
 		// we'll use node positions for this, as it gives map makers a good degree of control over how the units will use the environment.
+		AmbushPlan plan;
+		plan.ai = this;
+		plan.origin = origin;
+		plan.reach = &_save->getPathfinding()->getReachMap(_unit, _reachableTUs);
+		plan.moveReach = getMoveReach();
+		plan.targetReach = &_save->getPathfinding()->getReachMap(_aggroTarget, 1000, false);
+		plan.tuMax = _reachableWithAttackTUs;
 		for (std::vector<Node*>::const_iterator i = _save->getNodes()->begin(); i != _save->getNodes()->end(); ++i)
 		{
-			Position pos = (*i)->getPosition();
-			Tile *tile = _save->getTile(pos);
-			if (tile == 0 || _save->getTileEngine()->distance(pos, _unit->getPosition()) > 10 || pos.z != _unit->getPosition().z || tile->getDangerous() ||
-				std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
-				continue; // just ignore unreachable tiles
+			plan.tiles.push_back(PlanTile((*i)->getPosition()));
+		}
 
-			if (_traceAI)
+		int batch = getPlanBatchSize();
+		bool done = false;
+		for (plan.first = 0; plan.first < (int)plan.tiles.size() && !done; plan.first += batch)
+		{
+			int count = std::min(batch, (int)plan.tiles.size() - plan.first);
+			getThreadPool()->run(scoreAmbushTile, &plan, count);
+			for (int i = plan.first; i < plan.first + count; ++i)
 			{
-				// colour all the nodes in range purple.
-				tile->setPreview(10);
-				tile->setMarkerColor(13);
-			}
+				const PlanTile &candidate = plan.tiles[i];
+				if (!candidate.considered)
+					continue; // just ignore unreachable tiles
 
-			// make sure we can't be seen here.
-			if (!_save->getTileEngine()->canTargetUnit(&origin, tile, &target, _aggroTarget, _unit) && !getSpottingUnits(pos))
-			{
-				_save->getPathfinding()->calculate(_unit, pos);
-				int ambushTUs = _save->getPathfinding()->getTotalTUCost();
-				// make sure we can move here
-				if (_save->getPathfinding()->getStartDirection() != -1)
+				if (_traceAI)
 				{
-					int score = BASE_SYSTEMATIC_SUCCESS;
-					score -= ambushTUs;
-
-					// make sure our enemy can reach here too.
-					_save->getPathfinding()->calculate(_aggroTarget, pos);
+					// colour all the nodes in range purple.
+					Tile *tile = _save->getTile(candidate.pos);
+					tile->setPreview(10);
+					tile->setMarkerColor(13);
+				}
 
-					if (_save->getPathfinding()->getStartDirection() != -1)
+				if (candidate.usable && candidate.score > bestScore)
+				{
+					path = plan.targetReach->getPath(_save->getTileIndex(candidate.pos));
+					bestScore = candidate.score;
+					_ambushTUs = (candidate.pos == _unit->getPosition()) ? 1 : candidate.tuCost;
+					_ambushAction->target = candidate.pos;
+					if (bestScore > FAST_PASS_THRESHOLD)
 					{
-						// ideally we'd like to be behind some cover, like say a window or a low wall.
-						if (_save->getTileEngine()->faceWindow(pos) != -1)
-						{
-							score += COVER_BONUS;
-						}
-						if (score > bestScore)
-						{
-							path = _save->getPathfinding()->copyPath();
-							bestScore = score;
-							_ambushTUs = (pos == _unit->getPosition()) ? 1 : ambushTUs;
-							_ambushAction->target = pos;
-							if (bestScore > FAST_PASS_THRESHOLD)
-							{
-								break;
-							}
-						}
+						done = true;
+						break;
 					}
 				}
 			}
@@ -756,172 +756,75 @@ void AlienBAIState::setupAttack()
  */
 void AlienBAIState::setupEscape()
 {
-	int unitsSpottingMe = getSpottingUnits(_unit->getPosition());
-	int currentTilePreference = 15;
 	int tries = -1;
 	bool coverFound = false;
 	selectNearestTarget();
 	_escapeTUs = 0;
 
-	int dist = _aggroTarget ? _save->getTileEngine()->distance(_unit->getPosition(), _aggroTarget->getPosition()) : 0;
-
 	int bestTileScore = -100000;
-	int score = -100000;
 	Position bestTile(0, 0, 0);
 
-	Tile *tile = 0;
-
-	// weights of various factors in choosing a tile to which to withdraw
-	const int EXPOSURE_PENALTY = 10;
-	const int FIRE_PENALTY = 40;
-	const int BASE_SYSTEMATIC_SUCCESS = 100;
-	const int BASE_DESPERATE_SUCCESS = 110;
 	const int FAST_PASS_THRESHOLD = 100; // a score that's good engouh to quit the while loop early; it's subjective, hand-tuned and may need tweaking
 
-	std::vector<Position> randomTileSearch = _save->getTileSearch();
-	RNG::shuffle(randomTileSearch);
-	
-	while (tries < 150 && !coverFound)
+	EscapePlan plan;
+	plan.ai = this;
+	plan.unitsSpottingMe = getSpottingUnits(_unit->getPosition());
+	plan.dist = _aggroTarget ? _save->getTileEngine()->distance(_unit->getPosition(), _aggroTarget->getPosition()) : 0;
+	plan.reach = &_save->getPathfinding()->getReachMap(_unit, _reachableTUs);
+	plan.moveReach = getMoveReach();
+	plan.tuMax = _reachableTUs;
+	plan.randomTileSearch = _save->getTileSearch();
+	RNG::shuffle(plan.randomTileSearch);
+	// every try draws from its own stream, so the outcome doesn't depend on how the tries are split across threads
+	plan.rng = RNG::split();
+	for (int i = -1; i < 150; ++i)
 	{
-		_escapeAction->target = _unit->getPosition(); // start looking in a direction away from the enemy
-					
-		if (!_save->getTile(_escapeAction->target))
-		{
-			_escapeAction->target = _unit->getPosition(); // cornered at the edge of the map perhaps? 
-		}
-		
-		score = 0;
+		plan.tiles.push_back(PlanTile(_unit->getPosition()));
+	}
 
-		if (tries == -1)
-		{
-			// you know, maybe we should just stay where we are and not risk reaction fire... 
-			// or maybe continue to wherever we were running to and not risk looking stupid
-			if (_save->getTile(_unit->lastCover) != 0)
-			{
-				_escapeAction->target = _unit->lastCover;
-			} 
-		}
-		else if (tries < 121) 
-		{
-			// looking for cover
-			_escapeAction->target.x += randomTileSearch[tries].x;
-			_escapeAction->target.y += randomTileSearch[tries].y;
-			score = BASE_SYSTEMATIC_SUCCESS;
-			if (_escapeAction->target == _unit->getPosition()) 
-			{
-				if (unitsSpottingMe > 0)
-				{
-					// maybe don't stay in the same spot? move or something if there's any point to it?
-					_escapeAction->target.x += RNG::generate(-20,20);
-					_escapeAction->target.y += RNG::generate(-20,20);
-				}
-				else
-				{
-					score += currentTilePreference;
-				}
-			}
-		}
-		else
+	int batch = getPlanBatchSize();
+	for (plan.first = 0; plan.first < (int)plan.tiles.size() && !coverFound; plan.first += batch)
+	{
+		int count = std::min(batch, (int)plan.tiles.size() - plan.first);
+		getThreadPool()->run(scoreEscapeTile, &plan, count);
+		for (int i = plan.first; i < plan.first + count && !coverFound; ++i)
 		{
-			
-			if (tries == 121) 
-			{ 
-				if (_traceAI) 
-				{
-					Log(LOG_INFO) << "best score after systematic search was: " << bestTileScore; 
-				}
-			}
-						
-			score = BASE_DESPERATE_SUCCESS; // ruuuuuuun
-			_escapeAction->target = _unit->getPosition();
-			_escapeAction->target.x += RNG::generate(-10,10);
-			_escapeAction->target.y += RNG::generate(-10,10);
-			_escapeAction->target.z = _unit->getPosition().z + RNG::generate(-1,1);
-			if (_escapeAction->target.z < 0)
+			const PlanTile &candidate = plan.tiles[i];
+			if (tries == 121 && _traceAI)
 			{
-				_escapeAction->target.z = 0;
+				Log(LOG_INFO) << "best score after systematic search was: " << bestTileScore;
 			}
-			else if (_escapeAction->target.z >= _save->getMapSizeZ()) 
-			{
-				_escapeAction->target.z = _unit->getPosition().z;
-			}
-		}
-
-		tries++;
+			tries++;
 
-		// THINK, DAMN YOU
-		tile = _save->getTile(_escapeAction->target);
-		int distanceFromTarget = _aggroTarget ? _save->getTileEngine()->distance(_aggroTarget->getPosition(), _escapeAction->target) : 0;
-		if (dist >= distanceFromTarget)
-		{
-			score -= (distanceFromTarget - dist) * 10;
-		}
-		else
-		{
-			score += (distanceFromTarget - dist) * 10;
-		}
-		int spotters = 0;
-		if (!tile) 
-		{
-			score = -100001; // no you can't quit the battlefield by running off the map. 
-		}
-		else
-		{
-			spotters = getSpottingUnits(_escapeAction->target);
-			if (std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(_escapeAction->target))  == _reachable.end())
+			Tile *tile = _save->getTile(candidate.pos);
+			if (tile && !candidate.usable)
 				continue; // just ignore unreachable tiles
-					
-			if (_spottingEnemies || spotters)
-			{
-				if (_spottingEnemies <= spotters)
-				{
-					score -= (1 + spotters - _spottingEnemies) * EXPOSURE_PENALTY; // that's for giving away our position
-				}
-				else
-				{
-					score += (_spottingEnemies - spotters) * EXPOSURE_PENALTY;
-				}
-			}
-			if (tile->getFire())
-			{
-				score -= FIRE_PENALTY;
-			}
-			if (tile->getDangerous())
-			{
-				score -= BASE_SYSTEMATIC_SUCCESS;
-			}
 
-			if (_traceAI)
+			if (tile && _traceAI)
 			{
-				tile->setMarkerColor(score < 0 ? 3 : (score < FAST_PASS_THRESHOLD/2 ? 8 : (score < FAST_PASS_THRESHOLD ? 9 : 5)));
+				tile->setMarkerColor(candidate.score < 0 ? 3 : (candidate.score < FAST_PASS_THRESHOLD/2 ? 8 : (candidate.score < FAST_PASS_THRESHOLD ? 9 : 5)));
 				tile->setPreview(10);
-				tile->setTUMarker(score);
+				tile->setTUMarker(candidate.score);
 			}
 
-		}
-
-		if (tile && score > bestTileScore)
-		{
-			// calculate TUs to tile; we could be getting this from findReachable() somehow but that would break something for sure...
-			_save->getPathfinding()->calculate(_unit, _escapeAction->target);
-			if (_escapeAction->target == _unit->getPosition() || _save->getPathfinding()->getStartDirection() != -1)
+			if (tile && candidate.score > bestTileScore)
 			{
-				bestTileScore = score;
-				bestTile = _escapeAction->target;
-				_escapeTUs = _save->getPathfinding()->getTotalTUCost();
-				if (_escapeAction->target == _unit->getPosition())
+				// the reachability check already told us what the move costs.
+				bestTileScore = candidate.score;
+				bestTile = candidate.pos;
+				_escapeTUs = candidate.tuCost;
+				if (candidate.pos == _unit->getPosition())
 				{
 					_escapeTUs = 1;
 				}
 				if (_traceAI)
 				{
-					tile->setMarkerColor(score < 0 ? 7 : (score < FAST_PASS_THRESHOLD/2 ? 10 : (score < FAST_PASS_THRESHOLD ? 4 : 5)));
+					tile->setMarkerColor(candidate.score < 0 ? 7 : (candidate.score < FAST_PASS_THRESHOLD/2 ? 10 : (candidate.score < FAST_PASS_THRESHOLD ? 4 : 5)));
 					tile->setPreview(10);
-					tile->setTUMarker(score);
+					tile->setTUMarker(candidate.score);
 				}
+				if (bestTileScore > FAST_PASS_THRESHOLD) coverFound = true; // good enough, gogogo
 			}
-			_save->getPathfinding()->abortPath();
-			if (bestTileScore > FAST_PASS_THRESHOLD) coverFound = true; // good enough, gogogo
 		}
 	}
 	_escapeAction->target = bestTile;
@@ -1124,7 +1027,7 @@ bool AlienBAIState::selectPointNearTarget(BattleUnit *target, int maxTUs) const
 				if (x || y) // skip the unit itself
 				{
 					Position checkPath = target->getPosition() + Position (x, y, z);
-					if (_save->getTile(checkPath) == 0 || std::find(_reachable.begin(), _reachable.end(), _save->getTileIndex(checkPath))  == _reachable.end())
+					if (_save->getTile(checkPath) == 0 || getReachCost(checkPath, _reachableTUs) == -1)
 						continue;
 					int dir = _save->getTileEngine()->getDirectionTo(checkPath, target->getPosition());
 					bool valid = _save->getTileEngine()->validMeleeRange(checkPath, dir, _unit, target, 0);
@@ -1398,47 +1301,40 @@ bool AlienBAIState::findFirePoint()
 {
 	if (!selectClosestKnownEnemy())
 		return false;
-	std::vector<Position> randomTileSearch = _save->getTileSearch();
-	RNG::shuffle(randomTileSearch);
-	Position target;
-	const int BASE_SYSTEMATIC_SUCCESS = 100;
 	const int FAST_PASS_THRESHOLD = 125;
 	int bestScore = 0;
 	_attackAction->type = BA_RETHINK;
+
+	FirePointPlan plan;
+	plan.ai = this;
+	plan.reach = &_save->getPathfinding()->getReachMap(_unit, _reachableTUs);
+	plan.moveReach = getMoveReach();
+	plan.tuMax = _reachableWithAttackTUs;
+	std::vector<Position> randomTileSearch = _save->getTileSearch();
+	RNG::shuffle(randomTileSearch);
 	for (std::vector<Position>::const_iterator i = randomTileSearch.begin(); i != randomTileSearch.end(); ++i)
 	{
-		Position pos = _unit->getPosition() + *i;
-		Tile *tile = _save->getTile(pos);
-		if (tile == 0  ||
-			std::find(_reachableWithAttack.begin(), _reachableWithAttack.end(), _save->getTileIndex(pos))  == _reachableWithAttack.end())
-			continue;
-		int score = 0;
-		// i should really make a function for this
-		Position origin = (pos * Position(16,16,24)) + 
-			// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
-			Position(8,8, _unit->getHeight() + _unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+		plan.tiles.push_back(PlanTile(_unit->getPosition() + *i));
+	}
 
-		if (_save->getTileEngine()->canTargetUnit(&origin, _aggroTarget->getTile(), &target, _unit))
+	int batch = getPlanBatchSize();
+	bool done = false;
+	for (plan.first = 0; plan.first < (int)plan.tiles.size() && !done; plan.first += batch)
+	{
+		int count = std::min(batch, (int)plan.tiles.size() - plan.first);
+		getThreadPool()->run(scoreFirePoint, &plan, count);
+		for (int i = plan.first; i < plan.first + count; ++i)
 		{
-			_save->getPathfinding()->calculate(_unit, pos);
-			// can move here
-			if (_save->getPathfinding()->getStartDirection() != -1)
+			const PlanTile &candidate = plan.tiles[i];
+			if (candidate.usable && candidate.score > bestScore)
 			{
-				score = BASE_SYSTEMATIC_SUCCESS - getSpottingUnits(pos) * 10;
-				score += _unit->getTimeUnits() - _save->getPathfinding()->getTotalTUCost();
-				if (!_aggroTarget->checkViewSector(pos))
+				bestScore = candidate.score;
+				_attackAction->target = candidate.pos;
+				_attackAction->finalFacing = _save->getTileEngine()->getDirectionTo(candidate.pos, _aggroTarget->getPosition());
+				if (candidate.score > FAST_PASS_THRESHOLD)
 				{
-					score += 10;
-				}
-				if (score > bestScore)
-				{
-					bestScore = score;
-					_attackAction->target = pos;
-					_attackAction->finalFacing = _save->getTileEngine()->getDirectionTo(pos, _aggroTarget->getPosition());
-					if (score > FAST_PASS_THRESHOLD)
-					{
-						break;
-					}
+					done = true;
+					break;
 				}
 			}
 		}
@@ -1525,7 +1421,7 @@ bool AlienBAIState::explosiveEfficacy(Position targetPos, BattleUnit *attackingU
 				// don't count people who were already grenaded this turn
 			if ((*i)->getTile()->getDangerous() ||
 				// don't count units we don't know about
-				((*i)->getFaction() == FACTION_PLAYER && (*i)->getTurnsSinceSpotted() > _intelligence))
+				(isEnemy(*i) && !isKnown(*i)))
 				continue;
 
 			// trace a line from the grenade origin to the unit we're checking against
@@ -1536,7 +1432,7 @@ bool AlienBAIState::explosiveEfficacy(Position targetPos, BattleUnit *attackingU
 
 			if (collidesWith == V_UNIT && traj.front() / Position(16,16,24) == (*i)->getPosition())
 			{
-				if ((*i)->getFaction() == FACTION_PLAYER)
+				if (isEnemy(*i))
 				{
 					++enemiesAffected;
 					++efficacy;
@@ -1918,20 +1814,339 @@ bool AlienBAIState::validTarget(BattleUnit *unit, bool assessDanger, bool includ
 		// ignore units that are dead/unconscious
 	if (unit->isOut() ||
 		// they must be units that we "know" about
-		_intelligence < unit->getTurnsSinceSpotted() ||
+		!isKnown(unit) ||
 		// they haven't been grenaded
 		(assessDanger && unit->getTile()->getDangerous()) ||
 		// and they mustn't be on our side
-		unit->getFaction() == FACTION_HOSTILE)
+		unit->getFaction() == _unit->getFaction())
 	{
 		return false;
 	}
 
-	if (includeCivs)
+	if (includeCivs && _unit->getFaction() == FACTION_HOSTILE)
 	{
 		return true;
 	}
 
-	return unit->getFaction() == FACTION_PLAYER;
+	return isEnemy(unit);
+}
+
+/**
+ * Checks if a unit belongs to the side this unit is fighting:
+ * X-Com for the aliens, and the aliens for anyone else
+ * (eg. soldiers left to the AI by the headless benchmark).
+ * @param unit Unit to check.
+ * @return True if the unit is an enemy.
+ */
+bool AlienBAIState::isEnemy(BattleUnit *unit) const
+{
+	if (_unit->getFaction() == FACTION_HOSTILE)
+	{
+		return unit->getFaction() == FACTION_PLAYER;
+	}
+	return unit->getFaction() == FACTION_HOSTILE;
+}
+
+/**
+ * Checks if this unit knows about another unit. The aliens
+ * remember X-Com units for as long as their intelligence
+ * allows, anyone else only knows about what's currently in sight.
+ * @param unit Unit to check.
+ * @return True if the unit is known.
+ */
+bool AlienBAIState::isKnown(BattleUnit *unit) const
+{
+	if (_unit->getFaction() == FACTION_HOSTILE)
+	{
+		return unit->getTurnsSinceSpotted() <= _intelligence;
+	}
+	return unit->getVisible();
+}
+
+/**
+ * Gets the TU cost for the unit to reach a position, looked up in the
+ * distance field the pathfinder keeps for the unit this turn.
+ * @param pos The position to reach.
+ * @param tuMax The most TUs the move may cost, -1 if nothing is reachable.
+ * @return The TU cost, or -1 if the position can't be reached within the budget.
+ */
+int AlienBAIState::getReachCost(const Position &pos, int tuMax) const
+{
+	return getReachCost(_save->getPathfinding()->getReachMap(_unit, _reachableTUs), _save->getTileIndex(pos), tuMax);
+}
+
+/**
+ * Gets the pool of worker threads that score candidate tiles.
+ * @return Pointer to the thread pool.
+ */
+ThreadPool *AlienBAIState::getThreadPool() const
+{
+	return _save->getBattleState()->getGame()->getThreadPool();
+}
+
+/**
+ * Gets how many candidate tiles the planning stages score at a time
+ * before looking for one that is good enough to stop early.
+ * Small enough not to waste much work on a single thread,
+ * big enough to keep every worker thread busy.
+ * @return Number of candidate tiles.
+ */
+int AlienBAIState::getPlanBatchSize() const
+{
+	return getThreadPool()->getThreadCount() * 4;
+}
+
+/**
+ * Scores a node as an ambush position: reachable by us with TUs to spare
+ * for an attack, unseen by the target, yet on a path the target could take.
+ * Runs on a worker thread, so it only reads the map and the plan.
+ * @param plan Pointer to the AmbushPlan.
+ * @param index Index of the candidate within the current batch.
+ */
+void AlienBAIState::scoreAmbushTile(void *plan, int index)
+{
+	const int BASE_SYSTEMATIC_SUCCESS = 100;
+	const int COVER_BONUS = 25;
+	AmbushPlan *ambush = (AmbushPlan*)plan;
+	const AlienBAIState *ai = ambush->ai;
+	SavedBattleGame *save = ai->_save;
+	PlanTile &candidate = ambush->tiles[ambush->first + index];
+	Position pos = candidate.pos;
+	Tile *tile = save->getTile(pos);
+	if (tile == 0 || save->getTileEngine()->distance(pos, ai->_unit->getPosition()) > 10 || pos.z != ai->_unit->getPosition().z || tile->getDangerous())
+		return;
+	int ambushTUs = getMoveCost(*ambush, save->getTileIndex(pos));
+	if (ambushTUs == -1)
+		return;
+	candidate.considered = true;
+
+	// make sure we can't be seen here.
+	Position origin = ambush->origin;
+	Position target;
+	if (!save->getTileEngine()->canTargetUnit(&origin, tile, &target, ai->_aggroTarget, ai->_unit) && !ai->getSpottingUnits(pos))
+	{
+		// make sure we can move here, and our enemy can reach here too.
+		if (ambushTUs > 0 && ambush->targetReach->getTUCost(save->getTileIndex(pos)) > 0)
+		{
+			candidate.usable = true;
+			candidate.tuCost = ambushTUs;
+			candidate.score = BASE_SYSTEMATIC_SUCCESS - ambushTUs;
+			// ideally we'd like to be behind some cover, like say a window or a low wall.
+			if (save->getTileEngine()->faceWindow(pos) != -1)
+			{
+				candidate.score += COVER_BONUS;
+			}
+		}
+	}
+}
+
+/**
+ * Picks and scores one of the tiles to run to: our last cover, a tile from
+ * the systematic search or, after that, a desperate random one.
+ * Runs on a worker thread, so it only reads the map and the plan, and
+ * draws its random numbers from its own stream.
+ * @param plan Pointer to the EscapePlan.
+ * @param index Index of the candidate within the current batch.
+ */
+void AlienBAIState::scoreEscapeTile(void *plan, int index)
+{
+	// weights of various factors in choosing a tile to which to withdraw
+	const int EXPOSURE_PENALTY = 10;
+	const int FIRE_PENALTY = 40;
+	const int BASE_SYSTEMATIC_SUCCESS = 100;
+	const int BASE_DESPERATE_SUCCESS = 110;
+	const int currentTilePreference = 15;
+	EscapePlan *escape = (EscapePlan*)plan;
+	const AlienBAIState *ai = escape->ai;
+	SavedBattleGame *save = ai->_save;
+	int tries = escape->first + index - 1;
+	PlanTile &candidate = escape->tiles[escape->first + index];
+	RNG::Stream rng = escape->rng.substream(escape->first + index);
+	Position &target = candidate.pos;
+	const Position &unitPos = ai->_unit->getPosition();
+	int score = 0;
+
+	if (tries == -1)
+	{
+		// you know, maybe we should just stay where we are and not risk reaction fire...
+		// or maybe continue to wherever we were running to and not risk looking stupid
+		if (save->getTile(ai->_unit->lastCover) != 0)
+		{
+			target = ai->_unit->lastCover;
+		}
+	}
+	else if (tries < 121)
+	{
+		// looking for cover
+		target.x += escape->randomTileSearch[tries].x;
+		target.y += escape->randomTileSearch[tries].y;
+		score = BASE_SYSTEMATIC_SUCCESS;
+		if (target == unitPos)
+		{
+			if (escape->unitsSpottingMe > 0)
+			{
+				// maybe don't stay in the same spot? move or something if there's any point to it?
+				target.x += rng.generate(-20, 20);
+				target.y += rng.generate(-20, 20);
+			}
+			else
+			{
+				score += currentTilePreference;
+			}
+		}
+	}
+	else
+	{
+		score = BASE_DESPERATE_SUCCESS; // ruuuuuuun
+		target.x += rng.generate(-10, 10);
+		target.y += rng.generate(-10, 10);
+		target.z = unitPos.z + rng.generate(-1, 1);
+		if (target.z < 0)
+		{
+			target.z = 0;
+		}
+		else if (target.z >= save->getMapSizeZ())
+		{
+			target.z = unitPos.z;
+		}
+	}
+
+	// THINK, DAMN YOU
+	Tile *tile = save->getTile(target);
+	int distanceFromTarget = ai->_aggroTarget ? save->getTileEngine()->distance(ai->_aggroTarget->getPosition(), target) : 0;
+	if (escape->dist >= distanceFromTarget)
+	{
+		score -= (distanceFromTarget - escape->dist) * 10;
+	}
+	else
+	{
+		score += (distanceFromTarget - escape->dist) * 10;
+	}
+	if (!tile)
+	{
+		score = -100001; // no you can't quit the battlefield by running off the map.
+	}
+	else
+	{
+		candidate.tuCost = getMoveCost(*escape, save->getTileIndex(target));
+		if (candidate.tuCost == -1)
+			return; // just ignore unreachable tiles
+		candidate.considered = true;
+		candidate.usable = true;
+
+		int spotters = ai->getSpottingUnits(target);
+		if (ai->_spottingEnemies || spotters)
+		{
+			if (ai->_spottingEnemies <= spotters)
+			{
+				score -= (1 + spotters - ai->_spottingEnemies) * EXPOSURE_PENALTY; // that's for giving away our position
+			}
+			else
+			{
+				score += (ai->_spottingEnemies - spotters) * EXPOSURE_PENALTY;
+			}
+		}
+		if (tile->getFire())
+		{
+			score -= FIRE_PENALTY;
+		}
+		if (tile->getDangerous())
+		{
+			score -= BASE_SYSTEMATIC_SUCCESS;
+		}
+	}
+	candidate.score = score;
+}
+
+/**
+ * Scores a tile as a position from which to fire at the target.
+ * Runs on a worker thread, so it only reads the map and the plan.
+ * @param plan Pointer to the FirePointPlan.
+ * @param index Index of the candidate within the current batch.
+ */
+void AlienBAIState::scoreFirePoint(void *plan, int index)
+{
+	const int BASE_SYSTEMATIC_SUCCESS = 100;
+	FirePointPlan *firePoint = (FirePointPlan*)plan;
+	const AlienBAIState *ai = firePoint->ai;
+	SavedBattleGame *save = ai->_save;
+	PlanTile &candidate = firePoint->tiles[firePoint->first + index];
+	Position pos = candidate.pos;
+	Tile *tile = save->getTile(pos);
+	if (tile == 0)
+		return;
+	int moveTUs = getMoveCost(*firePoint, save->getTileIndex(pos));
+	if (moveTUs == -1)
+		return;
+	candidate.considered = true;
+	// i should really make a function for this
+	Position origin = (pos * Position(16,16,24)) +
+		// 4 because -2 is eyes and 2 below that is the rifle (or at least that's my understanding)
+		Position(8,8, ai->_unit->getHeight() + ai->_unit->getFloatHeight() - tile->getTerrainLevel() - 4);
+	Position target;
+
+	// can move here
+	if (save->getTileEngine()->canTargetUnit(&origin, ai->_aggroTarget->getTile(), &target, ai->_unit) && moveTUs > 0)
+	{
+		candidate.usable = true;
+		candidate.tuCost = moveTUs;
+		candidate.score = BASE_SYSTEMATIC_SUCCESS - ai->getSpottingUnits(pos) * 10;
+		candidate.score += ai->_unit->getTimeUnits() - moveTUs;
+		if (!ai->_aggroTarget->checkViewSector(pos))
+		{
+			candidate.score += 10;
+		}
+	}
+}
+
+/**
+ * Gets the TU cost to reach a tile from a reach map, within a TU budget.
+ * @param reach The reach map of the unit.
+ * @param index Tile index of the position.
+ * @param tuMax The most TUs the move may cost, -1 if nothing is reachable.
+ * @return The TU cost, or -1 if the tile can't be reached within the budget.
+ */
+int AlienBAIState::getReachCost(const ReachMap &reach, int index, int tuMax)
+{
+	if (tuMax < 0)
+	{
+		return -1;
+	}
+	int cost = reach.getTUCost(index);
+	return cost <= tuMax ? cost : -1;
+}
+
+/**
+ * Gets the reach map used to cost the unit's moves. Sneaky aliens
+ * pay double for tiles the enemy can see, like their paths do, so
+ * they get a map searched that way; everyone else uses the plain one.
+ * @return Pointer to the reach map.
+ */
+const ReachMap *AlienBAIState::getMoveReach() const
+{
+	if (Options::sneakyAI && _unit->getFaction() == FACTION_HOSTILE)
+	{
+		return &_save->getPathfinding()->getReachMap(_unit, 1000, false, true);
+	}
+	return &_save->getPathfinding()->getReachMap(_unit, _reachableTUs);
+}
+
+/**
+ * Gets the TU cost of moving to a tile for a planning stage. Whether
+ * the tile is within the budget is decided by the plain reach map,
+ * the cost itself comes from the map the unit's moves are costed with.
+ * @param plan The planning stage.
+ * @param index Tile index of the position.
+ * @return The TU cost, or -1 if the tile can't be reached within the budget.
+ */
+int AlienBAIState::getMoveCost(const Plan &plan, int index)
+{
+	int cost = getReachCost(*plan.reach, index, plan.tuMax);
+	if (cost == -1 || plan.moveReach == plan.reach)
+	{
+		return cost;
+	}
+	return plan.moveReach->getTUCost(index);
 }
+
 }
@@ -21,6 +21,7 @@
 
 #include "BattleAIState.h"
 #include "Position.h"
+#include "../Engine/RNG.h"
 #include <vector>
 
 namespace OpenXcom
@@ -30,6 +31,8 @@ class SavedBattleGame;
 class BattleUnit;
 class BattlescapeState;
 class Node;
+class ThreadPool;
+struct ReachMap;
 
 /**
  * This class is used by the BattleUnit AI.
@@ -45,7 +48,53 @@ protected:
 	bool _traceAI, _wasHit, _didPsi;
 	int _AIMode, _intelligence, _closestDist;
 	Node *_fromNode, *_toNode;
-	std::vector<int> _reachable, _reachableWithAttack;
+	int _reachableTUs, _reachableWithAttackTUs;
+	/// A candidate tile scored by one of the planning stages.
+	struct PlanTile
+	{
+		Position pos;
+		bool considered, usable;
+		int score, tuCost;
+		PlanTile(const Position &p) : pos(p), considered(false), usable(false), score(0), tuCost(-1) {}
+	};
+	/// Read-only input and results of a planning stage, shared by the worker threads.
+	struct Plan
+	{
+		const AlienBAIState *ai;
+		const ReachMap *reach, *moveReach;
+		int tuMax, first;
+		std::vector<PlanTile> tiles;
+	};
+	struct AmbushPlan : Plan
+	{
+		Position origin;
+		const ReachMap *targetReach;
+	};
+	struct EscapePlan : Plan
+	{
+		int unitsSpottingMe, dist;
+		RNG::Stream rng;
+		std::vector<Position> randomTileSearch;
+	};
+	typedef Plan FirePointPlan;
+	/// Gets the TU cost for the unit to reach a position within a TU budget.
+	int getReachCost(const Position &pos, int tuMax) const;
+	/// Gets the TU cost to reach a tile from a reach map within a TU budget.
+	static int getReachCost(const ReachMap &reach, int index, int tuMax);
+	/// Gets the reach map the unit's moves are costed with.
+	const ReachMap *getMoveReach() const;
+	/// Gets the TU cost of moving to a tile reachable within a plan's budget.
+	static int getMoveCost(const Plan &plan, int index);
+	/// Gets the worker threads that score candidate tiles.
+	ThreadPool *getThreadPool() const;
+	/// Gets how many candidate tiles to score between checks for a good enough one.
+	int getPlanBatchSize() const;
+	/// Scores an ambush position.
+	static void scoreAmbushTile(void *plan, int index);
+	/// Scores an escape position.
+	static void scoreEscapeTile(void *plan, int index);
+	/// Scores a firing position.
+	static void scoreFirePoint(void *plan, int index);
 public:
 	/// Creates a new AlienBAIState linked to the game and a certain unit.
 	AlienBAIState(SavedBattleGame *save, BattleUnit *unit, Node *node);
@@ -106,6 +155,10 @@ public:
 	/// Performs a melee attack action.
 	void meleeAttack();
 	bool validTarget(BattleUnit* unit, bool assessDanger, bool includeCivs) const;
+	/// Checks if a unit belongs to the side this unit is fighting.
+	bool isEnemy(BattleUnit *unit) const;
+	/// Checks if this unit knows about another unit.
+	bool isKnown(BattleUnit *unit) const;
 };
 
 }
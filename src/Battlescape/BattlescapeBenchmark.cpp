@@ -0,0 +1,447 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattlescapeBenchmark.h"
+#include <sstream>
+#include <iomanip>
+#include "../Engine/Game.h"
+#include "../Engine/Options.h"
+#include "../Engine/Screen.h"
+#include "../Engine/RNG.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Exception.h"
+#include "../Engine/ThreadPool.h"
+#include "../Ruleset/Ruleset.h"
+#include "../Ruleset/RuleCraft.h"
+#include "../Ruleset/RuleItem.h"
+#include "../Ruleset/RuleTerrain.h"
+#include "../Savegame/SavedGame.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/Base.h"
+#include "../Savegame/Craft.h"
+#include "../Savegame/ItemContainer.h"
+#include "../Savegame/Soldier.h"
+#include "../Savegame/Ufo.h"
+#include "../Savegame/TerrorSite.h"
+#include "../Savegame/AlienBase.h"
+#include "BattlescapeGenerator.h"
+#include "BattlescapeState.h"
+#include "BattlescapeGame.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates a benchmark. Anything not set is picked from
+ * the first matching entry in the ruleset when run.
+ * @param game Pointer to the core game, with the ruleset and resources loaded.
+ */
+BattlescapeBenchmark::BattlescapeBenchmark(Game *game) : _game(game), _craft(0), _state(0), _result(""), _seed(0), _turns(10), _difficulty(0), _darkness(0), _turnsPlayed(0), _liveAliens(0), _liveSoldiers(0), _setupTime(0), _runTime(0)
+{
+}
+
+/**
+ *
+ */
+BattlescapeBenchmark::~BattlescapeBenchmark()
+{
+}
+
+/**
+ * Sets the mission to play, either a UFO type or
+ * one of the other alien deployments.
+ * @param mission Deployment ID.
+ */
+void BattlescapeBenchmark::setMission(const std::string &mission)
+{
+	_mission = mission;
+}
+
+/**
+ * Sets the terrain to play UFO missions on.
+ * @param terrain Terrain ID.
+ */
+void BattlescapeBenchmark::setTerrain(const std::string &terrain)
+{
+	_terrain = terrain;
+}
+
+/**
+ * Sets the alien race to fight.
+ * @param race Alien race ID.
+ */
+void BattlescapeBenchmark::setAlienRace(const std::string &race)
+{
+	_race = race;
+}
+
+/**
+ * Sets the craft bringing in the soldiers.
+ * @param craft Craft ID.
+ */
+void BattlescapeBenchmark::setCraft(const std::string &craft)
+{
+	_craftType = craft;
+}
+
+/**
+ * Sets the seed everything random in the benchmark
+ * is drawn from, so runs can be repeated exactly.
+ * @param seed Random seed.
+ */
+void BattlescapeBenchmark::setSeed(uint64_t seed)
+{
+	_seed = seed;
+}
+
+/**
+ * Sets the number of full turns (every side moving once) to play.
+ * The benchmark stops earlier if either side is wiped out.
+ * @param turns Number of turns.
+ */
+void BattlescapeBenchmark::setTurns(int turns)
+{
+	_turns = turns;
+}
+
+/**
+ * Sets the game difficulty.
+ * @param difficulty Difficulty level, 0-4.
+ */
+void BattlescapeBenchmark::setDifficulty(int difficulty)
+{
+	_difficulty = difficulty;
+}
+
+/**
+ * Sets the battlescape darkness.
+ * @param darkness Darkness level, 0-15.
+ */
+void BattlescapeBenchmark::setDarkness(int darkness)
+{
+	_darkness = darkness;
+}
+
+/**
+ * Generates the battle and plays it, timing the
+ * setup and each phase of the engine separately.
+ */
+void BattlescapeBenchmark::run()
+{
+	Ruleset *rule = _game->getRuleset();
+	if (_mission.empty() && !rule->getUfosList().empty())
+	{
+		_mission = rule->getUfosList().front();
+	}
+	if (rule->getDeployment(_mission) == 0)
+	{
+		throw Exception("Unknown mission: " + _mission);
+	}
+	if (_terrain.empty())
+	{
+		for (std::vector<std::string>::const_iterator i = rule->getTerrainList().begin(); i != rule->getTerrainList().end() && _terrain.empty(); ++i)
+		{
+			if (!rule->getTerrain(*i)->getTextures()->empty())
+			{
+				_terrain = *i;
+			}
+		}
+	}
+	if (rule->getTerrain(_terrain) == 0 || rule->getTerrain(_terrain)->getTextures()->empty())
+	{
+		throw Exception("Unknown terrain: " + _terrain);
+	}
+	if (_race.empty() && !rule->getAlienRacesList().empty())
+	{
+		_race = rule->getAlienRacesList().front();
+	}
+	if (rule->getAlienRace(_race) == 0)
+	{
+		throw Exception("Unknown alien race: " + _race);
+	}
+	if (_craftType.empty())
+	{
+		for (std::vector<std::string>::const_iterator i = rule->getCraftsList().begin(); i != rule->getCraftsList().end() && _craftType.empty(); ++i)
+		{
+			if (rule->getCraft(*i)->getSoldiers() > 0)
+			{
+				_craftType = *i;
+			}
+		}
+	}
+	if (rule->getCraft(_craftType) == 0 || rule->getCraft(_craftType)->getSoldiers() == 0)
+	{
+		throw Exception("Unknown craft: " + _craftType);
+	}
+
+	RNG::Stream rng(_seed);
+	RNG::StreamScope scope(&rng);
+
+	Uint64 start = CrossPlatform::getPreciseTicks();
+	initSave();
+	generateBattle();
+	_setupTime = CrossPlatform::getPreciseTicks() - start;
+
+	Profiler::reset();
+	Profiler::setEnabled(true);
+	start = CrossPlatform::getPreciseTicks();
+	playBattle();
+	_runTime = CrossPlatform::getPreciseTicks() - start;
+	Profiler::setEnabled(false);
+}
+
+/**
+ * Creates a saved game with a base holding a full craft
+ * of soldiers and every item, with all research done,
+ * same as the New Battle screen does.
+ */
+void BattlescapeBenchmark::initSave()
+{
+	Ruleset *rule = _game->getRuleset();
+	SavedGame *save = new SavedGame();
+	Base *base = new Base(rule);
+	base->load(rule->getStartingBase(), save, true, true);
+	save->getBases()->push_back(base);
+
+	for (std::vector<Soldier*>::iterator i = base->getSoldiers()->begin(); i != base->getSoldiers()->end(); ++i) delete (*i);
+	base->getSoldiers()->clear();
+	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
+	base->getCrafts()->clear();
+	base->getItems()->clear();
+
+	_craft = new Craft(rule->getCraft(_craftType), base, 1);
+	base->getCrafts()->push_back(_craft);
+
+	for (int i = 0; i < _craft->getRules()->getSoldiers(); ++i)
+	{
+		Soldier *soldier = rule->genSoldier(save);
+		soldier->setCraft(_craft);
+		base->getSoldiers()->push_back(soldier);
+	}
+
+	const std::vector<std::string> &items = rule->getItemsList();
+	for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
+	{
+		RuleItem *item = rule->getItem(*i);
+		if (item->getBattleType() != BT_CORPSE && item->isRecoverable())
+		{
+			base->getItems()->addItem(*i, 1);
+			if (item->getBattleType() != BT_NONE && !item->isFixed() && item->getBigSprite() > -1)
+			{
+				_craft->getItems()->addItem(*i, 1);
+			}
+		}
+	}
+
+	const std::vector<std::string> &research = rule->getResearchList();
+	for (std::vector<std::string>::const_iterator i = research.begin(); i != research.end(); ++i)
+	{
+		save->addFinishedResearch(rule->getResearch(*i));
+	}
+
+	save->setDifficulty((GameDifficulty)_difficulty);
+	_game->setSavedGame(save);
+}
+
+/**
+ * Generates the battle the same way the New Battle screen
+ * does, and sets up the battlescape with the AI playing X-Com.
+ */
+void BattlescapeBenchmark::generateBattle()
+{
+	Ruleset *rule = _game->getRuleset();
+	SavedGame *save = _game->getSavedGame();
+	SavedBattleGame *bgame = new SavedBattleGame();
+	save->setBattleGame(bgame);
+	bgame->setMissionType(_mission);
+	BattlescapeGenerator bgen = BattlescapeGenerator(_game);
+
+	bgen.setWorldTexture(rule->getTerrain(_terrain)->getTextures()->at(0));
+
+	if (_mission == "STR_TERROR_MISSION")
+	{
+		TerrorSite *t = new TerrorSite();
+		t->setId(1);
+		_craft->setDestination(t);
+		bgen.setTerrorSite(t);
+		bgen.setCraft(_craft);
+		save->getTerrorSites()->push_back(t);
+	}
+	else if (_mission == "STR_BASE_DEFENSE")
+	{
+		bgen.setBase(_craft->getBase());
+	}
+	else if (_mission == "STR_ALIEN_BASE_ASSAULT")
+	{
+		AlienBase *b = new AlienBase();
+		b->setId(1);
+		_craft->setDestination(b);
+		bgen.setAlienBase(b);
+		bgen.setCraft(_craft);
+		save->getAlienBases()->push_back(b);
+	}
+	else if (rule->getUfo(_mission) != 0)
+	{
+		Ufo *u = new Ufo(rule->getUfo(_mission));
+		u->setId(1);
+		_craft->setDestination(u);
+		bgen.setUfo(u);
+		bgen.setCraft(_craft);
+		if (_terrain == "FOREST")
+		{
+			u->setLatitude(-0.5);
+		}
+		// either ground assault or ufo crash
+		if (RNG::generate(0,1) == 1)
+			bgame->setMissionType("STR_UFO_GROUND_ASSAULT");
+		else
+			bgame->setMissionType("STR_UFO_CRASH_RECOVERY");
+		save->getUfos()->push_back(u);
+	}
+	else
+	{
+		bgen.setCraft(_craft);
+	}
+	_craft->setSpeed(0);
+
+	bgen.setWorldShade(_darkness);
+	bgen.setAlienRace(_race);
+	bgen.setAlienItemlevel(0);
+	bgen.run();
+
+	Options::baseXResolution = Options::baseXBattlescape;
+	Options::baseYResolution = Options::baseYBattlescape;
+	_game->getScreen()->resetDisplay(false);
+	_state = new BattlescapeState;
+	_game->pushState(_state);
+	bgame->setBattleState(_state);
+	_state->init();
+	_state->getBattleGame()->setAutoPlay(true);
+}
+
+/**
+ * Steps the battle engine the way the battlescape's timers
+ * would, until enough turns have passed or the battle is over.
+ */
+void BattlescapeBenchmark::playBattle()
+{
+	SavedBattleGame *save = _game->getSavedGame()->getSavedBattle();
+	BattlescapeGame *battle = _state->getBattleGame();
+	int turn = save->getTurn();
+	int steps = 0;
+	_turnsPlayed = 0;
+	_result = "turnLimit";
+	battle->tallyUnits(_liveAliens, _liveSoldiers, false);
+	while (_turnsPlayed < _turns && _liveAliens > 0 && _liveSoldiers > 0)
+	{
+		battle->think();
+		battle->handleState();
+		if (save->getTurn() != turn)
+		{
+			turn = save->getTurn();
+			_turnsPlayed++;
+			steps = 0;
+			battle->cleanupDeleted();
+		}
+		battle->tallyUnits(_liveAliens, _liveSoldiers, false);
+		if (save->isObjectiveDestroyed())
+		{
+			_result = "objectiveDestroyed";
+			return;
+		}
+		if (++steps > MAX_STEPS_PER_TURN)
+		{
+			_result = "stalled";
+			return;
+		}
+	}
+	if (_liveAliens == 0)
+	{
+		_result = "aliensDefeated";
+	}
+	else if (_liveSoldiers == 0)
+	{
+		_result = "xcomDefeated";
+	}
+}
+
+/**
+ * Writes a string as a quoted JSON literal.
+ * @param out Output stream.
+ * @param s String to write.
+ */
+void BattlescapeBenchmark::writeString(std::ostream &out, const std::string &s)
+{
+	out << '"';
+	for (std::string::const_iterator i = s.begin(); i != s.end(); ++i)
+	{
+		if (*i == '"' || *i == '\\')
+		{
+			out << '\\' << *i;
+		}
+		else if ((unsigned char)*i < 0x20)
+		{
+			out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)*i << std::dec << std::setfill(' ');
+		}
+		else
+		{
+			out << *i;
+		}
+	}
+	out << '"';
+}
+
+/**
+ * Writes the benchmark settings and results as a JSON object.
+ * Times are in milliseconds. Phase times are inclusive,
+ * eg. reaction fire also counts the FOV checks it makes.
+ * @param out Output stream.
+ */
+void BattlescapeBenchmark::save(std::ostream &out) const
+{
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3);
+	json << "{\n";
+	json << "\t\"mission\": "; writeString(json, _mission); json << ",\n";
+	json << "\t\"terrain\": "; writeString(json, _terrain); json << ",\n";
+	json << "\t\"alienRace\": "; writeString(json, _race); json << ",\n";
+	json << "\t\"craft\": "; writeString(json, _craftType); json << ",\n";
+	json << "\t\"seed\": " << _seed << ",\n";
+	json << "\t\"difficulty\": " << _difficulty << ",\n";
+	json << "\t\"threads\": " << _game->getThreadPool()->getThreadCount() << ",\n";
+	json << "\t\"turnsRequested\": " << _turns << ",\n";
+	json << "\t\"turnsPlayed\": " << _turnsPlayed << ",\n";
+	json << "\t\"result\": "; writeString(json, _result); json << ",\n";
+	json << "\t\"liveAliens\": " << _liveAliens << ",\n";
+	json << "\t\"liveSoldiers\": " << _liveSoldiers << ",\n";
+	json << "\t\"setupMs\": " << _setupTime / 1000.0 << ",\n";
+	json << "\t\"totalMs\": " << _runTime / 1000.0 << ",\n";
+	json << "\t\"phases\": {\n";
+	for (int i = 0; i < Profiler::PHASE_COUNT; ++i)
+	{
+		Profiler::Phase phase = (Profiler::Phase)i;
+		json << "\t\t\"" << Profiler::getName(phase) << "\": { \"ms\": " << Profiler::getTime(phase) / 1000.0 << ", \"calls\": " << Profiler::getCalls(phase) << " }";
+		json << (i + 1 < Profiler::PHASE_COUNT ? ",\n" : "\n");
+	}
+	json << "\t}\n";
+	json << "}\n";
+	out << json.str();
+}
+
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_BATTLESCAPEBENCHMARK_H
+#define OPENXCOM_BATTLESCAPEBENCHMARK_H
+
+#include <string>
+#include <ostream>
+#include <stdint.h>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+class Game;
+class Craft;
+class BattlescapeState;
+
+/**
+ * Plays a generated battle with the AI controlling every side,
+ * without any player input or rendering, and reports how long
+ * the battlescape engine spends in each of its expensive phases.
+ * Used by the openxcom-bench tool to catch performance regressions.
+ */
+class BattlescapeBenchmark
+{
+private:
+	static const int MAX_STEPS_PER_TURN = 100000;
+	Game *_game;
+	Craft *_craft;
+	BattlescapeState *_state;
+	std::string _mission, _terrain, _race, _craftType, _result;
+	uint64_t _seed;
+	int _turns, _difficulty, _darkness, _turnsPlayed, _liveAliens, _liveSoldiers;
+	Uint64 _setupTime, _runTime;
+
+	/// Creates the saved game the battle is played from.
+	void initSave();
+	/// Generates the battle.
+	void generateBattle();
+	/// Plays the battle.
+	void playBattle();
+	/// Writes a string as a JSON literal.
+	static void writeString(std::ostream &out, const std::string &s);
+public:
+	/// Creates a benchmark with default settings.
+	BattlescapeBenchmark(Game *game);
+	/// Cleans up the benchmark.
+	~BattlescapeBenchmark();
+	/// Sets the mission to play.
+	void setMission(const std::string &mission);
+	/// Sets the terrain to play on.
+	void setTerrain(const std::string &terrain);
+	/// Sets the alien race to fight.
+	void setAlienRace(const std::string &race);
+	/// Sets the craft bringing in the soldiers.
+	void setCraft(const std::string &craft);
+	/// Sets the seed the battle is generated from.
+	void setSeed(uint64_t seed);
+	/// Sets the number of turns to play.
+	void setTurns(int turns);
+	/// Sets the game difficulty.
+	void setDifficulty(int difficulty);
+	/// Sets the battlescape darkness.
+	void setDarkness(int darkness);
+	/// Runs the benchmark.
+	void run();
+	/// Writes the results as JSON.
+	void save(std::ostream &out) const;
+};
+
+}
+
+#endif
@@ -69,7 +69,7 @@ bool BattlescapeGame::_debugPlay = false;
  * @param save Pointer to the save game.
  * @param parentState Pointer to the parent battlescape state.
  */
-BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false)
+BattlescapeGame::BattlescapeGame(SavedBattleGame *save, BattlescapeState *parentState) : _save(save), _parentState(parentState), _playedAggroSound(false), _endTurnRequested(false), _kneelReserved(false), _autoPlay(false)
 {
 	_tuReserved = BA_NONE;
 	_playerTUReserved = BA_NONE;
@@ -106,8 +106,8 @@ void BattlescapeGame::think()
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
 	{
-		// it's a non player side (ALIENS or CIVILIANS)
-		if (_save->getSide() != FACTION_PLAYER)
+		// it's a non player side (ALIENS or CIVILIANS), or the AI is playing for X-Com
+		if (_save->getSide() != FACTION_PLAYER || _autoPlay)
 		{
 			if (!_debugPlay)
 			{
@@ -215,7 +215,7 @@ void BattlescapeGame::handleAI(BattleUnit *unit)
 	if (!ai)
 	{
 		// for some reason the unit had no AI routine assigned..
-		if (unit->getFaction() == FACTION_HOSTILE)
+		if (unit->getFaction() != FACTION_NEUTRAL)
 			unit->setAIState(new AlienBAIState(_save, unit, 0));
 		else
 			unit->setAIState(new CivilianBAIState(_save, unit, 0));
@@ -797,7 +797,7 @@ void BattlescapeGame::popState()
 
 	BattleAction action = _states.front()->getAction();
 
-	if (action.actor && action.result.length() > 0 && action.actor->getFaction() == FACTION_PLAYER
+	if (action.actor && action.result.length() > 0 && action.actor->getFaction() == FACTION_PLAYER && !_autoPlay
     && _playerPanicHandled && (_save->getSide() == FACTION_PLAYER || _debugPlay))
 	{
 		_parentState->warning(action.result);
@@ -809,7 +809,7 @@ void BattlescapeGame::popState()
 	// handle the end of this unit's actions
 	if (action.actor && noActionsPending(action.actor))
 	{
-		if (action.actor->getFaction() == FACTION_PLAYER)
+		if (action.actor->getFaction() == FACTION_PLAYER && !_autoPlay)
 		{
 			// spend TUs of "target triggered actions" (shooting, throwing) only
 			// the other actions' TUs (healing,scanning,..) are already take care of
@@ -838,7 +838,7 @@ void BattlescapeGame::popState()
 		{
 			// spend TUs
 			action.actor->spendTimeUnits(action.TU);
-			if (_save->getSide() != FACTION_PLAYER && !_debugPlay)
+			if ((_save->getSide() != FACTION_PLAYER || _autoPlay) && !_debugPlay)
 			{
 				 // AI does three things per unit, before switching to the next, or it got killed before doing the second thing
 				if (_AIActionCounter > 2 || _save->getSelectedUnit() == 0 || _save->getSelectedUnit()->isOut())
@@ -1457,6 +1457,16 @@ void BattlescapeGame::setTUReserved(BattleActionType tur, bool player)
 	}
 }
 
+/**
+ * Sets whether the AI also plays the player's side, moving
+ * X-Com units on their own. Used by the headless benchmark.
+ * @param autoPlay Let the AI play X-Com?
+ */
+void BattlescapeGame::setAutoPlay(bool autoPlay)
+{
+	_autoPlay = autoPlay;
+}
+
 /**
  * Drops an item to the floor and affects it with gravity.
  * @param position Position to spawn the item.
@@ -1506,7 +1516,7 @@ void BattlescapeGame::dropItem(const Position &position, BattleItem *item, bool
 	if (item->getRules()->getBattleType() == BT_FLARE)
 	{
 		getTileEngine()->calculateTerrainLighting();
-		getTileEngine()->calculateFOV(position);
+		getTileEngine()->calculateFOV(position, item->getRules()->getPower());
 	}
 
 }
@@ -1558,6 +1568,7 @@ BattleUnit *BattlescapeGame::convertUnit(BattleUnit *unit, std::string newType)
 
 	getSave()->getTile(unit->getPosition())->setUnit(newUnit, _save->getTile(unit->getPosition() + Position(0,0,-1)));
 	newUnit->setPosition(unit->getPosition());
+	getPathfinding()->invalidateReachMaps();
 	newUnit->setDirection(3);
 	newUnit->setCache(0);
 	newUnit->setTimeUnits(0);
@@ -1675,11 +1686,12 @@ void BattlescapeGame::findItem(BattleAction *action)
 BattleItem *BattlescapeGame::surveyItems(BattleAction *action)
 {
 	std::vector<BattleItem*> droppedItems;
+	RuleInventory *ground = getRuleset()->getInventory("STR_GROUND");
 
 	// first fill a vector with items on the ground that were dropped on the alien turn, and have an attraction value.
 	for (std::vector<BattleItem*>::iterator i = _save->getItems()->begin(); i != _save->getItems()->end(); ++i)
 	{
-		if ((*i)->getSlot() && (*i)->getSlot()->getId() == "STR_GROUND" && (*i)->getTile() && (*i)->getTurnFlag() && (*i)->getRules()->getAttraction())
+		if ((*i)->getSlot() == ground && (*i)->getTile() && (*i)->getTurnFlag() && (*i)->getRules()->getAttraction())
 		{
 			droppedItems.push_back(*i);
 		}
@@ -17,7 +17,6 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <assert.h>
-#include <fstream>
 #include <sstream>
 #include "BattlescapeGenerator.h"
 #include "TileEngine.h"
@@ -54,6 +53,7 @@
 #include "../Engine/Game.h"
 #include "../Engine/Language.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/FileMap.h"
 #include "../Engine/Options.h"
 #include "../Savegame/Vehicle.h"
 #include "../Savegame/TerrorSite.h"
@@ -173,6 +173,10 @@ void BattlescapeGenerator::setTerrorSite(TerrorSite *terror)
  */
 void BattlescapeGenerator::nextStage()
 {
+	// generate the map from a stream of its own, so the battle's stream only moves on by one draw
+	RNG::Stream rng = RNG::split();
+	RNG::StreamScope scope(&rng);
+
 	// kill all enemy units, or those not in endpoint area (if aborted)
 	for (std::vector<BattleUnit*>::iterator j = _save->getUnits()->begin(); j != _save->getUnits()->end(); ++j)
 	{
@@ -281,6 +285,10 @@ void BattlescapeGenerator::nextStage()
  */
 void BattlescapeGenerator::run()
 {
+	// generate the map from a stream of its own, so the battle's stream only moves on by one draw
+	RNG::Stream rng = RNG::split();
+	RNG::StreamScope scope(&rng);
+
 	AlienDeployment *ruleDeploy = _game->getRuleset()->getDeployment(_ufo?_ufo->getRules()->getType():_save->getMissionType());
 
 	ruleDeploy->getDimensions(&_mapsize_x, &_mapsize_y, &_mapsize_z);
@@ -425,34 +433,32 @@ void BattlescapeGenerator::deployXCOM()
 	if (_craft != 0)
 	{
 		// add items that are in the craft
-		for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+		const std::vector<int> &items = _craft->getItems()->getContents();
+		for (size_t i = 0; i < items.size(); ++i)
 		{
-			for (int count = 0; count < i->second; count++)
+			for (int count = 0; count < items[i]; count++)
 			{
-				_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()),	ground);
+				_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i), _save->getCurrentItemId()),	ground);
 			}
 		}
 	}
 	else
 	{
 		// add items that are in the base
-		for (std::map<std::string, int>::iterator i = _base->getItems()->getContents()->begin(); i != _base->getItems()->getContents()->end();)
+		const std::vector<int> &items = _base->getItems()->getContents();
+		for (size_t i = 0; i < items.size(); ++i)
 		{
+			if (items[i] == 0)
+				continue;
 			// only put items in the battlescape that make sense (when the item got a sprite, it's probably ok)
-			RuleItem *rule = _game->getRuleset()->getItem(i->first);
+			RuleItem *rule = _game->getRuleset()->getItem(i);
 			if (rule->getBigSprite() > -1 && rule->getBattleType() != BT_NONE && rule->getBattleType() != BT_CORPSE && !rule->isFixed() && _game->getSavedGame()->isResearched(rule->getRequirements()))
 			{
-				for (int count = 0; count < i->second; count++)
+				for (int count = 0; count < items[i]; count++)
 				{
-					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()), ground);
+					_craftInventoryTile->addItem(new BattleItem(rule, _save->getCurrentItemId()), ground);
 				}
-				std::map<std::string, int>::iterator tmp = i;
-				++i;
-				_base->getItems()->removeItem(tmp->first, tmp->second);
-			}
-			else
-			{
-				++i;
+				_base->getItems()->removeItem(i, items[i]);
 			}
 		}
 		// add items from crafts in base
@@ -460,11 +466,12 @@ void BattlescapeGenerator::deployXCOM()
 		{
 			if ((*c)->getStatus() == "STR_OUT")
 				continue;
-			for (std::map<std::string, int>::iterator i = (*c)->getItems()->getContents()->begin(); i != (*c)->getItems()->getContents()->end(); ++i)
+			const std::vector<int> &craftItems = (*c)->getItems()->getContents();
+			for (size_t i = 0; i < craftItems.size(); ++i)
 			{
-				for (int count = 0; count < i->second; count++)
+				for (int count = 0; count < craftItems[i]; count++)
 				{
-					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i->first), _save->getCurrentItemId()), ground);
+					_craftInventoryTile->addItem(new BattleItem(_game->getRuleset()->getItem(i), _save->getCurrentItemId()), ground);
 				}
 			}
 		}
@@ -1008,10 +1015,7 @@ bool BattlescapeGenerator::addItem(BattleItem *item, BattleUnit *unit, bool allo
 	case BT_AMMO:
 		// no weapon, or our weapon takes no ammo, or this ammo isn't compatible.
 		// we won't be needing this. move on.
-		if (!weapon || weapon->getRules()->getCompatibleAmmo()->empty() ||
-			std::find(weapon->getRules()->getCompatibleAmmo()->begin(),
-			weapon->getRules()->getCompatibleAmmo()->end(),
-			item->getRules()->getType()) == weapon->getRules()->getCompatibleAmmo()->end())
+		if (!weapon || !weapon->getRules()->isCompatibleAmmo(item->getRules()))
 		{
 			break;
 		}
@@ -1616,20 +1620,22 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 {
 	int sizex, sizey, sizez;
 	int x = xoff, y = yoff, z = 0;
-	char size[3];
-	unsigned char value[4];
 	std::ostringstream filename;
 	filename << "MAPS/" << mapblock->getName() << ".MAP";
 	unsigned int terrainObjectID;
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
+	FileMap mapFile(CrossPlatform::getDataFile(filename.str()));
 	if (!mapFile)
 	{
 		throw Exception(filename.str() + " not found");
 	}
+	if (mapFile.getSize() < 3)
+	{
+		throw Exception("Invalid MAP file");
+	}
 
-	mapFile.read((char*)&size, sizeof(size));
+	const char *size = (const char*)mapFile.getData();
 	sizey = (int)size[0];
 	sizex = (int)size[1];
 	sizez = (int)size[2];
@@ -1662,7 +1668,9 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		throw Exception("Something is wrong in your map definitions");
 	}
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	// Records of four tile parts follow the header, any partial record at the end is ignored
+	const Uint8 *end = mapFile.getData() + 3 + (mapFile.getSize() - 3) / 4 * 4;
+	for (const Uint8 *value = mapFile.getData() + 3; value != end; value += 4)
 	{
 		for (int part = 0; part < 4; part++)
 		{
@@ -1704,13 +1712,6 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 		}
 	}
 
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MAP file");
-	}
-
-	mapFile.close();
-	
 	if (_generateFuel)
 	{
 		// if one of the mapBlocks has an items array defined, don't deploy fuel algorithmically
@@ -1740,21 +1741,24 @@ int BattlescapeGenerator::loadMAP(MapBlock *mapblock, int xoff, int yoff, RuleTe
 void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int segment)
 {
 	int id = 0;
-	char value[24];
+	const int recordSize = 24;
 	std::ostringstream filename;
 	filename << "ROUTES/" << mapblock->getName() << ".RMP";
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(filename.str()).c_str(), std::ios::in| std::ios::binary);
+	FileMap mapFile(CrossPlatform::getDataFile(filename.str()));
 	if (!mapFile)
 	{
 		throw Exception(filename.str() + " not found");
 	}
 
 	size_t nodeOffset = _save->getNodes()->size();
+	size_t records = mapFile.getSize() / recordSize;
+	_save->getNodes()->reserve(nodeOffset + records);
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t i = 0; i < records; ++i)
 	{
+		const char *value = (const char*)mapFile.getData() + i * recordSize;
 		if( (int)value[0] < mapblock->getSizeY() && (int)value[1] < mapblock->getSizeX() && (int)value[2] < _mapsize_z )
 		{
 			Node *node = new Node(nodeOffset + id, Position(xoff + (int)value[1], yoff + (int)value[0], mapblock->getSizeZ() - 1 - (int)value[2]), segment, (int)value[19], (int)value[20], (int)value[21], (int)value[22], (int)value[23]);
@@ -1771,13 +1775,6 @@ void BattlescapeGenerator::loadRMP(MapBlock *mapblock, int xoff, int yoff, int s
 		}
 		id++;
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid RMP file");
-	}
-
-	mapFile.close();
 }
 
 /**
@@ -1949,6 +1946,8 @@ void BattlescapeGenerator::runInventory(Craft *craft)
  */
 void BattlescapeGenerator::loadWeapons()
 {
+	RuleInventory *ground = _game->getRuleset()->getInventory("STR_GROUND");
+	RuleInventory *rightHand = _game->getRuleset()->getInventory("STR_RIGHT_HAND");
 	// let's try to load this weapon, whether we equip it or not.
 	for (std::vector<BattleItem*>::iterator i = _craftInventoryTile->getInventory()->begin(); i != _craftInventoryTile->getInventory()->end(); ++i)
 	{
@@ -1960,11 +1959,11 @@ void BattlescapeGenerator::loadWeapons()
 			bool loaded = false;
 			for (std::vector<BattleItem*>::iterator j = _craftInventoryTile->getInventory()->begin(); j != _craftInventoryTile->getInventory()->end() && !loaded; ++j)
 			{
-				if ((*j)->getSlot() == _game->getRuleset()->getInventory("STR_GROUND") && (*i)->setAmmoItem((*j)) == 0)
+				if ((*j)->getSlot() == ground && (*i)->setAmmoItem((*j)) == 0)
 				{
 					_save->getItems()->push_back(*j);
 					(*j)->setXCOMProperty(true);
-					(*j)->setSlot(_game->getRuleset()->getInventory("STR_RIGHT_HAND"));
+					(*j)->setSlot(rightHand);
 					loaded = true;
 				}
 			}
@@ -1972,7 +1971,7 @@ void BattlescapeGenerator::loadWeapons()
 	}
 	for (std::vector<BattleItem*>::iterator i = _craftInventoryTile->getInventory()->begin(); i != _craftInventoryTile->getInventory()->end();)
 	{
-		if ((*i)->getSlot() != _game->getRuleset()->getInventory("STR_GROUND"))
+		if ((*i)->getSlot() != ground)
 		{
 			i = _craftInventoryTile->getInventory()->erase(i);
 			continue;
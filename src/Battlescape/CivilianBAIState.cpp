@@ -28,6 +28,7 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Ruleset/Armor.h"
 #include "../Savegame/Tile.h"
 
@@ -117,6 +118,10 @@ void CivilianBAIState::exit()
  */
 void CivilianBAIState::think(BattleAction *action)
 {
+	Profiler::Scope profile(Profiler::PHASE_AI);
+	// think with a stream of our own, so the battle's stream moves on the same however long we deliberate
+	RNG::Stream rng = RNG::split();
+	RNG::StreamScope scope(&rng);
  	action->type = BA_RETHINK;
 	action->actor = _unit;
 	_escapeAction->number = action->number;
@@ -34,6 +34,7 @@
 #include "../Ruleset/RuleCraft.h"
 #include "../Ruleset/RuleInventory.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Ruleset/RuleIds.h"
 #include "../Ruleset/RuleRegion.h"
 #include "../Ruleset/Armor.h"
 #include "../Savegame/AlienBase.h"
@@ -393,21 +394,15 @@ void DebriefingState::prepareDebriefing()
 		{
 			if ((*j)->isInBattlescape())
 			{
-				for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+				Region *region = _game->getSavedGame()->locateRegion((*j)->getLongitude(), (*j)->getLatitude(), _game->getRuleset());
+				if (region)
 				{
-					if ((*k)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						_region = (*k);
-						break;
-					}
+					_region = region;
 				}
-				for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+				Country *country = _game->getSavedGame()->locateCountry((*j)->getLongitude(), (*j)->getLatitude(), _game->getRuleset());
+				if (country)
 				{
-					if ((*k)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						_country = (*k);
-						break;
-					}
+					_country = country;
 				}
 				craft = (*j);
 				base = (*i);
@@ -430,21 +425,15 @@ void DebriefingState::prepareDebriefing()
 		{
 			base = (*i);
 			base->setInBattlescape(false);
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+			Region *region = _game->getSavedGame()->locateRegion(base->getLongitude(), base->getLatitude(), _game->getRuleset());
+			if (region)
 			{
-				if ((*k)->getRules()->insideRegion(base->getLongitude(), base->getLatitude()))
-				{
-					_region = (*k);
-					break;
-				}
+				_region = region;
 			}
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+			Country *country = _game->getSavedGame()->locateCountry(base->getLongitude(), base->getLatitude(), _game->getRuleset());
+			if (country)
 			{
-				if ((*k)->getRules()->insideCountry(base->getLongitude(), base->getLatitude()))
-				{
-					_country = (*k);
-					break;
-				}
+				_country = country;
 			}
 			if (aborted)
 			{
@@ -978,20 +967,22 @@ void DebriefingState::prepareDebriefing()
  */
 void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCanBeDestroyed)
 {
-	std::map<std::string, int> craftItems = *craft->getItems()->getContents();
-	for (std::map<std::string, int>::iterator i = craftItems.begin(); i != craftItems.end(); ++i)
+	std::vector<int> craftItems = craft->getItems()->getContents();
+	for (size_t i = 0; i < craftItems.size(); ++i)
 	{
-		int qty = base->getItems()->getItem(i->first);
-		if (qty >= i->second)
+		if (craftItems[i] == 0)
+			continue;
+		int qty = base->getItems()->getItem(i);
+		if (qty >= craftItems[i])
 		{
-			base->getItems()->removeItem(i->first, i->second);
+			base->getItems()->removeItem(i, craftItems[i]);
 		}
 		else
 		{
-			int missing = i->second - qty;
-			base->getItems()->removeItem(i->first, qty);
-			craft->getItems()->removeItem(i->first, missing);
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage())};
+			int missing = craftItems[i] - qty;
+			base->getItems()->removeItem(i, qty);
+			craft->getItems()->removeItem(i, missing);
+			ReequipStat stat = {RuleIds::getName(i), missing, craft->getName(_game->getLanguage())};
 			_missingItems.push_back(stat);
 		}
 	}
@@ -999,7 +990,7 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 	// Now let's see the vehicles
 	ItemContainer craftVehicles;
 	for (std::vector<Vehicle*>::iterator i = craft->getVehicles()->begin(); i != craft->getVehicles()->end(); ++i)
-		craftVehicles.addItem((*i)->getRules()->getType());
+		craftVehicles.addItem((*i)->getRules()->getId());
 	// Now we know how many vehicles (separated by types) we have to read
 	// Erase the current vehicles, because we have to reAdd them (cause we want to redistribute their ammo)
 	if (vehicleItemsCanBeDestroyed)
@@ -1007,37 +998,40 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 			delete (*i);
 	craft->getVehicles()->clear();
 	// Ok, now read those vehicles
-	for (std::map<std::string, int>::iterator i = craftVehicles.getContents()->begin(); i != craftVehicles.getContents()->end(); ++i)
+	const std::vector<int> &vehicles = craftVehicles.getContents();
+	for (size_t i = 0; i < vehicles.size(); ++i)
 	{
-		int qty = base->getItems()->getItem(i->first);
-		RuleItem *tankRule = _game->getRuleset()->getItem(i->first);
+		if (vehicles[i] == 0)
+			continue;
+		int qty = base->getItems()->getItem(i);
+		RuleItem *tankRule = _game->getRuleset()->getItem(i);
 		int size = 4;
-		if (_game->getRuleset()->getUnit(tankRule->getType()))
+		if (_game->getRuleset()->getUnit(i))
 		{
-			size = _game->getRuleset()->getArmor(_game->getRuleset()->getUnit(tankRule->getType())->getArmor())->getSize();
+			size = _game->getRuleset()->getArmor(_game->getRuleset()->getUnit(i)->getArmor())->getSize();
 			size *= size;
 		}
-		int canBeAdded = std::min(qty, i->second);
-		if (qty < i->second)
+		int canBeAdded = std::min(qty, vehicles[i]);
+		if (qty < vehicles[i])
 		{ // missing tanks
-			int missing = i->second - qty;
-			ReequipStat stat = {i->first, missing, craft->getName(_game->getLanguage())};
+			int missing = vehicles[i] - qty;
+			ReequipStat stat = {RuleIds::getName(i), missing, craft->getName(_game->getLanguage())};
 			_missingItems.push_back(stat);
 		}
 		if (tankRule->getCompatibleAmmo()->empty())
 		{ // so this tank does NOT require ammo
 			for (int j = 0; j < canBeAdded; ++j)
 				craft->getVehicles()->push_back(new Vehicle(tankRule, tankRule->getClipSize(), size));
-			base->getItems()->removeItem(i->first, canBeAdded);
+			base->getItems()->removeItem(i, canBeAdded);
 		}
 		else
 		{ // so this tank requires ammo
 			RuleItem *ammo = _game->getRuleset()->getItem(tankRule->getCompatibleAmmo()->front());
 			int ammoPerVehicle = ammo->getClipSize();
-			int baqty = base->getItems()->getItem(ammo->getType()); // Ammo Quantity for this vehicle-type on the base
-			if (baqty < i->second * ammoPerVehicle)
+			int baqty = base->getItems()->getItem(ammo->getId()); // Ammo Quantity for this vehicle-type on the base
+			if (baqty < vehicles[i] * ammoPerVehicle)
 			{ // missing ammo
-				int missing = (i->second * ammoPerVehicle) - baqty;
+				int missing = (vehicles[i] * ammoPerVehicle) - baqty;
 				ReequipStat stat = {ammo->getType(), missing, craft->getName(_game->getLanguage())};
 				_missingItems.push_back(stat);
 			}
@@ -1047,9 +1041,9 @@ void DebriefingState::reequipCraft(Base *base, Craft *craft, bool vehicleItemsCa
 				for (int j = 0; j < canBeAdded; ++j)
 				{
 					craft->getVehicles()->push_back(new Vehicle(tankRule, ammoPerVehicle, size));
-					base->getItems()->removeItem(ammo->getType(), ammoPerVehicle);
+					base->getItems()->removeItem(ammo->getId(), ammoPerVehicle);
 				}
-				base->getItems()->removeItem(i->first, canBeAdded);
+				base->getItems()->removeItem(i, canBeAdded);
 			}
 		}
 	}
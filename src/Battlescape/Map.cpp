@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <fstream>
+#include <algorithm>
 #include "Map.h"
 #include "Camera.h"
 #include "UnitSprite.h"
@@ -77,7 +78,7 @@ namespace OpenXcom
  * @param y Y position in pixels.
  * @param visibleMapHeight Current visible map height.
  */
-Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _projectile(0), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false), _smoothingEngaged(false)
+Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight) : InteractiveSurface(width, height, x, y), _game(game), _arrow(0), _selectorX(0), _selectorY(0), _mouseX(0), _mouseY(0), _cursorType(CT_NORMAL), _cursorSize(1), _animFrame(0), _projectile(0), _projectileInFOV(false), _explosionInFOV(false), _launch(false), _visibleMapHeight(visibleMapHeight), _unitDying(false), _smoothingEngaged(false), _numWaypid(0), _cacheVersion(0), _fullRedraw(true)
 {
 	_previewSetting = Options::battleNewPreviewPath;
 	_smoothCamera = Options::battleSmoothCamera;
@@ -105,6 +106,9 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 	_txtAccuracy->setPalette(_game->getScreen()->getPalette());
 	_txtAccuracy->setHighContrast(true);
 	_txtAccuracy->initText(_res->getFont("FONT_BIG"), _res->getFont("FONT_SMALL"), _game->getLanguage());
+
+	_numWaypid = new NumberText(15, 15, 20, 30);
+	_numWaypid->setPalette(_game->getScreen()->getPalette());
 }
 
 /**
@@ -118,6 +122,7 @@ Map::~Map()
 	delete _message;
 	delete _camera;
 	delete _txtAccuracy;
+	delete _numWaypid;
 }
 
 /**
@@ -171,8 +176,8 @@ void Map::draw()
 	// normally we'd call for a Surface::draw();
 	// but we don't want to clear the background with colour 0, which is transparent (aka black)
 	// we use colour 15 because that actually corresponds to the colour we DO want in all variations of the xcom and tftd palettes.
+	// the terrain only clears the parts it redraws.
 	_redraw = false;
-	clear(Palette::blockOffset(0)+15);
 
 	Tile *t;
 
@@ -205,7 +210,9 @@ void Map::draw()
 	}
 	else
 	{
+		clear(Palette::blockOffset(0)+15);
 		_message->blit(this);
+		_fullRedraw = true;
 	}
 }
 
@@ -226,11 +233,15 @@ void Map::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 	_message->setBackground(_res->getSurface("TAC00.SCR"));
 	_message->initText(_res->getFont("FONT_BIG"), _res->getFont("FONT_SMALL"), _game->getLanguage());
 	_message->setText(_game->getLanguage()->getString("STR_HIDDEN_MOVEMENT"));
+	_numWaypid->setPalette(colors, firstcolor, ncolors);
+	_fullRedraw = true;
 }
 
 /**
  * Draw the terrain.
  * Keep this function as optimised as possible. It's big to minimise overhead of function calls.
+ * The sprites are queued up per tile rather than drawn straight away,
+ * so only the parts of the map that changed since the last frame get redrawn.
  * @param surface The surface to draw on.
  */
 void Map::drawTerrain(Surface *surface)
@@ -248,8 +259,10 @@ void Map::drawTerrain(Surface *surface)
 	bool invalid;
 	int tileShade, wallShade, tileColor;
 	static const int arrowBob[8] = {0,1,2,1,0,1,2,1};
-	
-	NumberText *_numWaypid = 0;
+
+	_blits.clear();
+	_groups.clear();
+	beginGroup();
 
 	// if we got bullet, get the highest x and y tiles to draw it on
 	if (_projectile && _explosions.empty())
@@ -369,14 +382,8 @@ void Map::drawTerrain(Surface *surface)
 
 	bool pathfinderTurnedOn = _save->getPathfinding()->isPathPreviewed();
 
-	if (!_waypoints.empty() || (pathfinderTurnedOn && (_previewSetting & PATH_TU_COST)))
-	{
-		_numWaypid = new NumberText(15, 15, 20, 30);
-		_numWaypid->setPalette(getPalette());
-		_numWaypid->setColor(Palette::blockOffset(pathfinderTurnedOn ? 0 : 1));
-	}
+	_numWaypid->setColor(Palette::blockOffset(pathfinderTurnedOn ? 0 : 1));
 
-	surface->lock();
 	for (int itZ = beginZ; itZ <= endZ; itZ++)
 	{
 		for (int itX = beginX; itX <= endX; itX++)
@@ -391,6 +398,7 @@ void Map::drawTerrain(Surface *surface)
 				if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
 					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
 				{
+					beginGroup();
 					tile = _save->getTile(mapPosition);
 
 					if (!tile) continue;
@@ -410,7 +418,7 @@ void Map::drawTerrain(Surface *surface)
 					// Draw floor
 					tmpSurface = tile->getSprite(MapData::O_FLOOR);
 					if (tmpSurface)
-						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade, false);
+						queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade, false);
 					unit = tile->getUnit();
 
 					// Draw cursor back
@@ -432,13 +440,13 @@ void Map::drawTerrain(Surface *surface)
 									frameNumber = 6; // red static crosshairs
 							}
 							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
 						else if (_camera->getViewLevel() > itZ)
 						{
 							frameNumber = 2; // blue box
 							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
 					}
 
@@ -474,13 +482,13 @@ void Map::drawTerrain(Surface *surface)
 								// draw unit
 								Position offset;
 								calculateWalkingOffset(bu, &offset);
-								tmpSurface->blitNShade(surface, screenPosition.x + offset.x + tileOffset.x, screenPosition.y + offset.y  + tileOffset.y, tileNorthShade);
+								queueUnit(tmpSurface, screenPosition.x + offset.x + tileOffset.x, screenPosition.y + offset.y  + tileOffset.y, tileNorthShade);
 								// draw fire
 								if (bu->getFire() > 0)
 								{
 									frameNumber = 4 + (_animFrame / 2);
 									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-									tmpSurface->blitNShade(surface, screenPosition.x + offset.x + tileOffset.x, screenPosition.y + offset.y + tileOffset.y, 0);
+									queueBlit(tmpSurface, screenPosition.x + offset.x + tileOffset.x, screenPosition.y + offset.y + tileOffset.y, 0);
 								}
 							}
 
@@ -502,7 +510,7 @@ void Map::drawTerrain(Surface *surface)
 								tmpSurface = tileTwoNorth->getSprite(MapData::O_OBJECT);
 								if (tmpSurface && tileTwoNorth->getMapData(MapData::O_OBJECT)->getBigWall() == 6)
 								{
-									tmpSurface->blitNShade(surface, screenPosition.x + tileOffset.x*2, screenPosition.y - tileTwoNorth->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y*2, tileTwoNorthShade);
+									queueBlit(tmpSurface, screenPosition.x + tileOffset.x*2, screenPosition.y - tileTwoNorth->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y*2, tileTwoNorthShade);
 								}
 							}
 
@@ -523,7 +531,7 @@ void Map::drawTerrain(Surface *surface)
 								tmpSurface = tileNorthWest->getSprite(MapData::O_OBJECT);
 								if (tmpSurface && tileNorthWest->getMapData(MapData::O_OBJECT)->getBigWall() == 7)
 								{
-									tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tileNorthWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y*2, tileNorthWestShade);
+									queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tileNorthWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y*2, tileNorthWestShade);
 								}
 							}
 
@@ -534,7 +542,7 @@ void Map::drawTerrain(Surface *surface)
 							{
 								tmpSurface = tileNorth->getSprite(MapData::O_OBJECT);
 								if (tmpSurface)
-									tmpSurface->blitNShade(surface, screenPosition.x + tileOffset.x, screenPosition.y - tileNorth->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileNorthShade);
+									queueBlit(tmpSurface, screenPosition.x + tileOffset.x, screenPosition.y - tileNorth->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileNorthShade);
 							}
 							if (mapPosition.x > 0)
 							{
@@ -557,7 +565,7 @@ void Map::drawTerrain(Surface *surface)
 									tmpSurface = tileSouthWest->getSprite(MapData::O_OBJECT);
 									if (tmpSurface)
 									{
-											tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x * 2, screenPosition.y - tileSouthWest->getMapData(MapData::O_OBJECT)->getYOffset(), tileSouthWestShade, true);
+											queueBlit(tmpSurface, screenPosition.x - tileOffset.x * 2, screenPosition.y - tileSouthWest->getMapData(MapData::O_OBJECT)->getYOffset(), tileSouthWestShade, true);
 									}
 								}
 
@@ -583,7 +591,7 @@ void Map::drawTerrain(Surface *surface)
 										wallShade = tileWest->getShade();
 									else
 										wallShade = tileWestShade;
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_WESTWALL)->getYOffset() + tileOffset.y, wallShade, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_WESTWALL)->getYOffset() + tileOffset.y, wallShade, true);
 								}
 								tmpSurface = tileWest->getSprite(MapData::O_NORTHWALL);
 								if (tmpSurface)
@@ -593,18 +601,18 @@ void Map::drawTerrain(Surface *surface)
 										wallShade = tileWest->getShade();
 									else
 										wallShade = tileWestShade;
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_NORTHWALL)->getYOffset() + tileOffset.y, wallShade, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_NORTHWALL)->getYOffset() + tileOffset.y, wallShade, true);
 								}
 								tmpSurface = tileWest->getSprite(MapData::O_OBJECT);
 								if (tmpSurface && tileWest->getMapData(MapData::O_OBJECT)->getBigWall() < 6 && tileWest->getMapData(MapData::O_OBJECT)->getBigWall() != 3)
 								{
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileWestShade, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileWestShade, true);
 									// if the object in the tile to the west is a diagonal big wall, we need to cover up the black triangle at the bottom
 									if (tileWest->getMapData(MapData::O_OBJECT)->getBigWall() == 2)
 									{
 										tmpSurface = tile->getSprite(MapData::O_FLOOR);
 										if (tmpSurface)
-											tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade);
+											queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_FLOOR)->getYOffset(), tileShade);
 									}
 								}
 								// draw an item on top of the floor (if any)
@@ -612,7 +620,7 @@ void Map::drawTerrain(Surface *surface)
 								if (sprite != -1)
 								{
 									tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileWest->getTerrainLevel() + tileOffset.y, tileWestShade, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y + tileWest->getTerrainLevel() + tileOffset.y, tileWestShade, true);
 								}
 								// Draw soldier
 								if (westUnit && westUnit->getStatus() != STATUS_WALKING && (!tileWest->getMapData(MapData::O_OBJECT) || tileWest->getMapData(MapData::O_OBJECT)->getBigWall() < 6) && (westUnit->getVisible() || _save->getDebugMode()))
@@ -624,12 +632,12 @@ void Map::drawTerrain(Surface *surface)
 									tmpSurface = westUnit->getCache(&invalid, part);
 									if (tmpSurface)
 									{
-										tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y + getTerrainLevel(westUnit->getPosition(), westUnit->getArmor()->getSize()), tileWestShade, true);
+										queueUnit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y + getTerrainLevel(westUnit->getPosition(), westUnit->getArmor()->getSize()), tileWestShade, true);
 										if (westUnit->getFire() > 0)
 										{
 											frameNumber = 4 + (_animFrame / 2);
 											tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-											tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y + getTerrainLevel(westUnit->getPosition(), westUnit->getArmor()->getSize()), 0, true);
+											queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y + getTerrainLevel(westUnit->getPosition(), westUnit->getArmor()->getSize()), 0, true);
 										}
 									}
 								}
@@ -652,13 +660,13 @@ void Map::drawTerrain(Surface *surface)
 										frameNumber += (_animFrame / 2) + tileWest->getAnimationOffset();
 									}
 									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y, 0, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y + tileOffset.y, 0, true);
 								}
 								// Draw object
 								if (tileWest->getMapData(MapData::O_OBJECT) && tileWest->getMapData(MapData::O_OBJECT)->getBigWall() >= 6)
 								{
 									tmpSurface = tileWest->getSprite(MapData::O_OBJECT);
-									tmpSurface->blitNShade(surface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileWestShade, true);
+									queueBlit(tmpSurface, screenPosition.x - tileOffset.x, screenPosition.y - tileWest->getMapData(MapData::O_OBJECT)->getYOffset() + tileOffset.y, tileWestShade, true);
 								}
 							}
 						}
@@ -677,7 +685,7 @@ void Map::drawTerrain(Surface *surface)
 								wallShade = tile->getShade();
 							else
 								wallShade = tileShade;
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_WESTWALL)->getYOffset(), wallShade, false);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_WESTWALL)->getYOffset(), wallShade, false);
 						}
 						// Draw north wall
 						tmpSurface = tile->getSprite(MapData::O_NORTHWALL);
@@ -690,11 +698,11 @@ void Map::drawTerrain(Surface *surface)
 								wallShade = tileShade;
 							if (tile->getMapData(MapData::O_WESTWALL))
 							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, true);
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, true);
 							}
 							else
 							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, false);
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_NORTHWALL)->getYOffset(), wallShade, false);
 							}
 						}
 						// Draw object
@@ -702,14 +710,14 @@ void Map::drawTerrain(Surface *surface)
 						{
 							tmpSurface = tile->getSprite(MapData::O_OBJECT);
 							if (tmpSurface)
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false);
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false);
 						}
 						// draw an item on top of the floor (if any)
 						int sprite = tile->getTopItemSprite();
 						if (sprite != -1)
 						{
 							tmpSurface = _res->getSurfaceSet("FLOOROB.PCK")->getFrame(sprite);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), tileShade, false);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), tileShade, false);
 						}
 
 					}
@@ -733,7 +741,7 @@ void Map::drawTerrain(Surface *surface)
 								_save->getTileEngine()->isVoxelVisible(voxelPos))
 							{
 								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-								tmpSurface->blitNShade(surface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 16);
+								queueBlit(tmpSurface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 16);
 							}
 
 							voxelPos = _projectile->getPosition();
@@ -746,7 +754,7 @@ void Map::drawTerrain(Surface *surface)
 								_save->getTileEngine()->isVoxelVisible(voxelPos))
 							{
 								_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
-								tmpSurface->blitNShade(surface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 0);
+								queueBlit(tmpSurface, bulletPositionScreen.x - 16, bulletPositionScreen.y - 26, 0);
 							}
 
 						}
@@ -781,7 +789,7 @@ void Map::drawTerrain(Surface *surface)
 											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 											bulletPositionScreen.x -= tmpSurface->getWidth() / 2;
 											bulletPositionScreen.y -= tmpSurface->getHeight() / 2;
-											tmpSurface->blitNShade(surface, bulletPositionScreen.x, bulletPositionScreen.y, 16);
+											queueBlit(tmpSurface, bulletPositionScreen.x, bulletPositionScreen.y, 16);
 										}
 
 										// draw bullet itself
@@ -794,7 +802,7 @@ void Map::drawTerrain(Surface *surface)
 											_camera->convertVoxelToScreen(voxelPos, &bulletPositionScreen);
 											bulletPositionScreen.x -= tmpSurface->getWidth() / 2;
 											bulletPositionScreen.y -= tmpSurface->getHeight() / 2;
-											tmpSurface->blitNShade(surface, bulletPositionScreen.x, bulletPositionScreen.y, 0);
+											queueBlit(tmpSurface, bulletPositionScreen.x, bulletPositionScreen.y, 0);
 										}
 									}
 								}
@@ -814,12 +822,12 @@ void Map::drawTerrain(Surface *surface)
 						{
 							Position offset;
 							calculateWalkingOffset(unit, &offset);
-							tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, tileShade);
+							queueUnit(tmpSurface, screenPosition.x + offset.x, screenPosition.y + offset.y, tileShade);
 							if (unit->getFire() > 0)
 							{
 								frameNumber = 4 + (_animFrame / 2);
 								tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-								tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
+								queueBlit(tmpSurface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
 							}
 						}
 					}
@@ -841,7 +849,7 @@ void Map::drawTerrain(Surface *surface)
 								Position offset;
 								calculateWalkingOffset(tunit, &offset);
 								offset.y += 24;
-								tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, ttile->getShade());
+								queueUnit(tmpSurface, screenPosition.x + offset.x, screenPosition.y + offset.y, ttile->getShade());
 								if (tunit->getArmor()->getSize() > 1)
 								{
 									offset.y += 4;
@@ -850,7 +858,7 @@ void Map::drawTerrain(Surface *surface)
 								{
 									frameNumber = 4 + (_animFrame / 2);
 									tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-									tmpSurface->blitNShade(surface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
+									queueBlit(tmpSurface, screenPosition.x + offset.x, screenPosition.y + offset.y, 0);
 								}
 							}
 						}
@@ -874,7 +882,7 @@ void Map::drawTerrain(Surface *surface)
 							frameNumber += (_animFrame / 2) + tile->getAnimationOffset();
 						}
 						tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame(frameNumber);
-						tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+						queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 					}
 
 					// Draw Path Preview
@@ -885,13 +893,13 @@ void Map::drawTerrain(Surface *surface)
 							tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(11);
 							if (tmpSurface)
 							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
 							}
 						}
 						tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(tile->getPreview());
 						if (tmpSurface)
 						{
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), 0, false, tileColor);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y + tile->getTerrainLevel(), 0, false, tileColor);
 						}
 					}
 					if (!tile->isVoid())
@@ -901,7 +909,7 @@ void Map::drawTerrain(Surface *surface)
 						{
 							tmpSurface = tile->getSprite(MapData::O_OBJECT);
 							if (tmpSurface)
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false);
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y - tile->getMapData(MapData::O_OBJECT)->getYOffset(), tileShade, false);
 						}
 					}
 					// Draw cursor front
@@ -924,7 +932,7 @@ void Map::drawTerrain(Surface *surface)
 									frameNumber = 6; // red static crosshairs
 							}
 							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 
 							// UFO extender accuracy: display adjusted accuracy value on crosshair in real-time.
 							if (_cursorType == CT_AIM && Options::battleUFOExtenderAccuracy)
@@ -977,20 +985,20 @@ void Map::drawTerrain(Surface *surface)
 								ss << "%";
 								_txtAccuracy->setText(Language::utf8ToWstr(ss.str().c_str()).c_str());
 								_txtAccuracy->draw();
-								_txtAccuracy->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+								queueBlit(_txtAccuracy, screenPosition.x, screenPosition.y, 0, false, 0, (accuracy << 8) | _txtAccuracy->getColor());
 							}
 						}
 						else if (_camera->getViewLevel() > itZ)
 						{
 							frameNumber = 5; // blue box
 							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frameNumber);
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
 						if (_cursorType > 2 && _camera->getViewLevel() == itZ)
 						{
 							int frame[6] = {0, 0, 0, 11, 13, 15};
 							tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(frame[_cursorType] + (_animFrame / 4));
-							tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+							queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 						}
 					}
 
@@ -1006,13 +1014,11 @@ void Map::drawTerrain(Surface *surface)
 							if (waypXOff == 2 && waypYOff == 2)
 							{
 								tmpSurface = _res->getSurfaceSet("CURSOR.PCK")->getFrame(7);
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y, 0);
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y, 0);
 							}
 							if (_save->getBattleGame()->getCurrentAction()->type == BA_LAUNCH)
 							{
-								_numWaypid->setValue(waypid);
-								_numWaypid->draw();
-								_numWaypid->blitNShade(surface, screenPosition.x + waypXOff, screenPosition.y + waypYOff, 0);
+								queueNumber(waypid, false, screenPosition.x + waypXOff, screenPosition.y + waypYOff);
 
 								waypXOff += waypid > 9 ? 8 : 6;
 								if (waypXOff >= 26)
@@ -1030,10 +1036,6 @@ void Map::drawTerrain(Surface *surface)
 	}
 	if (pathfinderTurnedOn)
 	{
-		if (_numWaypid)
-		{
-			_numWaypid->setBordered(true); // give it a border for the pathfinding display, makes it more visible on snow, etc.
-		}
 		for (int itZ = beginZ; itZ <= endZ; itZ++)
 		{
 			for (int itX = beginX; itX <= endX; itX++)
@@ -1048,6 +1050,7 @@ void Map::drawTerrain(Surface *surface)
 					if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
 						screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
 					{
+						beginGroup();
 						tile = _save->getTile(mapPosition);
 						Tile *tileBelow = _save->getTile(mapPosition - Position(0,0,1));
 						if (!tile || !tile->isDiscovered(0) || tile->getPreview() == -1)
@@ -1060,14 +1063,14 @@ void Map::drawTerrain(Surface *surface)
 								tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(23);
 								if (tmpSurface)
 								{
-									tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
+									queueBlit(tmpSurface, screenPosition.x, screenPosition.y+2, 0, false, tile->getMarkerColor());
 								}
 							}
 							int overlay = tile->getPreview() + 12;
 							tmpSurface = _res->getSurfaceSet("Pathfinding")->getFrame(overlay);
 							if (tmpSurface)
 							{
-								tmpSurface->blitNShade(surface, screenPosition.x, screenPosition.y - adjustment, 0, false, tile->getMarkerColor());
+								queueBlit(tmpSurface, screenPosition.x, screenPosition.y - adjustment, 0, false, tile->getMarkerColor());
 							}
 						}
 
@@ -1082,26 +1085,22 @@ void Map::drawTerrain(Surface *surface)
 									adjustment += 7;
 								}
 							}
-							_numWaypid->setValue(tile->getTUMarker());
-							_numWaypid->draw();
+							// give it a border for the pathfinding display, makes it more visible on snow, etc.
 							if ( !(_previewSetting & PATH_ARROWS) )
 							{
-								_numWaypid->blitNShade(surface, screenPosition.x + 16 - off, screenPosition.y + (29-adjustment), 0, false, tile->getMarkerColor() );
+								queueNumber(tile->getTUMarker(), true, screenPosition.x + 16 - off, screenPosition.y + (29-adjustment), tile->getMarkerColor() );
 							}
 							else
 							{
-								_numWaypid->blitNShade(surface, screenPosition.x + 16 - off, screenPosition.y + (22-adjustment), 0);
+								queueNumber(tile->getTUMarker(), true, screenPosition.x + 16 - off, screenPosition.y + (22-adjustment));
 							}
 						}
 					}
 				}
 			}
 		}
-		if (_numWaypid)
-		{
-			_numWaypid->setBordered(false); // make sure we remove the border in case it's being used for missile waypoints.
-		}
 	}
+	beginGroup();
 	unit = (BattleUnit*)_save->getSelectedUnit();
 	if (unit && (_save->getSide() == FACTION_PLAYER || _save->getDebugMode()) && unit->getPosition().z <= _camera->getViewLevel())
 	{
@@ -1120,12 +1119,12 @@ void Map::drawTerrain(Surface *surface)
 		}
 		if (this->getCursorType() != CT_NONE)
 		{
-			_arrow->blitNShade(surface, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + arrowBob[_animFrame], 0);
+			queueBlit(_arrow, screenPosition.x + offset.x + (_spriteWidth / 2) - (_arrow->getWidth() / 2), screenPosition.y + offset.y - _arrow->getHeight() + arrowBob[_animFrame], 0);
 		}
 	}
-	delete _numWaypid;
 
 	// check if we got big explosions
+	beginGroup();
 	if (_explosionInFOV)
 	{
 		for (std::list<Explosion*>::const_iterator i = _explosions.begin(); i != _explosions.end(); ++i)
@@ -1136,22 +1135,249 @@ void Map::drawTerrain(Surface *surface)
 				if ((*i)->getCurrentFrame() >= 0)
 				{
 					tmpSurface = _res->getSurfaceSet("X1.PCK")->getFrame((*i)->getCurrentFrame());
-					tmpSurface->blitNShade(surface, bulletPositionScreen.x - 64, bulletPositionScreen.y - 64, 0);
+					queueBlit(tmpSurface, bulletPositionScreen.x - 64, bulletPositionScreen.y - 64, 0);
 				}
 			}
 			else if ((*i)->isHit())
 			{
 				tmpSurface = _res->getSurfaceSet("HIT.PCK")->getFrame((*i)->getCurrentFrame());
-				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 25, 0);
+				queueBlit(tmpSurface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 25, 0);
 			}
 			else
 			{
 				tmpSurface = _res->getSurfaceSet("SMOKE.PCK")->getFrame((*i)->getCurrentFrame());
-				tmpSurface->blitNShade(surface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
+				queueBlit(tmpSurface, bulletPositionScreen.x - 15, bulletPositionScreen.y - 15, 0);
+			}
+		}
+	}
+	drawBlits(surface);
+}
+
+/**
+ * Starts a new group of blits. Each tile gets its own group,
+ * so a frame can be compared to the last one tile by tile.
+ */
+void Map::beginGroup()
+{
+	_groups.push_back(_blits.size());
+}
+
+/**
+ * Queues up a shaded blit to be drawn at the end of the frame.
+ * @param src Surface to blit.
+ * @param x X position on the map surface.
+ * @param y Y position on the map surface.
+ * @param off Shade offset.
+ * @param half Only blit the right half.
+ * @param newBaseColor New base color + 1, or 0 to keep the colors.
+ * @param version Version of the contents of @a src, for surfaces that get redrawn.
+ */
+void Map::queueBlit(Surface *src, int x, int y, int off, bool half, int newBaseColor, int version)
+{
+	MapBlit blit;
+	blit.surface = src;
+	blit.version = version;
+	blit.x = x;
+	blit.y = y;
+	blit.w = src->getWidth();
+	blit.h = src->getHeight();
+	blit.off = off;
+	blit.color = newBaseColor;
+	blit.half = half;
+	_blits.push_back(blit);
+}
+
+/**
+ * Queues up a blit of a unit's cached sprite,
+ * keeping track of when the cache was last redrawn.
+ * @param src Unit cache surface.
+ * @param x X position on the map surface.
+ * @param y Y position on the map surface.
+ * @param off Shade offset.
+ * @param half Only blit the right half.
+ */
+void Map::queueUnit(Surface *src, int x, int y, int off, bool half)
+{
+	std::map<Surface*, int>::const_iterator i = _cacheVersions.find(src);
+	queueBlit(src, x, y, off, half, 0, i != _cacheVersions.end() ? i->second : 0);
+}
+
+/**
+ * Queues up a blit of a number. The number text is only
+ * drawn when the blit is, so all numbers can share it.
+ * @param value Number to draw.
+ * @param bordered Draw the number with a border.
+ * @param x X position on the map surface.
+ * @param y Y position on the map surface.
+ * @param newBaseColor New base color + 1, or 0 to keep the colors.
+ */
+void Map::queueNumber(unsigned int value, bool bordered, int x, int y, int newBaseColor)
+{
+	queueBlit(_numWaypid, x, y, 0, false, newBaseColor, (value << 9) | ((bordered ? 1 : 0) << 8) | _numWaypid->getColor());
+}
+
+/**
+ * Marks the grid cells covered by some blits as needing a redraw.
+ * @param blits List of blits.
+ * @param begin First blit to mark.
+ * @param end Blit to stop at.
+ * @param surface Surface the blits are drawn to.
+ */
+void Map::markDirty(const std::vector<MapBlit> &blits, size_t begin, size_t end, Surface *surface)
+{
+	const int cols = (surface->getWidth() + DIRTY_CELL - 1) / DIRTY_CELL;
+	const int rows = (surface->getHeight() + DIRTY_CELL - 1) / DIRTY_CELL;
+	for (size_t i = begin; i < end; ++i)
+	{
+		const MapBlit &b = blits[i];
+		int x1 = b.half ? b.x + b.w / 2 : b.x;
+		int x2 = b.x + b.w;
+		int y2 = b.y + b.h;
+		if (x2 <= 0 || y2 <= 0 || x1 >= surface->getWidth() || b.y >= surface->getHeight())
+			continue;
+		int beginCol = std::max(x1, 0) / DIRTY_CELL;
+		int endCol = std::min((x2 - 1) / DIRTY_CELL, cols - 1);
+		int beginRow = std::max(b.y, 0) / DIRTY_CELL;
+		int endRow = std::min((y2 - 1) / DIRTY_CELL, rows - 1);
+		for (int row = beginRow; row <= endRow; ++row)
+		{
+			for (int col = beginCol; col <= endCol; ++col)
+			{
+				_dirty[row * cols + col] = true;
+			}
+		}
+	}
+}
+
+/**
+ * Draws the blits queued up for this frame. Tiles whose blits are
+ * the same as last frame's are left alone, and only the cells
+ * covered by tiles that changed are cleared and drawn again,
+ * clipped to those cells. Since every blit touching a cell is
+ * drawn again in the same order, the result is the same as
+ * redrawing everything.
+ * @param surface Surface to draw on.
+ */
+void Map::drawBlits(Surface *surface)
+{
+	const int cols = (surface->getWidth() + DIRTY_CELL - 1) / DIRTY_CELL;
+	const int rows = (surface->getHeight() + DIRTY_CELL - 1) / DIRTY_CELL;
+	bool full = _fullRedraw;
+	_dirty.assign(cols * rows, false);
+
+	if (!full)
+	{
+		size_t groups = std::max(_groups.size(), _lastGroups.size());
+		for (size_t g = 0; g < groups; ++g)
+		{
+			size_t begin = 0, end = 0, lastBegin = 0, lastEnd = 0;
+			if (g < _groups.size())
+			{
+				begin = _groups[g];
+				end = g + 1 < _groups.size() ? _groups[g + 1] : _blits.size();
+			}
+			if (g < _lastGroups.size())
+			{
+				lastBegin = _lastGroups[g];
+				lastEnd = g + 1 < _lastGroups.size() ? _lastGroups[g + 1] : _lastBlits.size();
+			}
+			if (end - begin == lastEnd - lastBegin && std::equal(_blits.begin() + begin, _blits.begin() + end, _lastBlits.begin() + lastBegin))
+				continue;
+			markDirty(_blits, begin, end, surface);
+			markDirty(_lastBlits, lastBegin, lastEnd, surface);
+		}
+		// not worth clipping everything when most of the map changed (eg. scrolling)
+		if (std::count(_dirty.begin(), _dirty.end(), true) * 2 > cols * rows)
+		{
+			full = true;
+		}
+	}
+
+	if (full)
+	{
+		surface->clear(Palette::blockOffset(0)+15);
+		surface->lock();
+		for (std::vector<MapBlit>::const_iterator i = _blits.begin(); i != _blits.end(); ++i)
+		{
+			if (i->surface == _numWaypid)
+			{
+				_numWaypid->setValue(i->version >> 9);
+				_numWaypid->setBordered((i->version & 256) != 0);
+				_numWaypid->draw();
 			}
+			i->surface->blitNShade(surface, i->x, i->y, i->off, i->half, i->color);
 		}
+		surface->unlock();
 	}
-	surface->unlock();
+	else
+	{
+		// merge the dirty cells of each row into strips
+		std::vector<SDL_Rect> strips;
+		std::vector<size_t> rowStrips(rows + 1, 0);
+		for (int row = 0; row < rows; ++row)
+		{
+			rowStrips[row] = strips.size();
+			for (int col = 0; col < cols;)
+			{
+				if (!_dirty[row * cols + col])
+				{
+					++col;
+					continue;
+				}
+				int first = col;
+				while (col < cols && _dirty[row * cols + col])
+					++col;
+				SDL_Rect r;
+				r.x = first * DIRTY_CELL;
+				r.y = row * DIRTY_CELL;
+				r.w = std::min(col * DIRTY_CELL, surface->getWidth()) - r.x;
+				r.h = std::min((row + 1) * DIRTY_CELL, surface->getHeight()) - r.y;
+				strips.push_back(r);
+			}
+		}
+		rowStrips[rows] = strips.size();
+
+		if (!strips.empty())
+		{
+			for (std::vector<SDL_Rect>::iterator i = strips.begin(); i != strips.end(); ++i)
+			{
+				surface->drawRect(&(*i), Palette::blockOffset(0)+15);
+			}
+			surface->lock();
+			for (std::vector<MapBlit>::const_iterator i = _blits.begin(); i != _blits.end(); ++i)
+			{
+				int x1 = i->half ? i->x + i->w / 2 : i->x;
+				int x2 = i->x + i->w;
+				int y2 = i->y + i->h;
+				if (x2 <= 0 || y2 <= 0 || x1 >= surface->getWidth() || i->y >= surface->getHeight())
+					continue;
+				int beginRow = std::max(i->y, 0) / DIRTY_CELL;
+				int endRow = std::min((y2 - 1) / DIRTY_CELL, rows - 1);
+				bool numberDrawn = false;
+				for (size_t j = rowStrips[beginRow]; j < rowStrips[endRow + 1]; ++j)
+				{
+					SDL_Rect &r = strips[j];
+					if (r.x >= x2 || r.x + r.w <= x1)
+						continue;
+					if (i->surface == _numWaypid && !numberDrawn)
+					{
+						_numWaypid->setValue(i->version >> 9);
+						_numWaypid->setBordered((i->version & 256) != 0);
+						_numWaypid->draw();
+						numberDrawn = true;
+					}
+					SDL_SetClipRect(surface->getSurface(), &r);
+					i->surface->blitNShade(surface, i->x, i->y, i->off, i->half, i->color);
+				}
+			}
+			SDL_SetClipRect(surface->getSurface(), 0);
+			surface->unlock();
+		}
+	}
+
+	_lastBlits.swap(_blits);
+	_lastGroups.swap(_groups);
+	_fullRedraw = false;
 }
 
 /**
@@ -1473,7 +1699,9 @@ void Map::cacheUnit(BattleUnit *unit)
 			unitSprite->setAnimationFrame(_animFrame);
 			cache->clear();
 			unitSprite->blit(cache);
+			cache->buildSpans();
 			unit->setCache(cache, i);
+			_cacheVersions[cache] = ++_cacheVersion;
 		}
 	}
 	delete unitSprite;
@@ -1581,6 +1809,7 @@ void Map::setHeight(int height)
 	_visibleMapHeight = height - ICON_HEIGHT;
 	_message->setHeight((_visibleMapHeight < 200)? _visibleMapHeight : 200);
 	_message->setY((_visibleMapHeight - _message->getHeight()) / 2);
+	_fullRedraw = true;
 }
 /*
  * Special handling for setting the width of the map viewport.
@@ -1591,6 +1820,7 @@ void Map::setWidth(int width)
 	int dX = width - getWidth();
 	Surface::setWidth(width);
 	_message->setX(_message->getX() + dX / 2);
+	_fullRedraw = true;
 }
 
 /*
@@ -24,6 +24,7 @@
 #include "Position.h"
 #include <set>
 #include <vector>
+#include <map>
 
 namespace OpenXcom
 {
@@ -38,8 +39,27 @@ class BattlescapeMessage;
 class Camera;
 class Timer;
 class Text;
+class NumberText;
 
 enum CursorType { CT_NONE, CT_NORMAL, CT_AIM, CT_PSI, CT_WAYPOINT, CT_THROW };
+
+/**
+ * A shaded blit queued up while drawing the terrain.
+ * Frames are compared against the previous one to find
+ * the parts of the map that actually need redrawing.
+ */
+struct MapBlit
+{
+	Surface *surface;
+	int version;
+	int x, y, w, h, off, color;
+	bool half;
+	/// Checks if two blits draw the same pixels.
+	bool operator==(const MapBlit &other) const
+	{
+		return surface == other.surface && version == other.version && x == other.x && y == other.y && w == other.w && h == other.h && off == other.off && color == other.color && half == other.half;
+	}
+};
 /**
  * Interactive map of the battlescape.
  */
@@ -48,6 +68,7 @@ class Map : public InteractiveSurface
 private:
 	static const int SCROLL_INTERVAL = 15;
 	static const int BULLET_SPRITES = 35;
+	static const int DIRTY_CELL = 16;
 	Timer *_scrollMouseTimer, *_scrollKeyTimer;
 	Game *_game;
 	SavedBattleGame *_save;
@@ -70,9 +91,28 @@ private:
 	bool _unitDying, _smoothCamera, _smoothingEngaged;
 	PathPreview _previewSetting;
 	Text *_txtAccuracy;
+	NumberText *_numWaypid;
+	std::vector<MapBlit> _blits, _lastBlits;
+	std::vector<size_t> _groups, _lastGroups;
+	std::vector<bool> _dirty;
+	std::map<Surface*, int> _cacheVersions;
+	int _cacheVersion;
+	bool _fullRedraw;
 
 	void drawTerrain(Surface *surface);
 	int getTerrainLevel(Position pos, int size);
+	/// Starts the blits of the next tile.
+	void beginGroup();
+	/// Queues up a shaded blit of the terrain.
+	void queueBlit(Surface *src, int x, int y, int off, bool half = false, int newBaseColor = 0, int version = 0);
+	/// Queues up a blit of a unit's cached sprite.
+	void queueUnit(Surface *src, int x, int y, int off, bool half = false);
+	/// Queues up a blit of a waypoint or TU cost number.
+	void queueNumber(unsigned int value, bool bordered, int x, int y, int newBaseColor = 0);
+	/// Marks the cells covered by a range of blits as dirty.
+	void markDirty(const std::vector<MapBlit> &blits, size_t begin, size_t end, Surface *surface);
+	/// Draws the queued blits that changed since the last frame.
+	void drawBlits(Surface *surface);
 public:
 	static const int ICON_HEIGHT = 56;
 	static const int ICON_WIDTH = 320;
@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <list>
+#include <climits>
 #include "Pathfinding.h"
 #include "PathfindingNode.h"
 #include "PathfindingOpenSet.h"
@@ -28,6 +29,7 @@
 #include "../Savegame/BattleItem.h"
 #include "../Engine/Game.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Battlescape/TileEngine.h"
 #include "../Battlescape/BattlescapeGame.h"
 #include "../Battlescape/BattlescapeState.h"
@@ -39,7 +41,7 @@ namespace OpenXcom
  * Sets up a Pathfinding.
  * @param save pointer to SavedBattleGame object.
  */
-Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK)
+Pathfinding::Pathfinding(SavedBattleGame *save) : _save(save), _nodes(), _generation(0), _unit(0), _pathPreviewed(false), _strafeMove(false), _totalTUCost(0), _modifierUsed(false), _movementType(MT_WALK), _reachStamp(0)
 {
 	_size = _save->getMapSizeXYZ();
 	// Initialize one node per tile
@@ -68,7 +70,24 @@ Pathfinding::~Pathfinding()
  */
 PathfindingNode *Pathfinding::getNode(const Position& pos)
 {
-	return &_nodes[_save->getTileIndex(pos)];
+	PathfindingNode *node = &_nodes[_save->getTileIndex(pos)];
+	node->reset(_generation);
+	return node;
+}
+
+/**
+ * Starts a new search. Nodes are not reset one by one, they compare
+ * the search generation they were last used by when they are fetched.
+ */
+void Pathfinding::resetNodes()
+{
+	_openSet.clear();
+	if (++_generation == INT_MAX)
+	{
+		for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
+			it->reset(0);
+		_generation = 1;
+	}
 }
 
 /**
@@ -80,6 +99,7 @@ PathfindingNode *Pathfinding::getNode(const Position& pos)
  */
 void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *target, int maxTUCost)
 {
+	Profiler::Scope profile(Profiler::PHASE_PATHFINDING);
 	_totalTUCost = 0;
 	_path.clear();
 	// i'm DONE with these out of bounds errors.
@@ -184,13 +204,12 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleUnit *
 bool Pathfinding::aStarPath(const Position &startPosition, const Position &endPosition, BattleUnit *target, bool sneak, int maxTUCost)
 {
 	// reset every node, so we have to check them all
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-		it->reset();
+	resetNodes();
 
 	// start position is the first one in our "open" list
 	PathfindingNode *start = getNode(startPosition);
 	start->connect(0, 0, 0, endPosition);
-	PathfindingOpenSet openList;
+	PathfindingOpenSet &openList = _openSet;
 	openList.push(start);
 	bool missile = (target && maxTUCost == -1);
 	// if the open list is empty, we've reached the end
@@ -1076,17 +1095,41 @@ bool Pathfinding::bresenhamPath(const Position& origin, const Position& target,
  */
 std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 {
+	return getReachMap(unit, tuMax).tiles;
+}
+
+/**
+ * Runs one Dijkstra search from the unit's position and stores the cost
+ * and entry step of every tile it reaches.
+ * @param unit Pointer to the unit.
+ * @param tuMax The maximum cost of the path to each tile.
+ * @param energyMax The maximum energy the path may spend.
+ * @param sneak Should visible tiles cost double, like sneaky units' paths?
+ * @param map The reach map to fill in.
+ */
+void Pathfinding::buildReachMap(BattleUnit *unit, int tuMax, int energyMax, bool sneak, ReachMap &map)
+{
+	Profiler::Scope profile(Profiler::PHASE_PATHFINDING);
 	const Position &start = unit->getPosition();
-	int energyMax = unit->getEnergy();
-	for (std::vector<PathfindingNode>::iterator it = _nodes.begin(); it != _nodes.end(); ++it)
-	{
-		it->reset();
-	}
+	map.origin = start;
+	map.tuMax = tuMax;
+	map.energyMax = energyMax;
+	map.movementType = unit->getArmor()->getMovementType();
+	map.sneak = sneak;
+	map.stamp = _reachStamp;
+	map.cost.assign(_size, -1);
+	map.parent.assign(_size, -1);
+	map.direction.assign(_size, -1);
+	map.tiles.clear();
+
+	// search under the unit's own movement rules, not those of the last path
+	MovementType movementType = _movementType;
+	_movementType = map.movementType;
+	resetNodes();
 	PathfindingNode *startNode = getNode(start);
 	startNode->connect(0, 0, 0);
-	PathfindingOpenSet unvisited;
+	PathfindingOpenSet &unvisited = _openSet;
 	unvisited.push(startNode);
-	std::vector<PathfindingNode*> reachable;
 	while (!unvisited.empty())
 	{
 		PathfindingNode *currentNode = unvisited.pop();
@@ -1099,7 +1142,8 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 			int tuCost = getTUCost(currentPos, direction, &nextPos, unit, 0, false);
 			if (tuCost == 255) // Skip unreachable / blocked
 				continue;
-			if (currentNode->getTUCost(false) + tuCost > tuMax || 
+			if (sneak && _save->getTile(nextPos)->getVisible()) tuCost *= 2; // avoid being seen
+			if (currentNode->getTUCost(false) + tuCost > tuMax ||
 				(currentNode->getTUCost(false) + tuCost) / 2 > energyMax) // Run out of TUs/Energy
 				continue;
 			PathfindingNode *nextNode = getNode(nextPos);
@@ -1114,16 +1158,70 @@ std::vector<int> Pathfinding::findReachable(BattleUnit *unit, int tuMax)
 			}
 		}
 		currentNode->setChecked();
-		reachable.push_back(currentNode);
+		// The open set pops in ascending order of cost, so the list comes out sorted.
+		int index = _save->getTileIndex(currentPos);
+		map.cost[index] = currentNode->getTUCost(false);
+		if (currentNode->getPrevNode())
+		{
+			map.parent[index] = _save->getTileIndex(currentNode->getPrevNode()->getPosition());
+			map.direction[index] = currentNode->getPrevDir();
+		}
+		map.tiles.push_back(index);
+	}
+	_movementType = movementType;
+}
+
+/**
+ * Gets the distance field of a unit: the TU cost and entry step of every
+ * tile it can reach from where it stands. The result is cached per unit
+ * and only searched again after the unit moved, its limits changed or
+ * invalidateReachMaps() was called.
+ * @param unit Pointer to the unit.
+ * @param tuMax The maximum cost of the path to each tile.
+ * @param useEnergy Should the unit's energy limit the paths too?
+ * @param sneak Should visible tiles cost double? Sneaking and plain maps are cached separately.
+ * @return The reach map, valid until the next call for this unit.
+ */
+const ReachMap &Pathfinding::getReachMap(BattleUnit *unit, int tuMax, bool useEnergy, bool sneak)
+{
+	int energyMax = useEnergy ? unit->getEnergy() : INT_MAX;
+	ReachMap &map = _reachMaps[std::make_pair(unit, sneak)];
+	if (map.stamp != _reachStamp || map.origin != unit->getPosition() || map.tuMax != tuMax || map.energyMax != energyMax ||
+		map.movementType != unit->getArmor()->getMovementType() || (int)map.cost.size() != _size)
+	{
+		buildReachMap(unit, tuMax, energyMax, sneak, map);
+	}
+	return map;
+}
+
+/**
+ * Marks all cached distance fields as stale, to be called whenever
+ * terrain or unit positions change what a unit can reach.
+ */
+void Pathfinding::invalidateReachMaps()
+{
+	// stamp -1 is never current, so a wrap around can't revive old maps
+	_reachStamp = (_reachStamp == INT_MAX) ? 0 : _reachStamp + 1;
+}
+
+/**
+ * Rebuilds the path to a tile by following the entry steps back to
+ * the origin, so it costs only the length of the path.
+ * @param index Tile index of the destination.
+ * @return Directions of the path, last step first, like Pathfinding stores them. Empty if unreachable.
+ */
+std::vector<int> ReachMap::getPath(int index) const
+{
+	std::vector<int> path;
+	if (!isReachable(index))
+	{
+		return path;
 	}
-	std::sort(reachable.begin(), reachable.end(), MinNodeCosts());
-	std::vector<int> tiles;
-	tiles.reserve(reachable.size());
-	for (std::vector<PathfindingNode*>::const_iterator it = reachable.begin(); it != reachable.end(); ++it)
+	for (int i = index; parent[i] != -1; i = parent[i])
 	{
-		tiles.push_back(_save->getTileIndex((*it)->getPosition()));
+		path.push_back(direction[i]);
 	}
-	return tiles;
+	return path;
 }
 
 /**
@@ -20,8 +20,11 @@
 #define OPENXCOM_PATHFINDING_H
 
 #include <vector>
+#include <map>
+#include <SDL_types.h>
 #include "Position.h"
 #include "PathfindingNode.h"
+#include "PathfindingOpenSet.h"
 #include "../Ruleset/MapData.h"
 
 namespace OpenXcom
@@ -31,6 +34,42 @@ class SavedBattleGame;
 class Tile;
 class BattleUnit;
 
+/**
+ * A single-source distance field: the cheapest TU cost from a unit's position
+ * to every tile it can reach, plus the step taken into each tile.
+ * Built by one Dijkstra search, it answers reachability, cost and path
+ * queries for any number of destinations.
+ */
+struct ReachMap
+{
+	/// Position the search started from.
+	Position origin;
+	/// TU and energy limits the search was run with.
+	int tuMax, energyMax;
+	/// Movement type the search was run with.
+	MovementType movementType;
+	/// Were visible tiles made more expensive to avoid being seen?
+	bool sneak;
+	/// Invalidation stamp the map was built under.
+	int stamp;
+	/// TU cost per tile index, -1 if the tile can't be reached.
+	std::vector<int> cost;
+	/// Tile index each reachable tile was entered from.
+	std::vector<int> parent;
+	/// Direction taken to enter each reachable tile.
+	std::vector<Sint8> direction;
+	/// Reachable tile indices, sorted by cost.
+	std::vector<int> tiles;
+	/// Creates an empty, stale reach map.
+	ReachMap() : tuMax(-1), energyMax(-1), movementType(MT_WALK), sneak(false), stamp(-1) {}
+	/// Checks whether a tile index can be reached.
+	bool isReachable(int index) const { return index >= 0 && index < (int)cost.size() && cost[index] != -1; }
+	/// Gets the TU cost to reach a tile index, or -1.
+	int getTUCost(int index) const { return isReachable(index) ? cost[index] : -1; }
+	/// Gets the path to a tile index, in Pathfinding's reversed storage order.
+	std::vector<int> getPath(int index) const;
+};
+
 /**
  * A utility class that calculates the shortest path between two points on the battlescape map.
  */
@@ -39,6 +78,8 @@ class Pathfinding
 private:
 	SavedBattleGame *_save;
 	std::vector<PathfindingNode> _nodes;
+	PathfindingOpenSet _openSet;
+	int _generation;
 	int _size;
 	BattleUnit *_unit;
 	bool _pathPreviewed;
@@ -46,8 +87,14 @@ private:
 	int _totalTUCost;
 	bool _modifierUsed;
 	MovementType _movementType;
+	std::map<std::pair<BattleUnit*, bool>, ReachMap> _reachMaps;
+	int _reachStamp;
+	/// Runs a Dijkstra search from a unit into a reach map.
+	void buildReachMap(BattleUnit *unit, int tuMax, int energyMax, bool sneak, ReachMap &map);
 	/// Gets the node at certain position.
 	PathfindingNode *getNode(const Position& pos);
+	/// Starts a new search, invalidating the state of every node.
+	void resetNodes();
 	/// Determines whether a tile blocks a certain movementType.
 	bool isBlocked(Tile *tile, const int part, BattleUnit *missileTarget, int bigWallExclusion = -1);
 	/// Tries to find a straight line path between two positions.
@@ -98,6 +145,10 @@ public:
 	void setUnit(BattleUnit *unit);
 	/// Gets all reachable tiles, based on cost.
 	std::vector<int> findReachable(BattleUnit *unit, int tuMax);
+	/// Gets the cached distance field of a unit, rebuilding it if stale.
+	const ReachMap &getReachMap(BattleUnit *unit, int tuMax, bool useEnergy = true, bool sneak = false);
+	/// Marks all cached distance fields as stale.
+	void invalidateReachMaps();
 	/// Gets _totalTUCost; finds out whether we can hike somewhere in this turn or not.
 	int getTotalTUCost() const { return _totalTUCost; }
 	/// Gets the path preview setting.
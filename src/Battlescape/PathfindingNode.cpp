@@ -26,7 +26,7 @@ namespace OpenXcom
  * Sets up a PathfindingNode.
  * @param pos Position.
  */
-PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _openentry(0)
+PathfindingNode::PathfindingNode(Position pos) : _pos(pos), _checked(0), _tuCost(0), _prevNode(0), _prevDir(0), _tuGuess(0), _generation(0), _inOpen(false), _openKey(0), _openPrev(0), _openNext(0)
 {
 
 }
@@ -48,15 +48,6 @@ const Position &PathfindingNode::getPosition() const
 	return _pos;
 }
 
-/**
- * Resets the node.
- */
-void PathfindingNode::reset()
-{
-	_checked = false;
-	_openentry = 0;
-}
-
 /**
  * Gets the checked status of this node.
  * @return True, if this node was checked.
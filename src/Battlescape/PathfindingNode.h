@@ -19,13 +19,13 @@
 #ifndef OPENXCOM_PATHFINDINGNODE_H
 #define OPENXCOM_PATHFINDINGNODE_H
 
+#include <cstddef>
 #include "Position.h"
 
 namespace OpenXcom
 {
 
 class PathfindingOpenSet;
-struct OpenSetEntry;
 
 /**
  * A class that holds pathfinding info for a certain node on the map.
@@ -40,8 +40,12 @@ private:
 	int _prevDir;
 	/// Approximate cost to reach goal position.
 	int _tuGuess;
-	// Invasive field needed by PathfindingOpenSet
-	OpenSetEntry *_openentry;
+	/// Search the node state belongs to.
+	int _generation;
+	// Invasive fields needed by PathfindingOpenSet
+	bool _inOpen;
+	size_t _openKey;
+	PathfindingNode *_openPrev, *_openNext;
 	friend class PathfindingOpenSet;
 public:
 	/// Creates a new PathfindingNode class.
@@ -50,8 +54,16 @@ public:
 	~PathfindingNode();
 	/// Gets the node position.
 	const Position &getPosition() const;
-	/// Resets the node.
-	void reset();
+	/// Resets the node if it was last used by another search.
+	void reset(int generation)
+	{
+		if (_generation != generation)
+		{
+			_generation = generation;
+			_checked = false;
+			_inOpen = false;
+		}
+	}
 	/// Is checked?
 	bool isChecked() const;
 	/// Marks the node as checked.
@@ -63,7 +75,7 @@ public:
 	/// Gets the previous walking direction.
 	int getPrevDir() const;
 	/// Is this node already in a PathfindingOpenSet?
-	bool inOpenSet() const { return (_openentry != 0); }
+	bool inOpenSet() const { return _inOpen; }
 	/// Gets the approximate cost to reach the target position.
 	int getTUGuess() const { return _tuGuess; }
 
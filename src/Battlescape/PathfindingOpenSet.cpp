@@ -24,29 +24,50 @@ namespace OpenXcom
 {
 
 /**
- * Cleans up all the entries still in set.
+ * Sets up an empty set.
+ */
+PathfindingOpenSet::PathfindingOpenSet() : _current(0), _highest(0), _count(0)
+{
+}
+
+/**
+ * Cleans up the set. The nodes are owned by Pathfinding.
  */
 PathfindingOpenSet::~PathfindingOpenSet()
 {
-	while (!_queue.empty())
-	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
-	}
 }
 
 /**
- * Keeps removing all discarded entries that have come to the top of the queue.
+ * Empties all the buckets used by the last search.
+ * Nodes left in them are reset by Pathfinding when they are next used.
  */
-void PathfindingOpenSet::removeDiscarded()
+void PathfindingOpenSet::clear()
 {
-	while (!_queue.empty() && !_queue.top()->_node)
+	for (size_t i = 0; i <= _highest && i < _buckets.size(); ++i)
 	{
-		OpenSetEntry *entry = _queue.top();
-		_queue.pop();
-		delete entry;
+		_buckets[i] = 0;
 	}
+	_current = 0;
+	_highest = 0;
+	_count = 0;
+}
+
+/**
+ * Takes a node out of the bucket it is in.
+ * @param node A pointer to the node to remove.
+ */
+void PathfindingOpenSet::unlink(PathfindingNode *node)
+{
+	if (node->_openPrev)
+		node->_openPrev->_openNext = node->_openNext;
+	else
+		_buckets[node->_openKey] = node->_openNext;
+	if (node->_openNext)
+		node->_openNext->_openPrev = node->_openPrev;
+	node->_openPrev = 0;
+	node->_openNext = 0;
+	node->_inOpen = false;
+	--_count;
 }
 
 /**
@@ -57,33 +78,43 @@ void PathfindingOpenSet::removeDiscarded()
 PathfindingNode *PathfindingOpenSet::pop()
 {
 	assert(!empty());
-	OpenSetEntry *entry = _queue.top();
-	PathfindingNode *nd = entry->_node;
-	_queue.pop();
-	delete entry;
-	nd->_openentry = 0;
-
-	// Discarded entries might be visible now.
-	removeDiscarded();
+	while (!_buckets[_current])
+	{
+		++_current;
+	}
+	PathfindingNode *nd = _buckets[_current];
+	unlink(nd);
 	return nd;
 }
 
 /**
  * Places the node in the set.
- * If the node was already in the set, the previous entry is discarded.
+ * If the node was already in the set, it is moved to the bucket of its new cost.
  * It is the caller's responsibility to never re-add a node with a worse cost.
  * @param node A pointer to the node to add.
  */
 void PathfindingOpenSet::push(PathfindingNode *node)
 {
-	OpenSetEntry *entry = new OpenSetEntry;
-	entry->_node = node;
-	entry->_cost = node->getTUCost(false) + node->getTUGuess();
-	if (node->_openentry)
-		node->_openentry->_node = 0;
-	node->_openentry = entry;
-	_queue.push(entry);
+	if (node->_inOpen)
+		unlink(node);
+	size_t key = node->getTUCost(false) + node->getTUGuess();
+	if (key >= _buckets.size())
+	{
+		_buckets.resize(key + 1, 0);
+	}
+	node->_openKey = key;
+	node->_openPrev = 0;
+	node->_openNext = _buckets[key];
+	if (node->_openNext)
+		node->_openNext->_openPrev = node;
+	_buckets[key] = node;
+	node->_inOpen = true;
+	++_count;
+	// costs are not monotone (missiles, sneaking), so the scan restarts from the lowest pushed bucket
+	if (key < _current || _count == 1)
+		_current = key;
+	if (key > _highest)
+		_highest = key;
 }
 
-
 }
@@ -19,57 +19,42 @@
 #ifndef OPENXCOM_PATHFINDINGOPENSET_H
 #define OPENXCOM_PATHFINDINGOPENSET_H
 
-#include <queue>
+#include <vector>
+#include <cstddef>
 
 namespace OpenXcom
 {
 
 class PathfindingNode;
 
-struct OpenSetEntry
-{
-	int _cost;
-	PathfindingNode *_node;
-};
-
-/**
- * Helper class to compare entries through pointers.
- */
-class EntryCompare
-{
-public:
-	/**
-	 * Compares entries @a *a and @a *b.
-	 * @param a Pointer to first entry.
-	 * @param b Pointer to second entry.
-	 * @return True if entry @a *b must come before @a *a.
-	 */
-	bool operator()(OpenSetEntry *a, OpenSetEntry *b) const
-	{
-		return b->_cost < a->_cost;
-	}
-};
-
 /**
  * A class that holds references to the nodes to be examined in pathfinding.
+ * TU costs are small integers, so nodes are kept in one bucket per cost (a Dial queue),
+ * linked through invasive fields of the nodes themselves. Pushing, popping and
+ * lowering the cost of a node never allocate, and the buckets are reused between searches.
  */
 class PathfindingOpenSet
 {
 public:
-	/// Cleans up the set and frees allocated memory.
+	/// Creates an empty set.
+	PathfindingOpenSet();
+	/// Cleans up the set.
 	~PathfindingOpenSet();
 	/// Gets the next node to check.
 	PathfindingNode *pop();
 	/// Adds a node to the set.
 	void push(PathfindingNode *node);
 	/// Is the set empty?
-	bool empty() const { return _queue.empty(); }
+	bool empty() const { return _count == 0; }
+	/// Removes all nodes from the set.
+	void clear();
 
 private:
-	std::priority_queue<OpenSetEntry*, std::vector<OpenSetEntry*>, EntryCompare> _queue;
+	std::vector<PathfindingNode*> _buckets;
+	size_t _current, _highest, _count;
 
-	/// Removes reachable discarded entries.
-	void removeDiscarded();
+	/// Takes a node out of its bucket.
+	void unlink(PathfindingNode *node);
 };
 
 }
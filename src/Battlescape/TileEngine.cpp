@@ -21,6 +21,8 @@
 #include <cmath>
 #include <climits>
 #include <set>
+#include <algorithm>
+#include <iterator>
 #include <functional>
 #include "TileEngine.h"
 #include <SDL.h>
@@ -49,6 +51,7 @@
 #include "../Engine/Options.h"
 #include "ProjectileFlyBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
 #include "../fmath.h"
 
 namespace OpenXcom
@@ -61,7 +64,7 @@ const int TileEngine::heightFromCenter[11] = {0,-2,+2,-4,+4,-6,+6,-8,+8,-12,+12}
  * @param save Pointer to SavedBattleGame object.
  * @param voxelData List of voxel data.
  */
-TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true)
+TileEngine::TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData) : _save(save), _voxelData(voxelData), _personalLighting(true), _lightSourcesValid(false), _lightFalloffSize(0), _sightFanHeight(0), _sightGeneration(0)
 {
 }
 
@@ -73,6 +76,19 @@ TileEngine::~TileEngine()
 
 }
 
+/**
+ * Forgets everything cached about the map, so nothing
+ * carries over when a new one is set up in its place,
+ * like the second stage of a mission.
+ */
+void TileEngine::resetMap()
+{
+	_lightSources.clear();
+	_lightSourcesValid = false;
+	_viewerCones.clear();
+	_viewerCells.clear();
+}
+
 /**
   * Calculates sun shading for the whole terrain.
   */
@@ -80,9 +96,9 @@ void TileEngine::calculateSunShading()
 {
 	const int layer = 0; // Ambient lighting layer.
 
+	_save->getTileStore()->resetLight(layer);
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
-		_save->getTiles()[i]->resetLight(layer);
 		calculateSunShading(_save->getTiles()[i]);
 	}
 }
@@ -111,49 +127,103 @@ void TileEngine::calculateSunShading(Tile *tile)
 
 /**
   * Recalculates lighting for the terrain: objects,items,fire.
+  * The light sources are kept registered between calls, so only the regions
+  * around sources that appeared or disappeared since the last call are relit.
   */
 void TileEngine::calculateTerrainLighting()
 {
+	Profiler::Scope profile(Profiler::PHASE_LIGHTING);
 	const int layer = 1; // Static lighting layer.
 	const int fireLightPower = 15; // amount of light a fire generates
 
-	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
-
-	// add lighting of terrain
+	std::vector<LightSource> sources;
+	LightSource source;
 	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
 	{
+		Tile *tile = _save->getTiles()[i];
+		source.index = i;
 		// only floors and objects can light up
-		if (_save->getTiles()[i]->getMapData(MapData::O_FLOOR)
-			&& _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource())
+		if (tile->getMapData(MapData::O_FLOOR)
+			&& tile->getMapData(MapData::O_FLOOR)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_FLOOR)->getLightSource(), layer);
+			source.power = tile->getMapData(MapData::O_FLOOR)->getLightSource();
+			sources.push_back(source);
 		}
-		if (_save->getTiles()[i]->getMapData(MapData::O_OBJECT)
-			&& _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource())
+		if (tile->getMapData(MapData::O_OBJECT)
+			&& tile->getMapData(MapData::O_OBJECT)->getLightSource())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), _save->getTiles()[i]->getMapData(MapData::O_OBJECT)->getLightSource(), layer);
+			source.power = tile->getMapData(MapData::O_OBJECT)->getLightSource();
+			sources.push_back(source);
 		}
 
 		// fires
-		if (_save->getTiles()[i]->getFire())
+		if (tile->getFire())
 		{
-			addLight(_save->getTiles()[i]->getPosition(), fireLightPower, layer);
+			source.power = fireLightPower;
+			sources.push_back(source);
 		}
 
-		for (std::vector<BattleItem*>::iterator it = _save->getTiles()[i]->getInventory()->begin(); it != _save->getTiles()[i]->getInventory()->end(); ++it)
+		for (std::vector<BattleItem*>::iterator it = tile->getInventory()->begin(); it != tile->getInventory()->end(); ++it)
 		{
 			if ((*it)->getRules()->getBattleType() == BT_FLARE)
 			{
-				addLight(_save->getTiles()[i]->getPosition(), (*it)->getRules()->getPower(), layer);
+				source.power = (*it)->getRules()->getPower();
+				sources.push_back(source);
 			}
 		}
+	}
+	std::sort(sources.begin(), sources.end());
+
+	std::vector<LightSource> added, removed;
+	if (_lightSourcesValid)
+	{
+		std::set_difference(sources.begin(), sources.end(), _lightSources.begin(), _lightSources.end(), std::back_inserter(added));
+		std::set_difference(_lightSources.begin(), _lightSources.end(), sources.begin(), sources.end(), std::back_inserter(removed));
+	}
+	_lightSources.swap(sources);
 
+	const int maxX = _save->getMapSizeX() - 1;
+	const int maxY = _save->getMapSizeY() - 1;
+	if (!_lightSourcesValid || removed.size() + added.size() > _lightSources.size() / 2)
+	{
+		// reset all light to 0 first
+		_save->getTileStore()->resetLight(layer);
+		added = _lightSources;
+		removed.clear();
+		_lightSourcesValid = true;
 	}
 
+	// light only ever takes the brightest source, so a removed source means
+	// clearing its area and relighting it from the sources that reach into it
+	for (std::vector<LightSource>::const_iterator i = removed.begin(); i != removed.end(); ++i)
+	{
+		const Position &center = _save->getTiles()[i->index]->getPosition();
+		int x0 = std::max(0, center.x - i->power), x1 = std::min(maxX, center.x + i->power);
+		int y0 = std::max(0, center.y - i->power), y1 = std::min(maxY, center.y + i->power);
+		for (int z = 0; z < _save->getMapSizeZ(); ++z)
+		{
+			for (int y = y0; y <= y1; ++y)
+			{
+				for (int x = x0; x <= x1; ++x)
+				{
+					_save->getTile(Position(x, y, z))->resetLight(layer);
+				}
+			}
+		}
+		for (std::vector<LightSource>::const_iterator j = _lightSources.begin(); j != _lightSources.end(); ++j)
+		{
+			const Position &other = _save->getTiles()[j->index]->getPosition();
+			if (abs(other.x - center.x) <= i->power + j->power && abs(other.y - center.y) <= i->power + j->power)
+			{
+				applyLight(other, j->power, layer, x0, y0, x1, y1);
+			}
+		}
+	}
+
+	for (std::vector<LightSource>::const_iterator i = added.begin(); i != added.end(); ++i)
+	{
+		applyLight(_save->getTiles()[i->index]->getPosition(), i->power, layer, 0, 0, maxX, maxY);
+	}
 }
 
 /**
@@ -161,15 +231,13 @@ void TileEngine::calculateTerrainLighting()
   */
 void TileEngine::calculateUnitLighting()
 {
+	Profiler::Scope profile(Profiler::PHASE_LIGHTING);
 	const int layer = 2; // Dynamic lighting layer.
 	const int personalLightPower = 15; // amount of light a unit generates
 	const int fireLightPower = 15; // amount of light a fire generates
 
 	// reset all light to 0 first
-	for (int i = 0; i < _save->getMapSizeXYZ(); ++i)
-	{
-		_save->getTiles()[i]->resetLight(layer);
-	}
+	_save->getTileStore()->resetLight(layer);
 
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
@@ -194,26 +262,57 @@ void TileEngine::calculateUnitLighting()
  */
 void TileEngine::addLight(const Position &center, int power, int layer)
 {
-	// only loop through the positive quadrant.
-	for (int x = 0; x <= power; ++x)
+	applyLight(center, power, layer, 0, 0, _save->getMapSizeX() - 1, _save->getMapSizeY() - 1);
+}
+
+/**
+ * Applies the light pattern of a source to the tiles inside a box of the map, on all levels.
+ * The falloff only depends on the distance, so it is precomputed once as an integer stencil
+ * and the box is clipped against the light's reach before walking the tiles.
+ * @param center Center.
+ * @param power Power.
+ * @param layer Light is separated in 3 layers: Ambient, Static and Dynamic.
+ * @param minX Left edge of the box.
+ * @param minY Top edge of the box.
+ * @param maxX Right edge of the box.
+ * @param maxY Bottom edge of the box.
+ */
+void TileEngine::applyLight(const Position &center, int power, int layer, int minX, int minY, int maxX, int maxY)
+{
+	if (power <= 0)
+		return;
+	if (power + 1 > _lightFalloffSize)
 	{
-		for (int y = 0; y <= power; ++y)
+		_lightFalloffSize = power + 1;
+		_lightFalloff.resize(_lightFalloffSize * _lightFalloffSize);
+		for (int y = 0; y < _lightFalloffSize; ++y)
 		{
-			for (int z = 0; z < _save->getMapSizeZ(); z++)
+			for (int x = 0; x < _lightFalloffSize; ++x)
 			{
-				int distance = (int)Round(sqrt(float(x*x + y*y)));
-
-				if (_save->getTile(Position(center.x + x,center.y + y, z)))
-					_save->getTile(Position(center.x + x,center.y + y, z))->addLight(power - distance, layer);
-
-				if (_save->getTile(Position(center.x - x,center.y - y, z)))
-					_save->getTile(Position(center.x - x,center.y - y, z))->addLight(power - distance, layer);
+				_lightFalloff[y * _lightFalloffSize + x] = (int)Round(sqrt(float(x*x + y*y)));
+			}
+		}
+	}
 
-				if (_save->getTile(Position(center.x - x,center.y + y, z)))
-					_save->getTile(Position(center.x - x,center.y + y, z))->addLight(power - distance, layer);
+	minX = std::max(minX, center.x - power);
+	maxX = std::min(maxX, center.x + power);
+	minY = std::max(minY, center.y - power);
+	maxY = std::min(maxY, center.y + power);
+	if (minX > maxX || minY > maxY)
+		return;
 
-				if (_save->getTile(Position(center.x + x,center.y - y, z)))
-					_save->getTile(Position(center.x + x,center.y - y, z))->addLight(power - distance, layer);
+	const int sizeX = _save->getMapSizeX();
+	const int levelSize = sizeX * _save->getMapSizeY();
+	Tile **tiles = _save->getTiles();
+	for (int y = minY; y <= maxY; ++y)
+	{
+		const int *falloff = &_lightFalloff[abs(y - center.y) * _lightFalloffSize];
+		for (int x = minX; x <= maxX; ++x)
+		{
+			const int light = power - falloff[abs(x - center.x)];
+			for (int index = y * sizeX + x; index < _save->getMapSizeXYZ(); index += levelSize)
+			{
+				tiles[index]->addLight(light, layer);
 			}
 		}
 	}
@@ -226,20 +325,12 @@ void TileEngine::addLight(const Position &center, int power, int layer)
  */
 bool TileEngine::calculateFOV(BattleUnit *unit)
 {
+	Profiler::Scope profile(Profiler::PHASE_FOV);
 	size_t oldNumVisibleUnits = unit->getUnitsSpottedThisTurn().size();
 	Position center = unit->getPosition();
 	Position test;
-	int direction;
-	bool swap;
-	std::vector<Position> _trajectory;
-	if (Options::strafe && (unit->getTurretType() > -1)) {
-		direction = unit->getTurretDirection();
-	}
-	else
-	{
-		direction = unit->getDirection();
-	}
-	swap = (direction==0 || direction==4);
+	int direction = getViewDirection(unit);
+	bool swap = (direction==0 || direction==4);
 	int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
 	int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
 	int y1, y2;
@@ -248,13 +339,23 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 	unit->clearVisibleTiles();
 
 	if (unit->isOut())
+	{
+		unregisterViewer(unit);
 		return false;
+	}
+	registerViewer(unit, center, direction);
 	Position pos = unit->getPosition();
 
 	if ((unit->getHeight() + unit->getFloatHeight() + -_save->getTile(unit->getPosition())->getTerrainLevel()) >= 24 + 4)
 	{
 		++pos.z;
 	}
+	// tiles in the view cone, revealed afterwards from every pair of eyes
+	std::vector<Position> targets;
+	if (unit->getFaction() == FACTION_PLAYER && _sightFanHeight != _save->getMapSizeZ())
+	{
+		buildSightFan(_save->getMapSizeZ());
+	}
 	for (int x = 0; x <= MAX_VIEW_DISTANCE; ++x)
 	{
 		if (direction%2)
@@ -302,34 +403,7 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 						if (unit->getFaction() == FACTION_PLAYER)
 						{
-							// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
-							// large units have "4 pair of eyes"
-							int size = unit->getArmor()->getSize();
-							for (int xo = 0; xo < size; xo++)
-							{
-								for (int yo = 0; yo < size; yo++)
-								{
-									Position poso = pos + Position(xo,yo,0);
-									_trajectory.clear();
-									int tst = calculateLine(poso, test, true, &_trajectory, unit, false);
-									size_t tsize = _trajectory.size();
-									if (tst>127) --tsize; //last tile is blocked thus must be cropped
-									for (size_t i = 0; i < tsize; i++)
-									{
-										Position posi = _trajectory.at(i); 
-										//mark every tile of line as visible (as in original)
-										//this is needed because of bresenham narrow stroke. 
-										_save->getTile(posi)->setVisible(+1);
-										_save->getTile(posi)->setDiscovered(true, 2);
-										// walls to the east or south of a visible tile, we see that too
-										Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
-										if (t) t->setDiscovered(true, 0);
-										t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
-										if (t) t->setDiscovered(true, 1);
-									}
-
-								}
-							}
+							targets.push_back(test);
 						}
 					}
 				}
@@ -337,6 +411,31 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 		}
 	}
 
+	if (unit->getFaction() == FACTION_PLAYER)
+	{
+		// this sets tiles to discovered if they are in LOS - tile visibility is not calculated in voxelspace but in tilespace
+		// large units have "4 pair of eyes"
+		int size = unit->getArmor()->getSize();
+		for (int xo = 0; xo < size; xo++)
+		{
+			for (int yo = 0; yo < size; yo++)
+			{
+				Position poso = pos + Position(xo,yo,0);
+				// every pair of eyes traces its own fan, lines sharing a prefix are only traced once
+				if (++_sightGeneration == INT_MAX)
+				{
+					std::fill(_sightStamp.begin(), _sightStamp.end(), 0);
+					std::fill(_sightRevealed.begin(), _sightRevealed.end(), 0);
+					_sightGeneration = 1;
+				}
+				for (std::vector<Position>::const_iterator i = targets.begin(); i != targets.end(); ++i)
+				{
+					revealSightLine(poso, *i);
+				}
+			}
+		}
+	}
+
 	// we only react when there are at least the same amount of visible units as before AND the checksum is different
 	// this way we stop if there are the same amount of visible units, but a different unit is seen
 	// or we stop if there are more visible units seen
@@ -349,6 +448,192 @@ bool TileEngine::calculateFOV(BattleUnit *unit)
 
 }
 
+/**
+ * Builds the fan of tile-space sight lines used to reveal terrain.
+ * Every line from the eye to a tile within view distance is stepped exactly like
+ * calculateLine does, and lines are merged into a tree on their common prefixes,
+ * so a tile shared by many lines only has its blockage checked once per eye.
+ * @param height Height of the map, limits the vertical reach of the lines.
+ */
+void TileEngine::buildSightFan(int height)
+{
+	const int side = SIGHT_FAN_REACH * 2 + 1;
+	std::vector<int> children;
+	_sightFanHeight = height;
+	_sightNodes.clear();
+	_sightLineEnd.assign(side * side * (height * 2 + 1), -1);
+
+	SightNode root;
+	root.parent = -1;
+	_sightNodes.push_back(root);
+	children.resize(27, -1);
+
+	for (int tz = -height; tz <= height; ++tz)
+	{
+		for (int ty = -SIGHT_FAN_REACH; ty <= SIGHT_FAN_REACH; ++ty)
+		{
+			for (int tx = -SIGHT_FAN_REACH; tx <= SIGHT_FAN_REACH; ++tx)
+			{
+				// same stepping as calculateLine, which only depends on the deltas
+				int x0 = 0, y0 = 0, z0 = 0;
+				int x1 = tx, y1 = ty, z1 = tz;
+				bool swap_xy = abs(y1 - y0) > abs(x1 - x0);
+				if (swap_xy)
+				{
+					std::swap(x0, y0);
+					std::swap(x1, y1);
+				}
+				bool swap_xz = abs(z1 - z0) > abs(x1 - x0);
+				if (swap_xz)
+				{
+					std::swap(x0, z0);
+					std::swap(x1, z1);
+				}
+				int delta_x = abs(x1 - x0);
+				int delta_y = abs(y1 - y0);
+				int delta_z = abs(z1 - z0);
+				int drift_xy = (delta_x / 2);
+				int drift_xz = (delta_x / 2);
+				int step_x = x0 > x1 ? -1 : 1;
+				int step_y = y0 > y1 ? -1 : 1;
+				int step_z = z0 > z1 ? -1 : 1;
+				int y = y0, z = z0;
+				int node = 0;
+
+				for (int x = x0 + step_x; x != (x1 + step_x); x += step_x)
+				{
+					drift_xy = drift_xy - delta_y;
+					drift_xz = drift_xz - delta_z;
+					if (drift_xy < 0)
+					{
+						y = y + step_y;
+						drift_xy = drift_xy + delta_x;
+					}
+					if (drift_xz < 0)
+					{
+						z = z + step_z;
+						drift_xz = drift_xz + delta_x;
+					}
+					int cx = x, cy = y, cz = z;
+					if (swap_xz) std::swap(cx, cz);
+					if (swap_xy) std::swap(cx, cy);
+
+					const Position &from = _sightNodes[node].offset;
+					int slot = node * 27 + (cx - from.x + 1) + (cy - from.y + 1) * 3 + (cz - from.z + 1) * 9;
+					if (children[slot] == -1)
+					{
+						SightNode child;
+						child.offset = Position(cx, cy, cz);
+						child.parent = node;
+						children[slot] = _sightNodes.size();
+						_sightNodes.push_back(child);
+						children.resize(_sightNodes.size() * 27, -1);
+					}
+					node = children[slot];
+				}
+				_sightLineEnd[getSightLineIndex(Position(tx, ty, tz))] = node;
+			}
+		}
+	}
+
+	_sightState.assign(_sightNodes.size(), 0);
+	_sightKept.assign(_sightNodes.size(), -1);
+	_sightStamp.assign(_sightNodes.size(), 0);
+	_sightRevealed.assign(_sightNodes.size(), 0);
+	_sightGeneration = 0;
+}
+
+/**
+ * Gets the index of the sight line ending at a given offset from the eye.
+ * @param offset Offset of the target tile.
+ * @return Index into the line table, or -1 when out of sight range.
+ */
+int TileEngine::getSightLineIndex(const Position &offset) const
+{
+	const int side = SIGHT_FAN_REACH * 2 + 1;
+	if (abs(offset.x) > SIGHT_FAN_REACH || abs(offset.y) > SIGHT_FAN_REACH || abs(offset.z) > _sightFanHeight)
+		return -1;
+	return ((offset.z + _sightFanHeight) * side + offset.y + SIGHT_FAN_REACH) * side + offset.x + SIGHT_FAN_REACH;
+}
+
+/**
+ * Traces one node of the sight fan, with the same blockage rules as calculateLine without voxel checks.
+ * Results are cached for the current generation, so shared prefixes are traced only once.
+ * @param origin The eye position.
+ * @param node The node to trace.
+ * @return The state of the node: 0 open, 1 big wall (seen but stops the line), 2 blocked, 3 never reached.
+ */
+int TileEngine::traceSightNode(const Position &origin, int node)
+{
+	if (_sightStamp[node] == _sightGeneration)
+		return _sightState[node];
+
+	const SightNode &sight = _sightNodes[node];
+	int state = 3;
+	int kept = -1;
+	if (sight.parent == -1 || traceSightNode(origin, sight.parent) == 0)
+	{
+		Position previous = origin + (sight.parent == -1 ? sight.offset : _sightNodes[sight.parent].offset);
+		Tile *startTile = _save->getTile(previous);
+		Tile *endTile = _save->getTile(origin + sight.offset);
+		int vertical = verticalBlockage(startTile, endTile, DT_NONE);
+		int horizontal = horizontalBlockage(startTile, endTile, DT_NONE);
+		if (horizontal == -1 && vertical <= 127)
+		{
+			state = 1;
+		}
+		else
+		{
+			if (horizontal == -1)
+				horizontal = 0;
+			state = (horizontal + vertical > 127) ? 2 : 0;
+		}
+		kept = (state == 2) ? sight.parent : node;
+	}
+	else
+	{
+		kept = _sightKept[sight.parent];
+	}
+
+	_sightStamp[node] = _sightGeneration;
+	_sightState[node] = state;
+	_sightKept[node] = kept;
+	return state;
+}
+
+/**
+ * Marks the tiles of a sight line as visible and discovered, up to the point where it gets blocked.
+ * @param origin The eye position.
+ * @param target The tile being looked at.
+ */
+void TileEngine::revealSightLine(const Position &origin, const Position &target)
+{
+	int index = getSightLineIndex(target - origin);
+	if (index == -1 || _sightLineEnd[index] == -1)
+		return;
+	int node = _sightLineEnd[index];
+	traceSightNode(origin, node);
+
+	// ancestors of an already revealed node have been revealed as well
+	for (node = _sightKept[node]; node != -1 && _sightRevealed[node] != _sightGeneration; node = _sightNodes[node].parent)
+	{
+		_sightRevealed[node] = _sightGeneration;
+		Position posi = origin + _sightNodes[node].offset;
+		Tile *tile = _save->getTile(posi);
+		if (!tile)
+			continue;
+		//mark every tile of line as visible (as in original)
+		//this is needed because of bresenham narrow stroke.
+		tile->setVisible(+1);
+		tile->setDiscovered(true, 2);
+		// walls to the east or south of a visible tile, we see that too
+		Tile* t = _save->getTile(Position(posi.x + 1, posi.y, posi.z));
+		if (t) t->setDiscovered(true, 0);
+		t = _save->getTile(Position(posi.x, posi.y + 1, posi.z));
+		if (t) t->setDiscovered(true, 1);
+	}
+}
+
 /**
  * Gets the origin voxel of a unit's eyesight (from just one eye or something? Why is it x+7??
  * @param currentUnit The watcher.
@@ -751,21 +1036,170 @@ bool TileEngine::canTargetTile(Position *originVoxel, Tile *tile, int part, Posi
 }
 
 /**
- * Calculates line of sight of a soldiers within range of the Position
+ * Calculates line of sight of the units looking at a region around the Position
  * (used when terrain has changed, which can reveal new parts of terrain or units).
+ * Only units whose last view cone covers the region are traced again,
+ * units that moved or turned since their last calculation fall back to a range check.
  * @param position Position of the changed terrain.
+ * @param radius Radius of the changed region, in tiles.
  */
-void TileEngine::calculateFOV(const Position &position)
+void TileEngine::calculateFOV(const Position &position, int radius)
 {
+	Profiler::Scope profile(Profiler::PHASE_FOV);
+	// blockage checks also look at the tiles next to the line, so widen the region by one
+	int minX = std::max(0, position.x - radius - 1), maxX = std::min(_save->getMapSizeX() - 1, position.x + radius + 1);
+	int minY = std::max(0, position.y - radius - 1), maxY = std::min(_save->getMapSizeY() - 1, position.y + radius + 1);
+	std::set<BattleUnit*> viewers;
+
+	if (!_viewerCells.empty() && minX <= maxX && minY <= maxY)
+	{
+		const int cellsX = (_save->getMapSizeX() + FOV_CELL_SIZE - 1) / FOV_CELL_SIZE;
+		for (int cy = minY / FOV_CELL_SIZE; cy <= maxY / FOV_CELL_SIZE; ++cy)
+		{
+			for (int cx = minX / FOV_CELL_SIZE; cx <= maxX / FOV_CELL_SIZE; ++cx)
+			{
+				std::vector<BattleUnit*> &cell = _viewerCells[cy * cellsX + cx];
+				for (std::vector<BattleUnit*>::iterator i = cell.begin(); i != cell.end(); ++i)
+				{
+					if (viewers.find(*i) != viewers.end())
+						continue;
+					const ViewerCone &cone = _viewerCones[*i];
+					bool covered = false;
+					for (int x = minX; x <= maxX && !covered; ++x)
+					{
+						for (int y = minY; y <= maxY && !covered; ++y)
+						{
+							covered = inViewCone(cone.position, cone.direction, x, y);
+						}
+					}
+					if (covered)
+					{
+						viewers.insert(*i);
+					}
+				}
+			}
+		}
+	}
+
 	for (std::vector<BattleUnit*>::iterator i = _save->getUnits()->begin(); i != _save->getUnits()->end(); ++i)
 	{
-		if (distance(position, (*i)->getPosition()) < MAX_VIEW_DISTANCE)
+		std::map<BattleUnit*, ViewerCone>::const_iterator cone = _viewerCones.find(*i);
+		bool stale = (cone == _viewerCones.end() || cone->second.position != (*i)->getPosition() || cone->second.direction != getViewDirection(*i));
+		if (stale ? distance(position, (*i)->getPosition()) < MAX_VIEW_DISTANCE + radius : viewers.find(*i) != viewers.end())
 		{
 			calculateFOV(*i);
 		}
 	}
 }
 
+/**
+ * Gets the direction a unit is looking in, which is the turret direction for strafing tanks.
+ * @param unit The unit.
+ * @return Direction.
+ */
+int TileEngine::getViewDirection(BattleUnit *unit) const
+{
+	if (Options::strafe && (unit->getTurretType() > -1))
+	{
+		return unit->getTurretDirection();
+	}
+	return unit->getDirection();
+}
+
+/**
+ * Checks if a tile column is one of those calculateFOV looks at.
+ * @param center Position of the viewer.
+ * @param direction Direction the viewer is looking in.
+ * @param x X coordinate of the column.
+ * @param y Y coordinate of the column.
+ * @return True if the column is inside the view cone.
+ */
+bool TileEngine::inViewCone(const Position &center, int direction, int x, int y) const
+{
+	static const int signX[8] = { +1, +1, +1, +1, -1, -1, -1, -1 };
+	static const int signY[8] = { -1, -1, -1, +1, +1, +1, -1, -1 };
+	bool swap = (direction==0 || direction==4);
+	int dx = (x - center.x) * signX[direction];
+	int dy = (y - center.y) * signY[direction];
+	if (swap)
+	{
+		std::swap(dx, dy);
+	}
+	if (dx < 0 || dx > MAX_VIEW_DISTANCE || dx*dx + dy*dy > MAX_VIEW_DISTANCE*MAX_VIEW_DISTANCE)
+		return false;
+	if (direction%2)
+		return dy >= 0;
+	return dy >= -dx && dy <= dx;
+}
+
+/**
+ * Stores the view cone of a unit and indexes it by the map cells it covers,
+ * so changes to the terrain only have to trace the units that can be affected.
+ * @param unit The viewer.
+ * @param center Position of the viewer.
+ * @param direction Direction the viewer is looking in.
+ */
+void TileEngine::registerViewer(BattleUnit *unit, const Position &center, int direction)
+{
+	const int cellsX = (_save->getMapSizeX() + FOV_CELL_SIZE - 1) / FOV_CELL_SIZE;
+	const int cellsY = (_save->getMapSizeY() + FOV_CELL_SIZE - 1) / FOV_CELL_SIZE;
+	if (_viewerCells.size() != (size_t)(cellsX * cellsY))
+	{
+		// the index belongs to another map, start it over
+		_viewerCones.clear();
+		_viewerCells.clear();
+		_viewerCells.resize(cellsX * cellsY);
+	}
+
+	ViewerCone &cone = _viewerCones[unit];
+	if (!cone.cells.empty() && cone.position == center && cone.direction == direction)
+		return;
+	unregisterViewer(unit);
+	ViewerCone &fresh = _viewerCones[unit];
+	fresh.position = center;
+	fresh.direction = direction;
+
+	int minX = std::max(0, center.x - MAX_VIEW_DISTANCE), maxX = std::min(_save->getMapSizeX() - 1, center.x + MAX_VIEW_DISTANCE);
+	int minY = std::max(0, center.y - MAX_VIEW_DISTANCE), maxY = std::min(_save->getMapSizeY() - 1, center.y + MAX_VIEW_DISTANCE);
+	for (int cy = minY / FOV_CELL_SIZE; cy <= maxY / FOV_CELL_SIZE; ++cy)
+	{
+		for (int cx = minX / FOV_CELL_SIZE; cx <= maxX / FOV_CELL_SIZE; ++cx)
+		{
+			// keep the cell if any of its columns, or their neighbours, is inside the cone
+			bool covered = false;
+			for (int x = cx * FOV_CELL_SIZE - 1; x <= (cx + 1) * FOV_CELL_SIZE && !covered; ++x)
+			{
+				for (int y = cy * FOV_CELL_SIZE - 1; y <= (cy + 1) * FOV_CELL_SIZE && !covered; ++y)
+				{
+					covered = inViewCone(center, direction, x, y);
+				}
+			}
+			if (covered)
+			{
+				fresh.cells.push_back(cy * cellsX + cx);
+				_viewerCells[cy * cellsX + cx].push_back(unit);
+			}
+		}
+	}
+}
+
+/**
+ * Removes a unit from the view cone index, its field of view is then always recalculated.
+ * @param unit The viewer.
+ */
+void TileEngine::unregisterViewer(BattleUnit *unit)
+{
+	std::map<BattleUnit*, ViewerCone>::iterator cone = _viewerCones.find(unit);
+	if (cone == _viewerCones.end())
+		return;
+	for (std::vector<int>::iterator i = cone->second.cells.begin(); i != cone->second.cells.end(); ++i)
+	{
+		std::vector<BattleUnit*> &cell = _viewerCells[*i];
+		cell.erase(std::remove(cell.begin(), cell.end(), unit), cell.end());
+	}
+	_viewerCones.erase(cone);
+}
+
 /**
  * Checks if a sniper from the opposing faction sees this unit. The unit with the highest reaction score will be compared with the current unit's reaction score.
  * If it's higher, a shot is fired when enough time units, a weapon and ammo are available.
@@ -774,6 +1208,7 @@ void TileEngine::calculateFOV(const Position &position)
  */
 bool TileEngine::checkReactionFire(BattleUnit *unit)
 {
+	Profiler::Scope profile(Profiler::PHASE_REACTION_FIRE);
 	// reaction fire only triggered when the actioning unit is of the currently playing side, and is still on the map (alive)
 	if (unit->getFaction() != _save->getSide() || unit->getTile() == 0)
 	{
@@ -1104,6 +1539,7 @@ BattleUnit *TileEngine::hit(const Position &center, int power, ItemDamageType ty
  */
 void TileEngine::explode(const Position &center, int power, ItemDamageType type, int maxRadius, BattleUnit *unit)
 {
+	Profiler::Scope profile(Profiler::PHASE_EXPLOSIONS);
 	double centerZ = center.z / 24 + 0.5;
 	double centerX = center.x / 16 + 0.5;
 	double centerY = center.y / 16 + 0.5;
@@ -1331,7 +1767,7 @@ void TileEngine::explode(const Position &center, int power, ItemDamageType type,
 
 	calculateSunShading(); // roofs could have been destroyed
 	calculateTerrainLighting(); // fires could have been started
-	calculateFOV(center / Position(16,16,24));
+	calculateFOV(center / Position(16,16,24), maxRadius + 1);
 }
 
 /**
@@ -1396,6 +1832,7 @@ bool TileEngine::detonate(Tile* tile)
 						{
 							objective = true;
 						}
+						_save->getPathfinding()->invalidateReachMaps();
 						if (tiles[i]->getMapData(parts[i]))
 						{
 							flam = tiles[i]->getFlammability();
@@ -1928,7 +2365,8 @@ int TileEngine::unitOpensDoor(BattleUnit *unit, bool rClick, int dir)
 		{
 			if (unit->spendTimeUnits(TUCost))
 			{
-				calculateFOV(unit->getPosition());
+				calculateFOV(unit->getPosition(), 4); // adjacent ufo doors open along with this one
+				_save->getPathfinding()->invalidateReachMaps();
 				// look from the other side (may be need check reaction fire?)
 				std::vector<BattleUnit*> *vunits = unit->getVisibleUnits();
 				for (size_t i = 0; i < vunits->size(); ++i)
@@ -2001,6 +2439,10 @@ int TileEngine::closeUfoDoors()
 		}
 		doorsclosed += _save->getTiles()[i]->closeUfoDoor();
 	}
+	if (doorsclosed)
+	{
+		_save->getPathfinding()->invalidateReachMaps();
+	}
 
 	return doorsclosed;
 }
@@ -2738,6 +3180,7 @@ bool TileEngine::validateThrow(BattleAction &action, Position originVoxel, Posit
  */
 void TileEngine::recalculateFOV()
 {
+	Profiler::Scope profile(Profiler::PHASE_FOV);
 	for (std::vector<BattleUnit*>::iterator bu = _save->getUnits()->begin(); bu != _save->getUnits()->end(); ++bu)
 	{
 		if ((*bu)->getTile() != 0)
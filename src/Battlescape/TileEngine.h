@@ -20,6 +20,7 @@
 #define OPENXCOM_TILEENGINE_H
 
 #include <vector>
+#include <map>
 #include "Position.h"
 #include "../Ruleset/RuleItem.h"
 #include <SDL.h>
@@ -43,25 +44,77 @@ private:
 	static const int MAX_VIEW_DISTANCE = 20;
 	static const int MAX_VOXEL_VIEW_DISTANCE = MAX_VIEW_DISTANCE * 16;
 	static const int MAX_DARKNESS_TO_SEE_UNITS = 9;
+	static const int SIGHT_FAN_REACH = MAX_VIEW_DISTANCE + 1; // large units look from one tile further
 	SavedBattleGame *_save;
 	std::vector<Uint16> *_voxelData;
 	static const int heightFromCenter[11];
 	void addLight(const Position &center, int power, int layer);
 	int blockage(Tile *tile, const int part, ItemDamageType type, int direction = -1, bool checkingFromOrigin = false);
 	bool _personalLighting;
+	/// A terrain light source (lit floor or object, fire, flare) registered in the static lighting layer.
+	struct LightSource
+	{
+		int index, power;
+		bool operator<(const LightSource &other) const { return index < other.index || (index == other.index && power < other.power); }
+		bool operator==(const LightSource &other) const { return index == other.index && power == other.power; }
+	};
+	std::vector<LightSource> _lightSources;
+	bool _lightSourcesValid;
+	std::vector<int> _lightFalloff;
+	int _lightFalloffSize;
+	/// Applies the falloff stencil of a light, clipped to a box of the map.
+	void applyLight(const Position &center, int power, int layer, int minX, int minY, int maxX, int maxY);
+	/// A step of a precomputed tile-space sight line, shared by every line with the same prefix.
+	struct SightNode
+	{
+		Position offset;
+		int parent;
+	};
+	std::vector<SightNode> _sightNodes;
+	std::vector<int> _sightLineEnd, _sightStamp, _sightKept, _sightRevealed;
+	std::vector<Uint8> _sightState;
+	int _sightFanHeight, _sightGeneration;
+	/// Builds the fan of sight lines used for terrain visibility.
+	void buildSightFan(int height);
+	/// Gets the index of a sight line offset in the fan.
+	int getSightLineIndex(const Position &offset) const;
+	/// Traces a sight line node from an origin, reusing already traced prefixes.
+	int traceSightNode(const Position &origin, int node);
+	/// Reveals the visible part of a sight line from an origin.
+	void revealSightLine(const Position &origin, const Position &target);
+	static const int FOV_CELL_SIZE = 4;
+	/// The view cone a unit's field of view was last calculated with.
+	struct ViewerCone
+	{
+		Position position;
+		int direction;
+		std::vector<int> cells;
+	};
+	std::map<BattleUnit*, ViewerCone> _viewerCones;
+	std::vector< std::vector<BattleUnit*> > _viewerCells;
+	/// Gets the direction a unit is looking in.
+	int getViewDirection(BattleUnit *unit) const;
+	/// Checks if a tile column lies inside a view cone.
+	bool inViewCone(const Position &center, int direction, int x, int y) const;
+	/// Registers the view cone of a unit in the spatial index.
+	void registerViewer(BattleUnit *unit, const Position &center, int direction);
+	/// Removes a unit from the spatial index.
+	void unregisterViewer(BattleUnit *unit);
 public:
 	/// Creates a new TileEngine class.
 	TileEngine(SavedBattleGame *save, std::vector<Uint16> *voxelData);
 	/// Cleans up the TileEngine.
 	~TileEngine();
+	/// Forgets everything cached about the previous map.
+	void resetMap();
 	/// Calculates sun shading of the whole map.
 	void calculateSunShading();
 	/// Calculates sun shading of a single tile.
 	void calculateSunShading(Tile *tile);
 	/// Calculates the field of view from a units view point.
 	bool calculateFOV(BattleUnit *unit);
-	/// Calculates the field of view within range of a certain position.
-	void calculateFOV(const Position &position);
+	/// Recalculates the field of view of units looking at a region around a certain position.
+	void calculateFOV(const Position &position, int radius = 1);
 	/// Checks reaction fire.
 	bool checkReactionFire(BattleUnit *unit);
 	/// Recalculates lighting of the battlescape for terrain.
@@ -19,6 +19,7 @@
 
 #include "UnitDieBState.h"
 #include "ExplosionBState.h"
+#include "Pathfinding.h"
 #include "TileEngine.h"
 #include "BattlescapeState.h"
 #include "Map.h"
@@ -220,6 +221,7 @@ void UnitDieBState::cancel()
 void UnitDieBState::convertUnitToCorpse()
 {
 	_parent->getSave()->getBattleState()->showPsiButton(false);
+	_parent->getPathfinding()->invalidateReachMaps();
 	Position lastPosition = _unit->getPosition();
 	// remove the unconscious body item corresponding to this unit, and if it was being carried, keep track of what slot it was in
 	if (lastPosition != Position(-1,-1,-1))
@@ -167,6 +167,7 @@ void UnitFallBState::think()
 					_parent->getSave()->getTile((*unit)->getPosition() + Position(x,y,0))->setUnit((*unit), _parent->getSave()->getTile((*unit)->getPosition() + Position(x,y,-1)));
 				}
 			}
+			_parent->getPathfinding()->invalidateReachMaps();
 
 			// Find somewhere to move the unit(s) endanger of being squashed.
 			if (!unitsToMove.empty())
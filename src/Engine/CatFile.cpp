@@ -18,40 +18,44 @@
  */
 
 #include "CatFile.h"
+#include <algorithm>
+#include <cstring>
 #include <SDL.h>
 
 namespace OpenXcom
 {
 
 /**
- * Creates a CAT file stream. A CAT file starts with an index of the
+ * Opens a CAT file. A CAT file starts with an index of the
  * offset and size of every file contained within. Each file consists
  * of a filename followed by its contents.
  * @param path Full path to CAT file.
  */
-CatFile::CatFile(const char *path) : std::ifstream(path, std::ios::in | std::ios::binary), _amount(0), _offset(0), _size(0)
+CatFile::CatFile(const char *path) : _file(path), _amount(0), _offset(0), _size(0)
 {
-	if (!this)
+	if (!_file || _file.getSize() < sizeof(_amount))
 		return;
 
-	
-	// Get amount of files
-	read((char*)&_amount, sizeof(_amount));
+	const Uint8 *data = _file.getData();
 
+	// Get amount of files
+	memcpy(&_amount, data, sizeof(_amount));
 	_amount = (unsigned int)SDL_SwapLE32(_amount);
 	_amount /= 2 * sizeof(_amount);
+	if (_amount > _file.getSize() / (2 * sizeof(_amount)))
+	{
+		_amount = _file.getSize() / (2 * sizeof(_amount));
+	}
 
 	// Get object offsets
-	seekg(0, std::ios::beg);
-
 	_offset = new unsigned int[_amount];
 	_size   = new unsigned int[_amount];
 
 	for (unsigned int i = 0; i < _amount; ++i)
 	{
-		read((char*)&_offset[i], sizeof(*_offset));
+		memcpy(&_offset[i], data + i * 2 * sizeof(_amount), sizeof(*_offset));
 		_offset[i] = (unsigned int)SDL_SwapLE32(_offset[i]);
-		read((char*)&_size[i],   sizeof(*_size));
+		memcpy(&_size[i], data + i * 2 * sizeof(_amount) + sizeof(*_offset), sizeof(*_size));
 		_size[i] = (unsigned int)SDL_SwapLE32(_size[i]);
 	}
 }
@@ -63,12 +67,34 @@ CatFile::~CatFile()
 {
 	delete[] _offset;
 	delete[] _size;
+}
 
-	close();
+/**
+ * Returns an object's contents straight from the mapped
+ * file, without its internal file name. The data stays
+ * valid as long as the CAT file is open.
+ * @param i Object number.
+ * @return Pointer to the object, or 0 if it's not in the file.
+ */
+const Uint8 *CatFile::getObject(unsigned int i) const
+{
+	if (i >= _amount || _offset[i] >= _file.getSize())
+		return 0;
+
+	size_t offset = _offset[i];
+	unsigned char namesize = _file.getData()[offset];
+	// Skip filename (if there's any)
+	if (namesize <= 56)
+	{
+		offset += namesize + 1;
+	}
+	if (offset + _size[i] > _file.getSize())
+		return 0;
+	return _file.getData() + offset;
 }
 
 /**
- * Loads an object into memory.
+ * Loads a copy of an object into memory.
  * @param i Object number to load.
  * @param name Preserve internal file name.
  * @return Pointer to the loaded object.
@@ -78,15 +104,15 @@ char *CatFile::load(unsigned int i, bool name)
 	if (i >= _amount)
 		return 0;
 
-	seekg(_offset[i], std::ios::beg);
+	size_t offset = std::min((size_t)_offset[i], _file.getSize());
 
-	unsigned char namesize = peek();
+	unsigned char namesize = offset < _file.getSize() ? _file.getData()[offset] : 0xFF;
 	// Skip filename (if there's any)
 	if (namesize<=56)
 	{
 		if (!name)
 		{
-			seekg(namesize + 1, std::ios::cur);
+			offset = std::min(offset + namesize + 1, _file.getSize());
 		}
 		else
 		{
@@ -96,7 +122,9 @@ char *CatFile::load(unsigned int i, bool name)
 
 	// Read object
 	char *object = new char[_size[i]];
-	read(object, _size[i]);
+	size_t available = std::min((size_t)_size[i], _file.getSize() - offset);
+	memcpy(object, _file.getData() + offset, available);
+	memset(object + available, 0, _size[i] - available);
 
 	return object;
 }
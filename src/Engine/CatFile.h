@@ -20,27 +20,29 @@
 #ifndef OPENXCOM_CATFILE_H
 #define OPENXCOM_CATFILE_H
 
-#include <fstream>
+#include "FileMap.h"
 
 namespace OpenXcom
 {
 
 /**
- * Subclass of std::ifstream to handle CAT files
+ * Handles CAT files, kept mapped in memory
+ * so objects can be read straight from them.
  */
-class CatFile : protected std::ifstream
+class CatFile
 {
 private:
+	FileMap _file;
 	unsigned int _amount, *_offset, *_size;
 public:
-	/// Creates a CAT file stream.
+	/// Creates a CAT file.
 	CatFile(const char *path);
-	/// Cleans up the stream.
+	/// Cleans up the file.
 	~CatFile();
-	/// Inherit operator.
+	/// Checks if the file couldn't be opened.
 	bool operator !() const
 	{
-		return std::ifstream::operator!();
+		return !_file;
 	}
 	/// Get amount of objects.
 	int getAmount() const
@@ -52,6 +54,8 @@ public:
 	{
 		return (i < _amount) ? _size[i] : 0;
 	}
+	/// Gets an object straight from the file.
+	const Uint8 *getObject(unsigned int i) const;
 	/// Load an object into memory.
 	char *load(unsigned int i, bool name = false);
 };
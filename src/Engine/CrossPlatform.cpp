@@ -18,6 +18,7 @@
  */
 #include "CrossPlatform.h"
 #include <set>
+#include <map>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -52,6 +53,8 @@
 #include <cstdio>
 #include <cstdlib>
 #include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
 #include <sys/param.h>
 #include <sys/types.h>
 #include <pwd.h>
@@ -299,116 +302,171 @@ std::string findConfigFolder()
 #endif
 }
 
+/// Real paths of every data file, by lowercase relative path.
+static std::map<std::string, std::string> _dataFiles;
+/// Real paths of every data folder, by lowercase relative path.
+static std::map<std::string, std::string> _dataFolders;
+/// Have the data folders been indexed?
+static bool _dataIndexed = false;
+
 /**
- * Takes a path and tries to find it based on the
- * system's case-sensitivity.
- * @param base Base unaltered path.
- * @param path Full path to check for casing.
- * @return Correct filename or "" if it doesn't exist.
- * @note There's no actual method for figuring out the correct
- * filename on case-sensitive systems, this is just a workaround.
+ * Turns a path relative to the Data folder into
+ * the key it's indexed under: lowercase, with
+ * forward slashes and no trailing slash.
+ * @param path Relative path.
+ * @return Index key.
  */
-std::string caseInsensitive(const std::string &base, const std::string &path)
+static std::string dataKey(const std::string &path)
 {
-	std::string fullPath = base + path, newPath = path;
-
-	// Try all various case mutations
-	// Normal unmangled
-	if (fileExists(fullPath.c_str()))
+	std::string key = path;
+	std::replace(key.begin(), key.end(), '\\', '/');
+	std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+	while (!key.empty() && key[key.size() - 1] == '/')
 	{
-		return fullPath;
+		key.erase(key.size() - 1);
 	}
+	return key;
+}
 
-	// UPPERCASE
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), toupper);
-	fullPath = base + newPath;
-	if (fileExists(fullPath.c_str()))
+/**
+ * Gets the real location of a folder, so a folder
+ * linked back into its own parents can be recognized.
+ * On Windows, linked folders are reported instead,
+ * they have no real path to compare, so only the
+ * Data folders themselves may be links there.
+ * @param path Full path to the folder.
+ * @return Real path of the folder, or empty if it's a link on Windows.
+ */
+static std::string realFolder(const std::string &path)
+{
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT))
 	{
-		return fullPath;
+		return "";
 	}
-
-	// lowercase
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), tolower);
-	fullPath = base + newPath;
-	if (fileExists(fullPath.c_str()))
+	return path;
+#else
+	char real[PATH_MAX];
+	if (realpath(path.c_str(), real) == 0)
 	{
-		return fullPath;
+		return path;
 	}
-
-	// If we got here nothing can help us
-	return "";
+	return real;
+#endif
 }
 
 /**
- * Takes a path and tries to find it based on the
- * system's case-sensitivity.
- * @param base Base unaltered path.
- * @param path Full path to check for casing.
- * @return Correct foldername or "" if it doesn't exist.
- * @note There's no actual method for figuring out the correct
- * foldername on case-sensitive systems, this is just a workaround.
+ * Adds the contents of a folder to the data index,
+ * unless a folder searched earlier already has them.
+ * Folders that link back to one of their parents are
+ * skipped, so link loops can't recurse forever.
+ * @param path Full path to the folder.
+ * @param key Index key of the folder.
+ * @param parents Real paths of the folders being indexed above this one.
  */
-std::string caseInsensitiveFolder(const std::string &base, const std::string &path)
+static void indexDataFolder(const std::string &path, const std::string &key, std::vector<std::string> &parents)
 {
-	std::string fullPath = base + path, newPath = path;
-
-	// Try all various case mutations
-	// Normal unmangled
-	if (folderExists(fullPath.c_str()))
+	std::string real = realFolder(path);
+	if (!key.empty() && (real.empty() || std::find(parents.begin(), parents.end(), real) != parents.end()))
 	{
-		return fullPath;
+		Log(LOG_WARNING) << "Skipping linked data folder " << path;
+		return;
+	}
+	DIR *dp = opendir(path.c_str());
+	if (dp == 0)
+	{
+		return;
 	}
 
-	// UPPERCASE
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), toupper);
-	fullPath = base + newPath;
-	if (folderExists(fullPath.c_str()))
+	std::vector<std::pair<std::string, std::string> > subfolders;
+	struct dirent *dirp;
+	while ((dirp = readdir(dp)) != 0)
 	{
-		return fullPath;
+		std::string file = dirp->d_name;
+		if (file == "." || file == "..")
+		{
+			continue;
+		}
+
+		std::string fullPath = path + file;
+		std::string fileKey = key.empty() ? dataKey(file) : key + '/' + dataKey(file);
+		bool folder;
+#ifdef _DIRENT_HAVE_D_TYPE
+		if (dirp->d_type != DT_UNKNOWN && dirp->d_type != DT_LNK)
+		{
+			folder = (dirp->d_type == DT_DIR);
+		}
+		else
+#endif
+		{
+			folder = folderExists(fullPath);
+		}
+
+		if (folder)
+		{
+			// folders differing only by case get merged, same as across Data folders
+			_dataFolders.insert(std::make_pair(fileKey, fullPath));
+			subfolders.push_back(std::make_pair(fullPath + PATH_SEPARATOR, fileKey));
+		}
+		else
+		{
+			_dataFiles.insert(std::make_pair(fileKey, fullPath));
+		}
 	}
+	closedir(dp);
 
-	// lowercase
-	std::transform(newPath.begin(), newPath.end(), newPath.begin(), tolower);
-	fullPath = base + newPath;
-	if (folderExists(fullPath.c_str()))
+	parents.push_back(real);
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator i = subfolders.begin(); i != subfolders.end(); ++i)
 	{
-		return fullPath;
+		indexDataFolder(i->first, i->second, parents);
 	}
+	parents.pop_back();
+}
 
-	// If we got here nothing can help us
-	return "";
+/**
+ * Scans all the game's Data folders once and indexes every
+ * file and folder in them by their lowercase path, so
+ * lookups don't have to probe the filesystem for each casing.
+ * When the same path is in several Data folders, the
+ * one found first in the search list takes priority.
+ */
+void indexDataFolders()
+{
+	_dataFiles.clear();
+	_dataFolders.clear();
+	std::vector<std::string> roots;
+	if (!Options::getDataFolder().empty())
+	{
+		roots.push_back(Options::getDataFolder());
+	}
+	roots.insert(roots.end(), Options::getDataList().begin(), Options::getDataList().end());
+	for (std::vector<std::string>::const_iterator i = roots.begin(); i != roots.end(); ++i)
+	{
+		std::vector<std::string> parents;
+		indexDataFolder(endPath(*i), "", parents);
+	}
+	_dataIndexed = true;
+	Log(LOG_INFO) << "Indexed " << _dataFiles.size() << " data files in " << _dataFolders.size() << " folders.";
 }
 
 /**
  * Takes a filename and tries to find it in the game's Data folders,
  * accounting for the system's case-sensitivity and path style.
  * @param filename Original filename.
- * @return Correct filename or "" if it doesn't exist.
+ * @return Correct filename or the original if it doesn't exist.
  */
 std::string getDataFile(const std::string &filename)
 {
-	// Correct folder separator
-	std::string name = filename;
-#ifdef _WIN32
-	std::replace(name.begin(), name.end(), '/', PATH_SEPARATOR);
-#endif
-
-	// Check current data path
-	std::string path = caseInsensitive(Options::getDataFolder(), name);
-	if (path != "")
+	if (!_dataIndexed)
 	{
-		return path;
+		indexDataFolders();
 	}
 
-	// Check every other path
-	for (std::vector<std::string>::const_iterator i = Options::getDataList().begin(); i != Options::getDataList().end(); ++i)
+	std::map<std::string, std::string>::const_iterator i = _dataFiles.find(dataKey(filename));
+	if (i != _dataFiles.end())
 	{
-		std::string path = caseInsensitive(*i, name);
-		if (path != "")
-		{
-			Options::setDataFolder(*i);
-			return path;
-		}
+		return i->second;
 	}
 
 	// Give up
@@ -419,32 +477,24 @@ std::string getDataFile(const std::string &filename)
  * Takes a foldername and tries to find it in the game's Data folders,
  * accounting for the system's case-sensitivity and path style.
  * @param foldername Original foldername.
- * @return Correct foldername or "" if it doesn't exist.
+ * @return Correct foldername or the original if it doesn't exist.
  */
 std::string getDataFolder(const std::string &foldername)
 {
-	// Correct folder separator
-	std::string name = foldername;
-#ifdef _WIN32
-	std::replace(name.begin(), name.end(), '/', PATH_SEPARATOR);
-#endif
-
-	// Check current data path
-	std::string path = caseInsensitiveFolder(Options::getDataFolder(), name);
-	if (path != "")
+	if (!_dataIndexed)
 	{
-		return path;
+		indexDataFolders();
 	}
 
-	// Check every other path
-	for (std::vector<std::string>::const_iterator i = Options::getDataList().begin(); i != Options::getDataList().end(); ++i)
+	std::map<std::string, std::string>::const_iterator i = _dataFolders.find(dataKey(foldername));
+	if (i != _dataFolders.end())
 	{
-		std::string path = caseInsensitiveFolder(*i, name);
-		if (path != "")
+		// Keep the trailing separator if there was one
+		if (!foldername.empty() && (foldername[foldername.size() - 1] == '/' || foldername[foldername.size() - 1] == PATH_SEPARATOR))
 		{
-			Options::setDataFolder(*i);
-			return path;
+			return i->second + PATH_SEPARATOR;
 		}
+		return i->second;
 	}
 
 	// Give up
@@ -554,40 +604,36 @@ std::vector<std::string> getFolderContents(const std::string &path, const std::s
  */
 std::vector<std::string> getDataContents(const std::string &folder, const std::string &ext)
 {
-	std::set<std::string> unique;
-	std::vector<std::string> files;
+	if (!_dataIndexed)
+	{
+		indexDataFolders();
+	}
 
-	// Check current data path
-	std::string current = caseInsensitiveFolder(Options::getDataFolder(), folder);
-	if (current != "")
+	std::set<std::string> unique;
+	std::string extl = ext;
+	std::transform(extl.begin(), extl.end(), extl.begin(), ::tolower);
+	std::string prefix = dataKey(folder);
+	if (!prefix.empty())
 	{
-		std::vector<std::string> contents = getFolderContents(current, ext);
-		for (std::vector<std::string>::const_iterator file = contents.begin(); file != contents.end(); ++file)
-		{
-			unique.insert(*file);
-		}
+		prefix += '/';
 	}
 
-	// Check every other path
-	for (std::vector<std::string>::const_iterator i = Options::getDataList().begin(); i != Options::getDataList().end(); ++i)
+	// Files in the folder are a contiguous range of the index
+	for (std::map<std::string, std::string>::const_iterator i = _dataFiles.lower_bound(prefix); i != _dataFiles.end() && i->first.compare(0, prefix.size(), prefix) == 0; ++i)
 	{
-		std::string path = caseInsensitiveFolder(*i, folder);
-		if (path == current)
+		std::string key = i->first.substr(prefix.size());
+		if (key.find('/') != std::string::npos)
 		{
 			continue;
 		}
-		if (path != "")
+		if (!extl.empty() && (key.length() < extl.length() + 1 || key.compare(key.length() - extl.length() - 1, std::string::npos, "." + extl) != 0))
 		{
-			std::vector<std::string> contents = getFolderContents(path, ext);
-			for (std::vector<std::string>::const_iterator file = contents.begin(); file != contents.end(); ++file)
-			{
-				unique.insert(*file);
-			}
+			continue;
 		}
+		unique.insert(i->second.substr(i->second.size() - key.size()));
 	}
 
-	files = std::vector<std::string>(unique.begin(), unique.end());
-	return files;
+	return std::vector<std::string>(unique.begin(), unique.end());
 }
 
 /**
@@ -964,5 +1010,49 @@ void setWindowIcon(int winResource, const std::string &unixPath)
 #endif
 }
 
+/**
+ * Gets the number of processors available to the game,
+ * for sizing worker thread pools.
+ * @return Number of processors, at least 1.
+ */
+int getProcessorCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	int count = 1;
+#endif
+	return count > 0 ? count : 1;
+}
+
+
+/**
+ * Gets a timestamp from the most precise clock available,
+ * for timing code that runs faster than SDL_GetTicks can resolve.
+ * Only differences between two timestamps are meaningful.
+ * @return Timestamp in microseconds.
+ */
+Uint64 getPreciseTicks()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (Uint64)(counter.QuadPart / frequency.QuadPart) * 1000000 + (Uint64)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#elif defined(_POSIX_MONOTONIC_CLOCK) && _POSIX_MONOTONIC_CLOCK >= 0
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (Uint64)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#else
+	timeval now;
+	gettimeofday(&now, 0);
+	return (Uint64)now.tv_sec * 1000000 + now.tv_usec;
+#endif
+}
+
 }
 }
@@ -41,6 +41,8 @@ namespace CrossPlatform
 	std::vector<std::string> findUserFolders();
 	/// Finds the game's config folder in the system.
 	std::string findConfigFolder();
+	/// Indexes the contents of the game's data folders.
+	void indexDataFolders();
 	/// Gets the path for a data file.
 	std::string getDataFile(const std::string &filename);
     /// Gets the path for a data folder
@@ -83,6 +85,10 @@ namespace CrossPlatform
 	std::string getDosPath();
 	/// Sets the window icon.
 	void setWindowIcon(int winResource, const std::string &unixPath);
+	/// Gets the number of processors in the system.
+	int getProcessorCount();
+	/// Gets a high resolution timestamp in microseconds.
+	Uint64 getPreciseTicks();
 }
 
 }
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "FileMap.h"
+#include <fstream>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif !defined(__MORPHOS__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace OpenXcom
+{
+
+/**
+ * Opens a file and maps its contents into memory. If the file
+ * can't be mapped, it's read into a buffer instead.
+ * @param path Full path to the file.
+ */
+FileMap::FileMap(const std::string &path) : _data(0), _size(0), _open(false), _mapped(false), _file(0), _mapping(0)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size))
+		{
+			_open = true;
+			_size = (size_t)size.QuadPart;
+			if (_size > 0)
+			{
+				HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+				if (mapping != 0)
+				{
+					_data = (const Uint8*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+					if (_data != 0)
+					{
+						_mapped = true;
+						_file = file;
+						_mapping = mapping;
+						return;
+					}
+					CloseHandle(mapping);
+				}
+			}
+		}
+		CloseHandle(file);
+	}
+#elif !defined(__MORPHOS__)
+	int file = open(path.c_str(), O_RDONLY);
+	if (file != -1)
+	{
+		struct stat info;
+		if (fstat(file, &info) == 0)
+		{
+			_open = true;
+			_size = (size_t)info.st_size;
+			if (_size > 0)
+			{
+				void *data = mmap(0, _size, PROT_READ, MAP_PRIVATE, file, 0);
+				if (data != MAP_FAILED)
+				{
+					_data = (const Uint8*)data;
+					_mapped = true;
+				}
+			}
+		}
+		close(file);
+	}
+#endif
+	if (!_mapped)
+	{
+		// fall back to reading the whole file at once
+		std::ifstream stream(path.c_str(), std::ios::in | std::ios::binary);
+		std::streamoff length = -1;
+		if (stream)
+		{
+			stream.seekg(0, std::ios::end);
+			length = stream.tellg();
+			stream.seekg(0, std::ios::beg);
+		}
+		if (length < 0)
+		{
+			// can't tell how big it is, so treat it like a file that can't be opened
+			_open = false;
+			_size = 0;
+			return;
+		}
+		_open = true;
+		_size = (size_t)length;
+		_buffer.resize(_size);
+		if (_size > 0)
+		{
+			stream.read((char*)&_buffer[0], _size);
+			_size = (size_t)stream.gcount();
+			_data = &_buffer[0];
+		}
+	}
+}
+
+/**
+ * Unmaps the file from memory.
+ */
+FileMap::~FileMap()
+{
+	if (!_mapped)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle((HANDLE)_mapping);
+	CloseHandle((HANDLE)_file);
+#elif !defined(__MORPHOS__)
+	munmap((void*)_data, _size);
+#endif
+}
+
+}
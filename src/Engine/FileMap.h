@@ -0,0 +1,72 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_FILEMAP_H
+#define OPENXCOM_FILEMAP_H
+
+#include <string>
+#include <vector>
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Read-only view of a whole file in memory.
+ * The file is memory-mapped where the platform supports it
+ * (and read in one go where it doesn't), so data files can be
+ * parsed in place instead of through a stream, piece by piece.
+ */
+class FileMap
+{
+private:
+	const Uint8 *_data;
+	size_t _size;
+	bool _open, _mapped;
+	void *_file, *_mapping;
+	std::vector<Uint8> _buffer;
+
+	/// Files can't be copied.
+	FileMap(const FileMap&);
+	/// Files can't be copied.
+	FileMap &operator=(const FileMap&);
+public:
+	/// Maps a file into memory.
+	FileMap(const std::string &path);
+	/// Unmaps the file.
+	~FileMap();
+	/// Checks if the file couldn't be opened.
+	bool operator!() const
+	{
+		return !_open;
+	}
+	/// Gets the contents of the file.
+	const Uint8 *getData() const
+	{
+		return _data;
+	}
+	/// Gets the size of the file.
+	size_t getSize() const
+	{
+		return _size;
+	}
+};
+
+}
+
+#endif
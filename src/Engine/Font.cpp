@@ -26,6 +26,9 @@
 namespace OpenXcom
 {
 
+/// Maximum amount of string layouts kept per font.
+static const size_t MAX_LAYOUTS = 2048;
+
 std::wstring Font::_index = L"";
 
 SDL_Color Font::_palette[] = {{0, 0, 0, 0},
@@ -38,7 +41,7 @@ SDL_Color Font::_palette[] = {{0, 0, 0, 0},
 /**
  * Initializes the font with a blank surface.
  */
-Font::Font() : _surface(0), _width(0), _height(0), _spacing(0), _chars(), _monospace(false)
+Font::Font() : _surface(0), _width(0), _height(0), _spacing(0), _glyphs(), _pages(), _layouts(), _monospace(false)
 {
 }
 
@@ -127,7 +130,7 @@ void Font::init()
 			rect.y = startY;
 			rect.w = _width;
 			rect.h = _height;
-			_chars[_index[i]] = rect;
+			addGlyph(_index[i], rect);
 		}
 	}
 	else
@@ -165,10 +168,56 @@ void Font::init()
 			rect.w = right - left + 1;
 			rect.h = _height;
 
-			_chars[_index[i]] = rect;
+			addGlyph(_index[i], rect);
 		}
 	}
 	_surface->unlock();
+	_layouts.clear();
+}
+
+/**
+ * Stores a character in the glyph table, along with the
+ * runs of solid pixels found in its area of the surface.
+ * Characters are looked up through pages of 256 codepoints
+ * so most text never leaves the first few.
+ * @param c Character.
+ * @param rect Area of the character in the font surface.
+ */
+void Font::addGlyph(wchar_t c, const SDL_Rect &rect)
+{
+	FontGlyph glyph;
+	glyph.rect = rect;
+	for (int y = 0; y < rect.h; ++y)
+	{
+		for (int x = 0; x < rect.w; ++x)
+		{
+			if (_surface->getPixel(rect.x + x, rect.y + y) != 0)
+			{
+				FontSpan span;
+				span.x = x;
+				span.y = y;
+				span.length = 0;
+				while (x < rect.w && _surface->getPixel(rect.x + x, rect.y + y) != 0)
+				{
+					span.length++;
+					x++;
+				}
+				glyph.spans.push_back(span);
+			}
+		}
+	}
+
+	Uint32 page = (Uint32)c >> 8;
+	if (page >= _pages.size())
+	{
+		_pages.resize(page + 1);
+	}
+	if (_pages[page].empty())
+	{
+		_pages[page].resize(256, -1);
+	}
+	_pages[page][(Uint32)c & 0xFF] = _glyphs.size();
+	_glyphs.push_back(glyph);
 }
 
 /**
@@ -179,16 +228,36 @@ void Font::init()
  */
 Surface *Font::getChar(wchar_t c)
 {
-	if (_chars.find(c) == _chars.end())
+	const FontGlyph *glyph = getGlyph(c);
+	if (glyph == 0)
 	{
 		return 0;
 	}
-	_surface->getCrop()->x = _chars[c].x;
-	_surface->getCrop()->y = _chars[c].y;
-	_surface->getCrop()->w = _chars[c].w;
-	_surface->getCrop()->h = _chars[c].h;
+	_surface->getCrop()->x = glyph->rect.x;
+	_surface->getCrop()->y = glyph->rect.y;
+	_surface->getCrop()->w = glyph->rect.w;
+	_surface->getCrop()->h = glyph->rect.h;
 	return _surface;
 }
+
+/**
+ * Returns the glyph of a particular character in the font.
+ * @param c Font character.
+ * @return Pointer to the glyph, or 0 if the font doesn't have it.
+ */
+const FontGlyph *Font::getGlyph(wchar_t c) const
+{
+	Uint32 page = (Uint32)c >> 8;
+	if (page < _pages.size() && !_pages[page].empty())
+	{
+		int i = _pages[page][(Uint32)c & 0xFF];
+		if (i != -1)
+		{
+			return &_glyphs[i];
+		}
+	}
+	return 0;
+}
 /**
  * Returns the maximum width for any character in the font.
  * @return Width in pixels.
@@ -223,13 +292,19 @@ int Font::getSpacing() const
  * @param c Font character.
  * @return Width and Height dimensions (X and Y are ignored).
  */
-SDL_Rect Font::getCharSize(wchar_t c)
+SDL_Rect Font::getCharSize(wchar_t c) const
 {
 	SDL_Rect size = { 0, 0, 0, 0 };
 	if (c != 1 && !isLinebreak(c) && !isSpace(c))
 	{
-		size.w = _chars[c].w + _spacing;
-		size.h = _chars[c].h + _spacing;
+		const FontGlyph *glyph = getGlyph(c);
+		if (glyph != 0)
+		{
+			size.w = glyph->rect.w;
+			size.h = glyph->rect.h;
+		}
+		size.w += _spacing;
+		size.h += _spacing;
 	}
 	else
 	{
@@ -257,6 +332,40 @@ Surface *Font::getSurface() const
 	return _surface;
 }
 
+/**
+ * Returns the line measurements of a string previously
+ * laid out with this font.
+ * @param text Original string.
+ * @param format Layout settings the string was measured with.
+ * @return Pointer to the layout, or 0 if there's none.
+ */
+const FontLayout *Font::getLayout(const std::wstring &text, int format) const
+{
+	std::map< std::pair<std::wstring, int>, FontLayout >::const_iterator i = _layouts.find(std::make_pair(text, format));
+	if (i != _layouts.end())
+	{
+		return &i->second;
+	}
+	return 0;
+}
+
+/**
+ * Creates a layout entry for a string laid out with this font,
+ * for the caller to fill in. The cache is emptied once it
+ * grows too large.
+ * @param text Original string.
+ * @param format Layout settings the string was measured with.
+ * @return Pointer to the new layout.
+ */
+FontLayout *Font::addLayout(const std::wstring &text, int format)
+{
+	if (_layouts.size() >= MAX_LAYOUTS)
+	{
+		_layouts.clear();
+	}
+	return &_layouts[std::make_pair(text, format)];
+}
+
 void Font::fix(const std::string &file, int width)
 {
 	Surface *s = new Surface(width, 512);
@@ -268,7 +377,10 @@ void Font::fix(const std::string &file, int width)
 	int y = 0;
 	for (size_t i = 0; i < _index.length(); ++i)
 	{
-		SDL_Rect rect = _chars[_index[i]];
+		const FontGlyph *glyph = getGlyph(_index[i]);
+		if (glyph == 0)
+			continue;
+		SDL_Rect rect = glyph->rect;
 		_surface->getCrop()->x = rect.x;
 		_surface->getCrop()->y = rect.y;
 		_surface->getCrop()->w = rect.w;
@@ -20,6 +20,7 @@
 #define OPENXCOM_FONT_H
 
 #include <map>
+#include <vector>
 #include <string>
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
@@ -30,6 +31,35 @@ namespace OpenXcom
 class Surface;
 class Palette;
 
+/**
+ * A horizontal run of solid pixels in a font character,
+ * relative to the character's top-left corner.
+ */
+struct FontSpan
+{
+	int x, y, length;
+};
+
+/**
+ * A character in a font, with its area in the font surface
+ * and the runs of pixels that actually need drawing.
+ */
+struct FontGlyph
+{
+	SDL_Rect rect;
+	std::vector<FontSpan> spans;
+};
+
+/**
+ * Line measurements of a string laid out in a font,
+ * kept so identical text doesn't get measured again.
+ */
+struct FontLayout
+{
+	std::wstring text, wrappedText;
+	std::vector<int> lineWidth, lineHeight;
+};
+
 /**
  * Takes care of loading and storing each character in a sprite font.
  * Sprite fonts consist of a set of fixed-size characters all lined up
@@ -44,8 +74,13 @@ private:
 	static SDL_Color _palette[6];
 	Surface *_surface;
 	int _width, _height, _spacing;
-	std::map<wchar_t, SDL_Rect> _chars;
+	std::vector<FontGlyph> _glyphs;
+	std::vector< std::vector<int> > _pages;
+	std::map< std::pair<std::wstring, int>, FontLayout > _layouts;
 	bool _monospace;
+
+	/// Adds a character to the glyph table.
+	void addGlyph(wchar_t c, const SDL_Rect &rect);
 public:
 	/// Creates a blank font.
 	Font();
@@ -69,6 +104,8 @@ public:
 	void init();
 	/// Gets a particular character from the font, with its real size.
 	Surface *getChar(wchar_t c);
+	/// Gets the glyph of a particular character.
+	const FontGlyph *getGlyph(wchar_t c) const;
 	/// Gets the font's character width.
 	int getWidth() const;
 	/// Gets the font's character height.
@@ -76,9 +113,13 @@ public:
 	/// Gets the spacing between characters.
 	int getSpacing() const;
 	/// Gets the size of a particular character;
-	SDL_Rect getCharSize(wchar_t c);
+	SDL_Rect getCharSize(wchar_t c) const;
 	/// Gets the font's surface.
 	Surface *getSurface() const;
+	/// Gets the cached layout of a string.
+	const FontLayout *getLayout(const std::wstring &text, int format) const;
+	/// Stores the layout of a string.
+	FontLayout *addLayout(const std::wstring &text, int format);
 
 	void fix(const std::string &file, int width);
 };
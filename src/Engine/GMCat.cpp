@@ -359,7 +359,7 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 {
 	Music *music = new Music;
 
-	unsigned char *raw = static_cast<unsigned char*> ((void*)load(i));
+	const unsigned char *raw = getObject(i);
 
 	if (!raw)
 		return music;
@@ -367,7 +367,6 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 	// stream info
 	struct gmstream stream;
 	if (gmext_read_stream(&stream, getObjectSize(i), raw) == -1) {
-		delete[] raw;
 		return music;
 	}
 
@@ -376,12 +375,9 @@ Music *GMCatFile::loadMIDI(unsigned int i)
 
 	// fields in stream still point into raw
 	if (gmext_write_midi(&stream, midi) == -1) {
-		delete[] raw;
 		return music;
 	}
 
-	delete[] raw;
-
 	music->load(&midi[0], midi.size());
 
 	return music;
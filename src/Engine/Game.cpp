@@ -20,6 +20,7 @@
 #include <cmath>
 #include <sstream>
 #include <SDL_mixer.h>
+#include <SDL_image.h>
 #include "Adlib/adlplayer.h"
 #include "State.h"
 #include "Screen.h"
@@ -31,6 +32,7 @@
 #include "../Interface/FpsCounter.h"
 #include "../Resource/ResourcePack.h"
 #include "../Ruleset/Ruleset.h"
+#include "../Ruleset/RulesetCache.h"
 #include "../Savegame/SavedGame.h"
 #include "Palette.h"
 #include "Action.h"
@@ -38,6 +40,8 @@
 #include "InteractiveSurface.h"
 #include "Options.h"
 #include "CrossPlatform.h"
+#include "ThreadPool.h"
+#include "RNG.h"
 #include "../Menu/TestState.h"
 
 namespace OpenXcom
@@ -62,6 +66,9 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _states
 	}
 	Log(LOG_INFO) << "SDL initialized successfully.";
 
+	// Load the image decoders here, doing it lazily from the loading threads isn't safe
+	IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF);
+
 	// Initialize SDL_mixer
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0)
 	{
@@ -85,8 +92,12 @@ Game::Game(const std::string &title) : _screen(0), _cursor(0), _lang(0), _states
 
 	SDL_EnableUNICODE(1);
 
+	// Create worker threads, the main thread makes up the last one
+	int threads = Options::workerThreads > 0 ? Options::workerThreads : CrossPlatform::getProcessorCount();
+	_threadPool = new ThreadPool(threads - 1);
+
 	// Create display
-	_screen = new Screen();
+	_screen = new Screen(_threadPool);
 
 	// Create cursor
 	_cursor = new Cursor(9, 13);
@@ -128,9 +139,11 @@ Game::~Game()
 	delete _rules;
 	delete _screen;
 	delete _fpsCounter;
+	delete _threadPool;
 
 	Mix_CloseAudio();
 
+	IMG_Quit();
 	SDL_Quit();
 }
 
@@ -298,10 +311,16 @@ void Game::run()
 				}
 				_fpsCounter->blit(_screen->getSurface());
 				_cursor->blit(_screen->getSurface());
-				_screen->flip();
+				_screen->flip(false);
 			}
 		}
 
+		// Show the last frame once the presenter has scaled it
+		if (_screen->present())
+		{
+			_fpsCounter->addPresent(_screen->getPresentTime());
+		}
+
 		// Save on CPU
 		switch (runningState)
 		{
@@ -391,6 +410,16 @@ FpsCounter *Game::getFpsCounter() const
 	return _fpsCounter;
 }
 
+/**
+ * Returns the pool of worker threads used to split
+ * expensive calculations across processors.
+ * @return Pointer to the ThreadPool.
+ */
+ThreadPool *Game::getThreadPool() const
+{
+	return _threadPool;
+}
+
 /**
  * Pops all the states currently in stack and pushes in the new state.
  * A shortcut for cleaning up all the old states when they're not necessary
@@ -513,6 +542,7 @@ void Game::setSavedGame(SavedGame *save)
 {
 	delete _save;
 	_save = save;
+	RNG::setStream(_save ? _save->getRNG() : 0);
 }
 
 /**
@@ -535,11 +565,12 @@ void Game::loadRuleset()
 	{
 		Options::rulesets.push_back("Xcom1Ruleset");
 	}
+	RulesetCache cache(Options::getUserFolder() + "ruleset.cache");
 	for (std::vector<std::string>::iterator i = Options::rulesets.begin(); i != Options::rulesets.end();)
 	{
 		try
 		{
-			_rules->load(*i);
+			_rules->load(*i, &cache);
 			++i;
 		}
 		catch (YAML::Exception &e)
@@ -554,6 +585,7 @@ void Game::loadRuleset()
 	{
 		throw Exception("Failed to load ruleset");
 	}
+	cache.save();
 	_rules->sortLists();
 }
 
@@ -34,6 +34,7 @@ class ResourcePack;
 class SavedGame;
 class Ruleset;
 class FpsCounter;
+class ThreadPool;
 
 /**
  * The core of the game engine, manages the game's entire contents and structure.
@@ -54,6 +55,7 @@ private:
 	Ruleset *_rules;
 	bool _quit, _init;
 	FpsCounter *_fpsCounter;
+	ThreadPool *_threadPool;
 	bool _mouseActive;
 	unsigned int _timeOfLastFrame;
 	int _timeUntilNextFrame;
@@ -78,6 +80,8 @@ public:
 	Cursor *getCursor() const;
 	/// Gets the FpsCounter.
 	FpsCounter *getFpsCounter() const;
+	/// Gets the worker thread pool.
+	ThreadPool *getThreadPool() const;
 	/// Resets the state stack to a new state.
 	void setState(State *state);
 	/// Pushes a new state into the state stack.
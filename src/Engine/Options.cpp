@@ -71,6 +71,9 @@ void create()
 #endif
 
 	_info.push_back(OptionInfo("maxFrameSkip", &maxFrameSkip, 0));
+	_info.push_back(OptionInfo("workerThreads", &workerThreads, 0));
+	_info.push_back(OptionInfo("asyncPresent", &asyncPresent, true));
+	_info.push_back(OptionInfo("binarySaves", &binarySaves, true));
 	_info.push_back(OptionInfo("traceAI", &traceAI, false));
 	_info.push_back(OptionInfo("baseXResolution", &baseXResolution, Screen::ORIGINAL_WIDTH));
 	_info.push_back(OptionInfo("baseYResolution", &baseYResolution, Screen::ORIGINAL_HEIGHT));
@@ -416,6 +419,7 @@ bool init(int argc, char *argv[])
 	{
 		Log(LOG_INFO) << "- " << *i;
 	}
+	CrossPlatform::indexDataFolders();
 	Log(LOG_INFO) << "User folder is: " << _userFolder;
 	Log(LOG_INFO) << "Config folder is: " << _configFolder;
 	Log(LOG_INFO) << "Options loaded successfully.";
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include "CrossPlatform.h"
+
+namespace OpenXcom
+{
+namespace Profiler
+{
+
+bool _enabled = false;
+Uint64 _time[PHASE_COUNT];
+int _calls[PHASE_COUNT];
+int _depth[PHASE_COUNT];
+
+/**
+ * Starts timing a phase if collection is on.
+ * @param phase Phase to time.
+ */
+Scope::Scope(Phase phase) : _phase(phase), _start(0), _active(_enabled)
+{
+	if (_active && _depth[_phase]++ == 0)
+	{
+		_start = CrossPlatform::getPreciseTicks();
+	}
+}
+
+/**
+ * Adds the time since the outermost scope of
+ * the phase started to the phase's total.
+ */
+Scope::~Scope()
+{
+	if (_active && --_depth[_phase] == 0)
+	{
+		_time[_phase] += CrossPlatform::getPreciseTicks() - _start;
+		_calls[_phase]++;
+	}
+}
+
+/**
+ * Turns time collection on or off.
+ * @param enabled Collect times?
+ */
+void setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+/**
+ * Checks if time is being collected.
+ * @return Collection on?
+ */
+bool isEnabled()
+{
+	return _enabled;
+}
+
+/**
+ * Clears all the times and call counts collected so far.
+ */
+void reset()
+{
+	for (int i = 0; i < PHASE_COUNT; ++i)
+	{
+		_time[i] = 0;
+		_calls[i] = 0;
+		_depth[i] = 0;
+	}
+}
+
+/**
+ * Gets the name of a phase, as used in reports.
+ * @param phase Phase.
+ * @return Phase name.
+ */
+const char *getName(Phase phase)
+{
+	static const char *names[PHASE_COUNT] = { "fov", "lighting", "pathfinding", "ai", "explosions", "reactionFire" };
+	return names[phase];
+}
+
+/**
+ * Gets the total time spent in a phase since the last reset.
+ * @param phase Phase.
+ * @return Time in microseconds.
+ */
+Uint64 getTime(Phase phase)
+{
+	return _time[phase];
+}
+
+/**
+ * Gets the number of times a phase was entered since the last reset.
+ * @param phase Phase.
+ * @return Number of calls.
+ */
+int getCalls(Phase phase)
+{
+	return _calls[phase];
+}
+
+}
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_PROFILER_H
+#define OPENXCOM_PROFILER_H
+
+#include <SDL_types.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Accumulates the time the game spends in its expensive
+ * battlescape phases, for benchmarking. Collection is off by
+ * default, in which case a scope costs no more than a flag check.
+ * Timings are inclusive and only meant for the main thread.
+ */
+namespace Profiler
+{
+	enum Phase { PHASE_FOV, PHASE_LIGHTING, PHASE_PATHFINDING, PHASE_AI, PHASE_EXPLOSIONS, PHASE_REACTION_FIRE, PHASE_COUNT };
+
+	/**
+	 * Times its own lifetime as one call of a phase.
+	 * Nested scopes of the same phase only count once.
+	 */
+	class Scope
+	{
+	private:
+		Phase _phase;
+		Uint64 _start;
+		bool _active;
+	public:
+		/// Starts timing a phase.
+		Scope(Phase phase);
+		/// Stops timing the phase.
+		~Scope();
+	};
+
+	/// Turns time collection on or off.
+	void setEnabled(bool enabled);
+	/// Checks if time is being collected.
+	bool isEnabled();
+	/// Clears all collected times.
+	void reset();
+	/// Gets the name of a phase.
+	const char *getName(Phase phase);
+	/// Gets the total time spent in a phase.
+	Uint64 getTime(Phase phase);
+	/// Gets the number of times a phase was entered.
+	int getCalls(Phase phase);
+}
+
+}
+
+#endif
@@ -25,7 +25,7 @@ namespace OpenXcom
 namespace RNG
 {
 
-/*  Written in 2014 by Sebastiano Vigna (vigna@acm.org)
+/*  Written in 2018 by David Blackman and Sebastiano Vigna (vigna@acm.org)
 
 To the extent possible under law, the author has dedicated all copyright
 and related and neighboring rights to this software to the public domain
@@ -33,36 +33,88 @@ worldwide. This software is distributed without any warranty.
 
 See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
-/* This is a good generator if you're short on memory, but otherwise we
-   rather suggest to use a xorshift128+ (for maximum speed) or
-   xorshift1024* (for speed and very long period) generator. */
+/* xoshiro256** is an all-purpose, rock-solid generator with a 256-bit
+   state. The state must be seeded so that it is not everywhere zero,
+   so we expand 64-bit seeds with a splitmix64 generator, as suggested. */
 
-uint64_t x = time(0); /* The state must be seeded with a nonzero value. */
+static inline uint64_t rotl(const uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
 
-uint64_t next()
+static uint64_t splitmix64(uint64_t &x)
 {
-	x ^= x >> 12; // a
-	x ^= x << 25; // b
-	x ^= x >> 27; // c
-	return x * 2685821657736338717LL;
+	uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
 }
 
+static Stream _default(time(0));
+static Stream *_current = &_default;
+
 /**
-* Returns the current seed in use by the generator.
-* @return Current seed.
-*/
-uint64_t getSeed()
+ * Creates a stream of random numbers.
+ * @param seed Seed to start from.
+ */
+Stream::Stream(uint64_t seed)
 {
-	return x;
+	this->seed(seed);
 }
 
 /**
-* Changes the current seed in use by the generator.
-* @param n New seed.
-*/
-void setSeed(uint64_t n)
+ * Makes sure the free functions don't keep
+ * drawing from a stream that's gone.
+ */
+Stream::~Stream()
+{
+	if (_current == this)
+	{
+		_current = &_default;
+	}
+}
+
+/**
+ * Restarts the stream from a seed. The same seed
+ * always gives the same sequence of numbers.
+ * @param seed Seed to start from.
+ */
+void Stream::seed(uint64_t seed)
+{
+	_seed = seed;
+	uint64_t x = seed;
+	for (int i = 0; i < 4; ++i)
+	{
+		_state[i] = splitmix64(x);
+	}
+	_gauss = 0;
+	_hasGauss = false;
+}
+
+/**
+ * Returns the seed the stream was started from.
+ * @return Seed.
+ */
+uint64_t Stream::getSeed() const
 {
-	x = n;
+	return _seed;
+}
+
+/**
+ * Advances the generator.
+ * @return Next raw 64-bit number.
+ */
+uint64_t Stream::next()
+{
+	const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+	const uint64_t t = _state[1] << 17;
+	_state[2] ^= _state[0];
+	_state[3] ^= _state[1];
+	_state[1] ^= _state[2];
+	_state[0] ^= _state[3];
+	_state[2] ^= t;
+	_state[3] = rotl(_state[3], 45);
+	return result;
 }
 
 /**
@@ -71,7 +123,7 @@ void setSeed(uint64_t n)
  * @param max Maximum number, inclusive.
  * @return Generated number.
  */
-int generate(int min, int max)
+int Stream::generate(int min, int max)
 {
 	uint64_t num = next();
 	return (int)(num % (max - min + 1) + min);
@@ -83,7 +135,7 @@ int generate(int min, int max)
  * @param max Maximum number.
  * @return Generated number.
  */
-double generate(double min, double max)
+double Stream::generate(double min, double max)
 {
 	double num = next();
 	return (double)(num / ((double)UINT64_MAX / (max - min)) + min);
@@ -95,16 +147,14 @@ double generate(double min, double max)
  * @param s standard deviation
  * @return normally distributed value.
  */
-double boxMuller(double m, double s)
+double Stream::boxMuller(double m, double s)
 {
 	double y1;
-	static double y2;
-	static int use_last = 0;
 
-	if (use_last)				/* use value from previous call */
+	if (_hasGauss)				/* use value from previous call */
 	{
-		y1 = y2;
-		use_last = 0;
+		y1 = _gauss;
+		_hasGauss = false;
 	}
 	else
 	{
@@ -117,8 +167,8 @@ double boxMuller(double m, double s)
 
 		w = sqrt( (-2.0 * log( w ) ) / w );
 		y1 = x1 * w;
-		y2 = x2 * w;
-		use_last = 1;
+		_gauss = x2 * w;
+		_hasGauss = true;
 	}
 
 	return( m + y1 * s );
@@ -130,7 +180,7 @@ double boxMuller(double m, double s)
  * @param value Value percentage (0-100%)
  * @return True if the chance succeeded.
  */
-bool percent(int value)
+bool Stream::percent(int value)
 {
 	return (generate(0, 99) < value);
 }
@@ -140,11 +190,196 @@ bool percent(int value)
  * @param max Maximum number, exclusive.
  * @return Generated number.
  */
-int generateEx(int max)
+int Stream::generateEx(int max)
 {
 	uint64_t num = next();
 	return (int)(num % max);
 }
 
+/**
+ * Splits off a new stream seeded from this one. The new
+ * stream doesn't depend on this one anymore, so it can be
+ * handed to work that runs in any order or on other threads.
+ * @return New stream.
+ */
+Stream Stream::split()
+{
+	return Stream(next());
+}
+
+/**
+ * Gets one of the numbered sub-streams of this stream's seed,
+ * without advancing this stream, so work items can each draw
+ * from their own stream no matter in which order they are run.
+ * @param index Number of the sub-stream.
+ * @return New stream.
+ */
+Stream Stream::substream(uint64_t index) const
+{
+	uint64_t x = _seed ^ (index * 0xD1B54A32D192ED03ULL);
+	return Stream(splitmix64(x));
+}
+
+/**
+ * Loads the stream state from a YAML file.
+ * Older saves only stored a seed, so take that too.
+ * @param node YAML node.
+ */
+void Stream::load(const YAML::Node &node)
+{
+	if (node.IsScalar())
+	{
+		seed(node.as<uint64_t>());
+	}
+	else if (node.IsMap())
+	{
+		_seed = node["seed"].as<uint64_t>(_seed);
+		std::vector<uint64_t> state = node["state"].as< std::vector<uint64_t> >(std::vector<uint64_t>());
+		if (state.size() == 4 && (state[0] | state[1] | state[2] | state[3]) != 0)
+		{
+			std::copy(state.begin(), state.end(), _state);
+		}
+		else
+		{
+			seed(_seed);
+		}
+		_hasGauss = false;
+	}
+}
+
+/**
+ * Saves the stream state to a YAML file.
+ * @return YAML node.
+ */
+YAML::Node Stream::save() const
+{
+	YAML::Node node;
+	node["seed"] = _seed;
+	for (int i = 0; i < 4; ++i)
+	{
+		node["state"].push_back(_state[i]);
+	}
+	return node;
+}
+
+/**
+ * Switches the free functions to a stream for as long as
+ * the scope lasts.
+ * @param stream Stream to draw from.
+ */
+StreamScope::StreamScope(Stream *stream) : _previous(_current)
+{
+	setStream(stream);
+}
+
+/**
+ * Switches the free functions back to the previous stream.
+ */
+StreamScope::~StreamScope()
+{
+	_current = _previous;
+}
+
+/**
+ * Returns the stream the free functions currently draw from.
+ * They are meant for the main thread only; work on other
+ * threads should get its own stream with split().
+ * @return Current stream.
+ */
+Stream *getStream()
+{
+	return _current;
+}
+
+/**
+ * Changes the stream the free functions draw from.
+ * @param stream New stream, or 0 for the default stream.
+ */
+void setStream(Stream *stream)
+{
+	_current = stream ? stream : &_default;
+}
+
+/**
+* Returns the seed the current stream was started from.
+* @return Current seed.
+*/
+uint64_t getSeed()
+{
+	return _current->getSeed();
+}
+
+/**
+* Restarts the current stream from a new seed.
+* @param n New seed.
+*/
+void setSeed(uint64_t n)
+{
+	_current->seed(n);
+}
+
+/**
+ * Generates a random integer number within a certain range.
+ * @param min Minimum number, inclusive.
+ * @param max Maximum number, inclusive.
+ * @return Generated number.
+ */
+int generate(int min, int max)
+{
+	return _current->generate(min, max);
+}
+
+/**
+ * Generates a random decimal number within a certain range.
+ * @param min Minimum number.
+ * @param max Maximum number.
+ * @return Generated number.
+ */
+double generate(double min, double max)
+{
+	return _current->generate(min, max);
+}
+
+/**
+ * Normal random variate generator
+ * @param m mean
+ * @param s standard deviation
+ * @return normally distributed value.
+ */
+double boxMuller(double m, double s)
+{
+	return _current->boxMuller(m, s);
+}
+
+/**
+ * Generates a random percent chance of an event occuring,
+ * and returns the result
+ * @param value Value percentage (0-100%)
+ * @return True if the chance succeeded.
+ */
+bool percent(int value)
+{
+	return _current->percent(value);
+}
+
+/**
+ * Generates a random positive integer up to a number.
+ * @param max Maximum number, exclusive.
+ * @return Generated number.
+ */
+int generateEx(int max)
+{
+	return _current->generateEx(max);
+}
+
+/**
+ * Splits off a new stream seeded from the current one.
+ * @return New stream.
+ */
+Stream split()
+{
+	return _current->split();
+}
+
 }
 }
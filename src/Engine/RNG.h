@@ -22,17 +22,81 @@
 #include <algorithm>
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
+#include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
 {
 
 /**
  * Random Number Generator used throughout the game
- * for all your randomness needs. Uses a 64-bit xorshift
- * pseudorandom number generator.
+ * for all your randomness needs. Every part of the game
+ * draws from its own stream, so they don't disturb each other.
  */
 namespace RNG
 {
+	/**
+	 * An independent, seedable stream of random numbers.
+	 * Uses a xoshiro256** pseudorandom number generator.
+	 * Streams can be split into new independent streams,
+	 * eg. to hand out to work running on other threads.
+	 */
+	class Stream
+	{
+	private:
+		uint64_t _state[4];
+		uint64_t _seed;
+		double _gauss;
+		bool _hasGauss;
+	public:
+		/// Creates a stream from a seed.
+		Stream(uint64_t seed = 0);
+		/// Cleans up the stream.
+		~Stream();
+		/// Restarts the stream from a seed.
+		void seed(uint64_t seed);
+		/// Gets the seed the stream was started from.
+		uint64_t getSeed() const;
+		/// Generates the next raw 64-bit number.
+		uint64_t next();
+		/// Generates a random integer number, inclusive.
+		int generate(int min, int max);
+		/// Generates a random floating-point number.
+		double generate(double min, double max);
+		/// Get normally distributed value.
+		double boxMuller(double m = 0, double s = 1);
+		/// Generates a percentage chance.
+		bool percent(int value);
+		/// Generates a random integer number, exclusive.
+		int generateEx(int max);
+		/// Splits off a new independent stream.
+		Stream split();
+		/// Gets a numbered sub-stream of this stream's seed.
+		Stream substream(uint64_t index) const;
+		/// Loads the stream from YAML.
+		void load(const YAML::Node& node);
+		/// Saves the stream to YAML.
+		YAML::Node save() const;
+	};
+
+	/**
+	 * Makes a stream the one the free functions draw from
+	 * until the scope ends, then restores the previous one.
+	 */
+	class StreamScope
+	{
+	private:
+		Stream *_previous;
+	public:
+		/// Switches to a stream.
+		StreamScope(Stream *stream);
+		/// Switches back to the previous stream.
+		~StreamScope();
+	};
+
+	/// Gets the stream the free functions draw from.
+	Stream *getStream();
+	/// Sets the stream the free functions draw from.
+	void setStream(Stream *stream);
 	/// Gets the seed in use.
 	uint64_t getSeed();
 	/// Sets the seed in use.
@@ -47,6 +111,8 @@ namespace RNG
 	bool percent(int value);
 	/// Generates a random integer number, exclusive.
 	int generateEx(int max);
+	/// Splits off a new independent stream.
+	Stream split();
 	/// Shuffles a list randomly.
 	/**
 	 * Randomly changes the orders of the elements in a list.
@@ -501,3 +501,78 @@ void scale(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_
 	}
 }
 
+/**
+ * Apply the Scale effect on a horizontal band of a bitmap.
+ * Only the destination rows produced by the source rows [first, last) are written,
+ * the source rows around the band are read exactly as the whole bitmap would read them,
+ * so bands of the same bitmap can be scaled independently and give the same result.
+ * \param scale Scale factor. 2, 203 (fox 2x3), 204 (for 2x4), 3 or 4.
+ * \param void_dst Pointer at the first pixel of the destination bitmap.
+ * \param dst_slice Size in bytes of a destination bitmap row.
+ * \param void_src Pointer at the first pixel of the source bitmap.
+ * \param src_slice Size in bytes of a source bitmap row.
+ * \param pixel Bytes per pixel of the source and destination bitmap.
+ * \param width Horizontal size in pixels of the source bitmap.
+ * \param height Vertical size in pixels of the source bitmap.
+ * \param first First source row of the band.
+ * \param last Source row after the end of the band.
+ */
+void scale_rows(unsigned scale, void* void_dst, unsigned dst_slice, const void* void_src, unsigned src_slice, unsigned pixel, unsigned width, unsigned height, unsigned first, unsigned last)
+{
+	unsigned char* dst = (unsigned char*)void_dst;
+	const unsigned char* src = (const unsigned char*)void_src;
+	unsigned y;
+
+	switch (scale) {
+	case 202 :
+	case 2 :
+		for (y = first; y < last; ++y)
+			stage_scale2x(SCDST(2*y), SCDST(2*y+1), SCSRC(y > 0 ? y-1 : 0), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		break;
+	case 203 :
+		for (y = first; y < last; ++y)
+			stage_scale2x3(SCDST(3*y), SCDST(3*y+1), SCDST(3*y+2), SCSRC(y > 0 ? y-1 : 0), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		break;
+	case 204 :
+		for (y = first; y < last; ++y)
+			stage_scale2x4(SCDST(4*y), SCDST(4*y+1), SCDST(4*y+2), SCDST(4*y+3), SCSRC(y > 0 ? y-1 : 0), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		break;
+	case 303 :
+	case 3 :
+		for (y = first; y < last; ++y)
+			stage_scale3x(SCDST(3*y), SCDST(3*y+1), SCDST(3*y+2), SCSRC(y > 0 ? y-1 : 0), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+		break;
+	case 404 :
+	case 4 :
+		{
+			/* the band needs the intermediate 2x rows [2*first-1, 2*last+1), clamped to the intermediate bitmap */
+			unsigned mid_slice = (2 * pixel * width + 0x7) & ~0x7;
+			unsigned mid_base = first > 0 ? first-1 : 0;
+			unsigned mid_end = last < height ? last+1 : height;
+			unsigned char* mid = (unsigned char*)malloc(2 * (mid_end - mid_base) * mid_slice);
+			unsigned m;
+
+			if (!mid)
+				return;
+
+			/* intermediate rows 2*y and 2*y+1 come from source row y */
+			for (y = mid_base; y < mid_end; ++y)
+				stage_scale2x(mid + 2*(y - mid_base) * mid_slice, mid + (2*(y - mid_base) + 1) * mid_slice, SCSRC(y > 0 ? y-1 : 0), SCSRC(y), SCSRC(y+1 < height ? y+1 : y), pixel, width);
+
+			for (m = 2*first; m < 2*last; m += 2) {
+				unsigned m0 = m > 0 ? m-1 : 0;
+				unsigned m3 = m+2 < 2*height ? m+2 : m+1;
+				stage_scale4x(SCDST(2*m), SCDST(2*m+1), SCDST(2*m+2), SCDST(2*m+3),
+					mid + (m0 - 2*mid_base) * mid_slice, mid + (m - 2*mid_base) * mid_slice,
+					mid + (m+1 - 2*mid_base) * mid_slice, mid + (m3 - 2*mid_base) * mid_slice, pixel, width);
+			}
+
+			free(mid);
+		}
+		break;
+	}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	scale2x_mmx_emms();
+#endif
+}
@@ -106,19 +106,52 @@ void Screen::makeVideoFlags()
 /**
  * Initializes a new display screen for the game to render contents to.
  * The screen is set up based on the current options.
+ * If asynchronous presentation is enabled, a presenter thread
+ * is started to scale finished frames while the next one is drawn.
+ * @param pool Thread pool to run the software scalers on.
  */
-Screen::Screen() : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0)
+Screen::Screen(ThreadPool *pool) : _baseWidth(ORIGINAL_WIDTH), _baseHeight(ORIGINAL_HEIGHT), _scaleX(1.0), _scaleY(1.0), _flags(0), _numColors(0), _firstColor(0), _pushPalette(false), _surface(0), _pool(pool),
+	_frame(0), _scaled(0), _presenter(0), _presentMutex(0), _presentCond(0), _presentState(PRESENT_IDLE), _presentQuit(false), _presented(false), _flipTime(0), _presentTime(0), _frameNumColors(0), _frameFirstColor(0)
 {
 	resetDisplay();	
 	memset(deferredPalette, 0, 256*sizeof(SDL_Color));
+	if (Options::asyncPresent)
+	{
+		_presentMutex = SDL_CreateMutex();
+		_presentCond = SDL_CreateCond();
+		if (_presentMutex != 0 && _presentCond != 0)
+		{
+			_presenter = SDL_CreateThread(presenter, (void*)this);
+		}
+		if (_presenter == 0)
+		{
+			Log(LOG_WARNING) << "Couldn't create presenter thread: " << SDL_GetError();
+		}
+	}
 }
 
 /**
- * Deletes the buffer from memory. The display screen itself
- * is automatically freed once SDL shuts down.
+ * Stops the presenter thread and deletes the buffers from memory.
+ * The display screen itself is automatically freed once SDL shuts down.
  */
 Screen::~Screen()
 {
+	if (_presenter != 0)
+	{
+		SDL_mutexP(_presentMutex);
+		_presentQuit = true;
+		SDL_CondBroadcast(_presentCond);
+		SDL_mutexV(_presentMutex);
+		SDL_WaitThread(_presenter, 0);
+	}
+	if (_presentCond != 0)
+		SDL_DestroyCond(_presentCond);
+	if (_presentMutex != 0)
+		SDL_DestroyMutex(_presentMutex);
+	if (_frame != 0)
+		SDL_FreeSurface(_frame);
+	if (_scaled != 0)
+		SDL_FreeSurface(_scaled);
 	delete _surface;
 }
 
@@ -168,6 +201,7 @@ void Screen::handle(Action *action)
 			i++;
 		}
 		while (CrossPlatform::fileExists(ss.str()));
+		finishPresent();
 		screenshot(ss.str());
 		return;
 	}
@@ -179,44 +213,229 @@ void Screen::handle(Action *action)
  * any necessary filters or conversions in the process.
  * If the scaling factor is bigger than 1, the entire contents
  * of the buffer are resized by that factor (eg. 2 = doubled)
- * before being put on screen.
+ * before being put on screen. Software scaled frames are handed
+ * to the presenter thread, so the caller can get on with the
+ * next one unless it has to wait for this one to be shown.
+ * @param wait Wait for the frame to reach the display.
  */
-void Screen::flip()
+void Screen::flip(bool wait)
 {
+	if (isPresenterUsed())
+	{
+		// the presenter must be done with the last frame before it gets the next one
+		finishPresent();
+		_flipTime = SDL_GetTicks();
+
+		SDL_Surface *src = _surface->getSurface();
+		for (int y = 0; y < src->h; ++y)
+		{
+			memcpy((Uint8*)_frame->pixels + y * _frame->pitch, (Uint8*)src->pixels + y * src->pitch, src->w * src->format->BytesPerPixel);
+		}
+		if (src->format->palette != 0 && memcmp(_frame->format->palette->colors, src->format->palette->colors, src->format->palette->ncolors * sizeof(SDL_Color)) != 0)
+		{
+			SDL_SetPalette(_frame, SDL_LOGPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
+		}
+		takePalette();
+
+		SDL_mutexP(_presentMutex);
+		_presentState = PRESENT_QUEUED;
+		SDL_CondBroadcast(_presentCond);
+		SDL_mutexV(_presentMutex);
+		if (wait)
+		{
+			finishPresent();
+		}
+		return;
+	}
+
+	_flipTime = SDL_GetTicks();
 	if (getWidth() != _baseWidth || getHeight() != _baseHeight || isOpenGLEnabled())
 	{
-		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput);
+		Zoom::flipWithZoom(_surface->getSurface(), _screen, _topBlackBand, _bottomBlackBand, _leftBlackBand, _rightBlackBand, &glOutput, _pool);
 	}
 	else
 	{
 		SDL_BlitSurface(_surface->getSurface(), 0, _screen, 0);
 	}
+	takePalette();
+	showFrame(false);
+}
 
-	// perform any requested palette update
-	if (_pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
+/**
+ * Shows the last frame handed to the presenter thread if it's
+ * done scaling it. Must be called regularly by the main loop,
+ * as only the main thread may flip the display.
+ * @return True if a frame reached the display since the last call.
+ */
+bool Screen::present()
+{
+	if (_presenter != 0)
 	{
-		if (_screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, &(deferredPalette[_firstColor]), _firstColor, _numColors) == 0)
+		SDL_mutexP(_presentMutex);
+		bool scaled = (_presentState == PRESENT_SCALED);
+		if (scaled)
 		{
-			Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
+			_presentState = PRESENT_IDLE;
 		}
+		SDL_mutexV(_presentMutex);
+		if (scaled)
+		{
+			showFrame(true);
+		}
+	}
+	bool presented = _presented;
+	_presented = false;
+	return presented;
+}
+
+/**
+ * Returns how long the last frame that reached the display
+ * took from being handed to flip() until it was shown,
+ * whether it was scaled on the presenter thread or not.
+ * @return Time in milliseconds.
+ */
+Uint32 Screen::getPresentTime() const
+{
+	return _presentTime;
+}
+
+/**
+ * Keeps the presenter thread scaling handed off frames into
+ * its own software surface until the screen is destroyed.
+ * It never touches the display surface, SDL 1.2 video calls
+ * are only safe from the main thread.
+ * @param screen Pointer to the screen.
+ * @return Thread exit code.
+ */
+int Screen::presenter(void *screen)
+{
+	Screen *self = (Screen*)screen;
+	SDL_mutexP(self->_presentMutex);
+	while (!self->_presentQuit)
+	{
+		if (self->_presentState == PRESENT_QUEUED)
+		{
+			SDL_mutexV(self->_presentMutex);
+			Zoom::_zoomSurfaceY(self->_frame, self->_scaled, 0, 0, self->_pool);
+			SDL_mutexP(self->_presentMutex);
+			self->_presentState = PRESENT_SCALED;
+			SDL_CondBroadcast(self->_presentCond);
+		}
+		else
+		{
+			SDL_CondWait(self->_presentCond, self->_presentMutex);
+		}
+	}
+	SDL_mutexV(self->_presentMutex);
+	return 0;
+}
+
+/**
+ * Checks if frames are handed to the presenter thread. Only
+ * software scaled frames are, OpenGL has to stay on the main
+ * thread and unscaled frames are just a blit.
+ * @return True if the presenter thread is used.
+ */
+bool Screen::isPresenterUsed() const
+{
+	return _presenter != 0 && _frame != 0 && _scaled != 0 && !isOpenGLEnabled() && (_scaled->w != _frame->w || _scaled->h != _frame->h);
+}
+
+/**
+ * Takes any requested palette update so it's
+ * applied along with the frame being presented.
+ */
+void Screen::takePalette()
+{
+	if (_pushPalette && _numColors && _screen->format->BitsPerPixel == 8)
+	{
+		memcpy(&(_framePalette[_firstColor]), &(deferredPalette[_firstColor]), _numColors * sizeof(SDL_Color));
+		_frameFirstColor = _firstColor;
+		_frameNumColors = _numColors;
 		_numColors = 0;
 		_pushPalette = false;
 	}
+}
+
+/**
+ * Performs the palette update taken with the frame
+ * and flips the scaled frame onto the display.
+ * @param scaled Was the frame scaled by the presenter thread?
+ * Then it still has to be put between the black bands.
+ */
+void Screen::showFrame(bool scaled)
+{
+	if (_frameNumColors && _screen->format->BitsPerPixel == 8)
+	{
+		if (SDL_SetColors(_screen, &(_framePalette[_frameFirstColor]), _frameFirstColor, _frameNumColors) == 0)
+		{
+			Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
+		}
+		_frameNumColors = 0;
+	}
 
+	if (scaled)
+	{
+		clearDisplay();
+		// same palette on both ends so the blit copies the color indexes as they are
+		SDL_Palette *palette = _screen->format->palette;
+		if (palette != 0 && memcmp(_scaled->format->palette->colors, palette->colors, palette->ncolors * sizeof(SDL_Color)) != 0)
+		{
+			SDL_SetPalette(_scaled, SDL_LOGPAL, palette->colors, 0, palette->ncolors);
+		}
+		SDL_Rect dstrect = {(Sint16)_leftBlackBand, (Sint16)_topBlackBand, (Uint16)_scaled->w, (Uint16)_scaled->h};
+		SDL_BlitSurface(_scaled, 0, _screen, &dstrect);
+	}
 
-	
 	if (SDL_Flip(_screen) == -1)
 	{
 		throw Exception(SDL_GetError());
 	}
+	_presentTime = SDL_GetTicks() - _flipTime;
+	_presented = true;
+}
+
+/**
+ * Waits for the presenter thread to finish scaling the
+ * frame it was handed, if any, and shows it, so the
+ * display surface can be safely used again.
+ */
+void Screen::finishPresent()
+{
+	if (_presenter == 0)
+		return;
+	SDL_mutexP(_presentMutex);
+	while (_presentState == PRESENT_QUEUED)
+	{
+		SDL_CondWait(_presentCond, _presentMutex);
+	}
+	bool scaled = (_presentState == PRESENT_SCALED);
+	_presentState = PRESENT_IDLE;
+	SDL_mutexV(_presentMutex);
+	if (scaled)
+	{
+		showFrame(true);
+	}
 }
 
 /**
  * Clears all the contents out of the internal buffer.
+ * The display is left to the presenter thread if it's used.
  */
 void Screen::clear()
 {
 	_surface->clear();
+	if (!isPresenterUsed())
+	{
+		clearDisplay();
+	}
+}
+
+/**
+ * Clears the display surface, including the black bands around the frame.
+ */
+void Screen::clearDisplay()
+{
 	if (_screen->flags & SDL_SWSURFACE) memset(_screen->pixels, 0, _screen->h*_screen->pitch);
 	else SDL_FillRect(_screen, &_clear, 0);
 }
@@ -247,6 +466,10 @@ void Screen::setPalette(SDL_Color* colors, int firstcolor, int ncolors, bool imm
 	_surface->setPalette(colors, firstcolor, ncolors);
 
 	// defer actual update of screen until SDL_Flip()
+	if (immediately && _screen->format->BitsPerPixel == 8)
+	{
+		finishPresent();
+	}
 	if (immediately && _screen->format->BitsPerPixel == 8 && SDL_SetColors(_screen, colors, firstcolor, ncolors) == 0)
 	{
 		Log(LOG_DEBUG) << "Display palette doesn't match requested palette";
@@ -310,6 +533,7 @@ void Screen::resetDisplay(bool resetVideo)
 	Uint32 oldFlags = _flags;
 #endif
 	makeVideoFlags();
+	finishPresent();
 
 	if (!_surface || (_surface && 
 		(_surface->getSurface()->format->BitsPerPixel != _bpp || 
@@ -321,6 +545,12 @@ void Screen::resetDisplay(bool resetVideo)
 		if (_surface->getSurface()->format->BitsPerPixel == 8) _surface->setPalette(deferredPalette);
 	}
 	SDL_SetColorKey(_surface->getSurface(), 0, 0); // turn off color key! 
+	if (_frame == 0 || _frame->format->BitsPerPixel != _surface->getSurface()->format->BitsPerPixel || _frame->w != _surface->getSurface()->w || _frame->h != _surface->getSurface()->h)
+	{
+		if (_frame != 0) SDL_FreeSurface(_frame);
+		// the copy of the frame handed to the presenter thread
+		_frame = SDL_ConvertSurface(_surface->getSurface(), _surface->getSurface()->format, SDL_SWSURFACE);
+	}
 
 	if (resetVideo || _screen->format->BitsPerPixel != _bpp)
 	{
@@ -455,6 +685,16 @@ void Screen::resetDisplay(bool resetVideo)
 #endif
 	}
 
+	int scaledWidth = getWidth() - _leftBlackBand - _rightBlackBand;
+	int scaledHeight = getHeight() - _topBlackBand - _bottomBlackBand;
+	if (_scaled == 0 || _scaled->format->BitsPerPixel != _screen->format->BitsPerPixel || _scaled->w != scaledWidth || _scaled->h != scaledHeight)
+	{
+		if (_scaled != 0) SDL_FreeSurface(_scaled);
+		// the presenter thread scales into this, the main thread puts it on the display
+		SDL_PixelFormat *format = _screen->format;
+		_scaled = SDL_CreateRGBSurface(SDL_SWSURFACE, scaledWidth, scaledHeight, format->BitsPerPixel, format->Rmask, format->Gmask, format->Bmask, format->Amask);
+	}
+
 	if (_screen->format->BitsPerPixel == 8)
 	{
 		setPalette(getPalette());
@@ -28,6 +28,7 @@ namespace OpenXcom
 
 class Surface;
 class Action;
+class ThreadPool;
 
 /**
  * A display screen, handles rendering onto the game window.
@@ -53,14 +54,37 @@ private:
 	OpenGL glOutput;
 	Surface *_surface;
 	SDL_Rect _clear;
+	ThreadPool *_pool;
+	enum PresentState { PRESENT_IDLE, PRESENT_QUEUED, PRESENT_SCALED };
+	SDL_Surface *_frame, *_scaled;
+	SDL_Thread *_presenter;
+	SDL_mutex *_presentMutex;
+	SDL_cond *_presentCond;
+	PresentState _presentState;
+	bool _presentQuit, _presented;
+	Uint32 _flipTime, _presentTime;
+	SDL_Color _framePalette[256];
+	int _frameNumColors, _frameFirstColor;
 	/// Sets the _flags and _bpp variables based on game options; needed in more than one place now
 	void makeVideoFlags();
+	/// Entry point of the presenter thread.
+	static int presenter(void *screen);
+	/// Checks if frames are scaled on the presenter thread.
+	bool isPresenterUsed() const;
+	/// Takes the pending palette update for the next frame.
+	void takePalette();
+	/// Shows the scaled frame on the display.
+	void showFrame(bool scaled);
+	/// Waits for the frame being scaled and shows it.
+	void finishPresent();
+	/// Clears the display surface.
+	void clearDisplay();
 public:
 	static const int ORIGINAL_WIDTH;
 	static const int ORIGINAL_HEIGHT;
 
 	/// Creates a new display screen.
-	Screen();
+	Screen(ThreadPool *pool = 0);
 	/// Cleans up the display screen.
 	~Screen();
 	/// Get horizontal offset.
@@ -72,7 +96,11 @@ public:
 	/// Handles keyboard events.
 	void handle(Action *action);
 	/// Renders the screen onto the game window.
-	void flip();
+	void flip(bool wait = true);
+	/// Shows the last frame once the presenter is done with it.
+	bool present();
+	/// Gets how long the last frame took to reach the display.
+	Uint32 getPresentTime() const;
 	/// Clears the screen.
 	void clear();
 	/// Sets the screen's 8bpp palette.
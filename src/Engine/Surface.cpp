@@ -20,6 +20,7 @@
 #include "Screen.h"
 #include "ShaderDraw.h"
 #include <vector>
+#include <algorithm>
 #include <fstream>
 #include <SDL_gfxPrimitives.h>
 #include <SDL_image.h>
@@ -199,6 +200,8 @@ Surface::Surface(const Surface& other)
 	_visible = other._visible;
 	_hidden = other._hidden;
 	_redraw = other._redraw;
+	_spans = other._spans;
+	_spanRows = other._spanRows;
 }
 
 /**
@@ -219,6 +222,7 @@ Surface::~Surface()
  */
 void Surface::loadScr(const std::string &filename)
 {
+	clearSpans();
 	// Load file and put pixels in surface
 	std::ifstream imgFile(filename.c_str(), std::ios::binary);
 	if (!imgFile)
@@ -249,6 +253,7 @@ void Surface::loadScr(const std::string &filename)
  */
 void Surface::loadImage(const std::string &filename)
 {
+	clearSpans();
 	// Destroy current surface (will be replaced)
 	DeleteAligned(_alignedBuffer);
 	SDL_FreeSurface(_surface);
@@ -277,6 +282,7 @@ void Surface::loadImage(const std::string &filename)
  */
 void Surface::loadSpk(const std::string &filename)
 {
+	clearSpans();
 	// Load file and put pixels in surface
 	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
 	if (!imgFile)
@@ -333,6 +339,7 @@ void Surface::loadSpk(const std::string &filename)
  */
 void Surface::loadBdy(const std::string &filename)
 {
+	clearSpans();
 	// Load file and put pixels in surface
 	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
 	if (!imgFile)
@@ -388,6 +395,7 @@ void Surface::loadBdy(const std::string &filename)
  */
 void Surface::clear(Uint32 color)
 {
+	clearSpans();
 	if (_surface->flags & SDL_SWSURFACE) memset(_surface->pixels, color, _surface->h*_surface->pitch);
 	else SDL_FillRect(_surface, &_clear, color);
 }
@@ -451,6 +459,7 @@ void Surface::offset(int off, int min, int max, int mul)
  */
 void Surface::invert(Uint8 mid)
 {
+	clearSpans();
 	// Lock the surface
 	lock();
 
@@ -792,10 +801,49 @@ struct StandartShade
 
 
 
+/**
+ * Applies a shade function to the opaque runs of a surface,
+ * skipping over the transparent parts entirely.
+ * @param spans Run start/end pairs of all rows.
+ * @param rows Offset of each row's runs in @a spans.
+ * @param src Source surface.
+ * @param dest Destination surface.
+ * @param x Destination X of the source's left edge.
+ * @param y Destination Y of the source's top edge.
+ * @param beginX First source column to draw.
+ * @param off Shade offset.
+ * @param color New base color.
+ */
+template<typename ColorFunc>
+static void blitSpans(const std::vector<Uint16> &spans, const std::vector<Uint32> &rows, SDL_Surface *src, SDL_Surface *dest, int x, int y, int beginX, int off, int color)
+{
+	const int notUsed = 0;
+	const SDL_Rect &clip = dest->clip_rect;
+	const int endX = std::min(src->w, clip.x + clip.w - x);
+	beginX = std::max(beginX, clip.x - x);
+	const int beginY = std::max(0, clip.y - y);
+	const int endY = std::min(src->h, clip.y + clip.h - y);
+	for (int row = beginY; row < endY; ++row)
+	{
+		const Uint8 *s = (const Uint8*)src->pixels + row * src->pitch;
+		Uint8 *d = (Uint8*)dest->pixels + (row + y) * dest->pitch + x;
+		for (Uint32 i = rows[row]; i < rows[row + 1]; i += 2)
+		{
+			const int end = std::min((int)spans[i + 1], endX);
+			for (int j = std::max((int)spans[i], beginX); j < end; ++j)
+			{
+				ColorFunc::func(d[j], s[j], off, color, notUsed);
+			}
+		}
+	}
+}
+
 /**
  * Specific blit function to blit battlescape terrain data in different shades in a fast way.
  * Notice there is no surface locking here - you have to make sure you lock the surface yourself
  * at the start of blitting and unlock it when done.
+ * Surfaces with encoded runs (see buildSpans()) only visit their opaque pixels.
+ * Only the clipping rectangle of the target's SDL surface is drawn to.
  * @param surface to blit to
  * @param x
  * @param y
@@ -805,6 +853,21 @@ struct StandartShade
  */
 void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int newBaseColor)
 {
+	if (!_spanRows.empty())
+	{
+		int dx = x - surface->getX(), dy = y - surface->getY();
+		int beginX = half ? getWidth() / 2 : 0;
+		if (newBaseColor)
+		{
+			blitSpans<ColorReplace>(_spans, _spanRows, _surface, surface->getSurface(), dx, dy, beginX, off, (newBaseColor - 1) << 4);
+		}
+		else
+		{
+			blitSpans<StandartShade>(_spans, _spanRows, _surface, surface->getSurface(), dx, dy, beginX, off, 0);
+		}
+		return;
+	}
+
 	ShaderMove<Uint8> src(this, x, y);
 	if(half)
 	{
@@ -812,15 +875,63 @@ void Surface::blitNShade(Surface *surface, int x, int y, int off, bool half, int
 		g.beg_x = g.end_x/2;
 		src.setDomain(g);
 	}
+	ShaderMove<Uint8> dest(surface);
+	const SDL_Rect &clip = surface->getSurface()->clip_rect;
+	dest.setDomain(GraphSubset(std::make_pair(clip.x, clip.x + clip.w), std::make_pair(clip.y, clip.y + clip.h)));
 	if(newBaseColor)
 	{
 		--newBaseColor;
 		newBaseColor <<= 4;
-		ShaderDraw<ColorReplace>(ShaderSurface(surface), src, ShaderScalar(off), ShaderScalar(newBaseColor));
+		ShaderDraw<ColorReplace>(dest, src, ShaderScalar(off), ShaderScalar(newBaseColor));
 	}
 	else
-		ShaderDraw<StandartShade>(ShaderSurface(surface), src, ShaderScalar(off));
+		ShaderDraw<StandartShade>(dest, src, ShaderScalar(off));
+
+}
+
+/**
+ * Encodes every row of the surface as a list of runs of
+ * non-transparent pixels, so blitNShade() can skip the
+ * transparent parts. Meant for sprites that don't change
+ * after loading; any later pixel change made without going
+ * through the surface's own loading/clearing functions has
+ * to be followed by another call to this.
+ */
+void Surface::buildSpans()
+{
+	clearSpans();
+	if (_surface->format->BitsPerPixel != 8)
+	{
+		return;
+	}
+	_spanRows.reserve(getHeight() + 1);
+	for (int y = 0; y < getHeight(); ++y)
+	{
+		_spanRows.push_back(_spans.size());
+		const Uint8 *row = (const Uint8*)_surface->pixels + y * _surface->pitch;
+		for (int x = 0; x < getWidth();)
+		{
+			while (x < getWidth() && row[x] == 0)
+				++x;
+			if (x == getWidth())
+				break;
+			_spans.push_back(x);
+			while (x < getWidth() && row[x] != 0)
+				++x;
+			_spans.push_back(x);
+		}
+	}
+	_spanRows.push_back(_spans.size());
+}
 
+/**
+ * Drops the encoded runs, making blitNShade()
+ * go through every pixel of the surface again.
+ */
+void Surface::clearSpans()
+{
+	_spans.clear();
+	_spanRows.clear();
 }
 
 /**
@@ -860,6 +971,7 @@ void Surface::setTooltip(const std::string &tooltip)
  */
 void Surface::resize(int width, int height)
 {
+	clearSpans();
 	// Set up new surface
 	Uint8 bpp = _surface->format->BitsPerPixel;
 	int pitch = GetPitch(bpp, width);
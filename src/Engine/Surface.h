@@ -22,6 +22,7 @@
 #include <SDL.h>
 #include <SDL_image.h>
 #include <string>
+#include <vector>
 
 namespace OpenXcom
 {
@@ -45,6 +46,8 @@ protected:
 	bool _visible, _hidden, _redraw;
 	void *_alignedBuffer;
 	std::string _tooltip;
+	std::vector<Uint16> _spans;
+	std::vector<Uint32> _spanRows;
 
 	void resize(int width, int height);
 public:
@@ -92,6 +95,10 @@ public:
     void drawTexturedPolygon(Sint16 *x, Sint16 *y, int n, Surface *texture, int dx, int dy);
     /// Draws a string on the surface.
     void drawString(Sint16 x, Sint16 y, const char *s, Uint8 color);
+	/// Encodes the opaque pixel runs of each row.
+	void buildSpans();
+	/// Drops the opaque pixel runs.
+	void clearSpans();
 	/// Sets the surface's palette.
 	virtual void setPalette(SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
 	/**
@@ -17,10 +17,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "SurfaceSet.h"
+#include <cstring>
 #include <SDL_endian.h>
-#include <fstream>
 #include "Surface.h"
 #include "Exception.h"
+#include "FileMap.h"
 
 namespace OpenXcom
 {
@@ -30,7 +31,7 @@ namespace OpenXcom
  * @param width Frame width in pixels.
  * @param height Frame height in pixels.
  */
-SurfaceSet::SurfaceSet(int width, int height) : _width(width), _height(height), _frames()
+SurfaceSet::SurfaceSet(int width, int height) : _width(width), _height(height), _frames(), _totalFrames(0)
 {
 
 }
@@ -43,10 +44,15 @@ SurfaceSet::SurfaceSet(const SurfaceSet& other)
 {
 	_width = other._width;
 	_height = other._height;
-	
-	for (std::map<int, Surface*>::const_iterator f = other._frames.begin(); f != other._frames.end(); ++f)
+	_totalFrames = other._totalFrames;
+
+	_frames.resize(other._frames.size(), 0);
+	for (size_t i = 0; i < other._frames.size(); ++i)
 	{
-		_frames[f->first] = new Surface(*f->second);
+		if (other._frames[i])
+		{
+			_frames[i] = new Surface(*other._frames[i]);
+		}
 	}
 }
 
@@ -55,9 +61,9 @@ SurfaceSet::SurfaceSet(const SurfaceSet& other)
  */
 SurfaceSet::~SurfaceSet()
 {
-	for (std::map<int, Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
+	for (std::vector<Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
 	{
-		delete i->second;
+		delete *i;
 	}
 }
 
@@ -65,7 +71,8 @@ SurfaceSet::~SurfaceSet()
  * Loads the contents of an X-Com set of PCK/TAB image files
  * into the surface. The PCK file contains an RLE compressed
  * image, while the TAB file contains the offsets to each
- * frame in the image.
+ * frame in the image. The runs of transparent pixels
+ * are kept encoded in the frames after decoding.
  * @param pck Filename of the PCK image.
  * @param tab Filename of the TAB offsets.
  * @sa http://www.ufopaedia.org/index.php?title=Image_Formats#PCK
@@ -77,74 +84,78 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
 	// Load TAB and get image offsets
 	if (!tab.empty())
 	{
-		std::ifstream offsetFile(tab.c_str(), std::ios::in | std::ios::binary);
+		FileMap offsetFile(tab);
 		if (!offsetFile)
 		{
 			throw Exception(tab + " not found");
 		}
-		Uint16 off;
-		while (offsetFile.read((char*) &off, sizeof(off)))
+		nframes = offsetFile.getSize() / sizeof(Uint16);
+		for (int i = 0; i < nframes; ++i)
 		{
-			off = SDL_SwapLE16(off);
-			Surface *surface = new Surface(_width, _height);
-			_frames[nframes] = surface;
-			nframes++;
+			addFrame(i);
 		}
-		offsetFile.close();
 	}
 	else
 	{
 		nframes = 1;
-		Surface *surface = new Surface(_width, _height);
-		_frames[0] = surface;
+		addFrame(0);
 	}
 
 	// Load PCX and put pixels in surfaces
-	std::ifstream imgFile (pck.c_str(), std::ios::in | std::ios::binary);
+	FileMap imgFile(pck);
 	if (!imgFile)
 	{
 		throw Exception(pck + " not found");
 	}
 
-	Uint8 value;
+	const Uint8 *data = imgFile.getData();
+	const Uint8 *end = data + imgFile.getSize();
 
-	for (int frame = 0; frame < nframes; frame++)
+	for (int frame = 0; frame < nframes && data < end; frame++)
 	{
+		// New frames start out transparent, so skipped pixels can be left alone
 		int x = 0, y = 0;
 
 		// Lock the surface
 		_frames[frame]->lock();
+		SDL_Surface *surface = _frames[frame]->getSurface();
+		Uint8 *pixels = (Uint8*)surface->pixels;
+
+		y = *data++;
 
-		imgFile.read((char*)&value, 1);
-		for (int i = 0; i < value; ++i)
+		while (data < end)
 		{
-			for (int j = 0; j < _width; ++j)
+			Uint8 value = *data++;
+			if (value == 255)
 			{
-				_frames[frame]->setPixelIterative(&x, &y, 0);
+				break;
 			}
-		}
-
-		while (imgFile.read((char*)&value, 1) && value != 255)
-		{
-			if (value == 254)
+			else if (value == 254)
 			{
-				imgFile.read((char*)&value, 1);
-				for (int i = 0; i < value; ++i)
-				{
-					_frames[frame]->setPixelIterative(&x, &y, 0);
-				}
+				if (data == end)
+					break;
+				x += *data++;
+				y += x / _width;
+				x %= _width;
 			}
 			else
 			{
-				_frames[frame]->setPixelIterative(&x, &y, value);
+				if (y < _height)
+				{
+					pixels[y * surface->pitch + x] = value;
+				}
+				if (++x == _width)
+				{
+					x = 0;
+					++y;
+				}
 			}
 		}
 
 		// Unlock the surface
 		_frames[frame]->unlock();
+		_frames[frame]->buildSpans();
 	}
-
-	imgFile.close();
 }
 
 /**
@@ -157,54 +168,33 @@ void SurfaceSet::loadPck(const std::string &pck, const std::string &tab)
  */
 void SurfaceSet::loadDat(const std::string &filename)
 {
-	int nframes = 0;
-
 	// Load file and put pixels in surface
-	std::ifstream imgFile (filename.c_str(), std::ios::in | std::ios::binary);
+	FileMap imgFile(filename);
 	if (!imgFile)
 	{
 		throw Exception(filename + " not found");
 	}
 
-	imgFile.seekg(0, std::ios::end);
-	std::streamoff size = imgFile.tellg();
-	imgFile.seekg(0, std::ios::beg);
-
-	nframes = (int)size / (_width * _height);
-
-	for (int i = 0; i < nframes; ++i)
-	{
-		Surface *surface = new Surface(_width, _height);
-		_frames[i] = surface;
-	}
-
-	Uint8 value;
-	int x = 0, y = 0, frame = 0;
+	int nframes = imgFile.getSize() / (_width * _height);
+	const Uint8 *data = imgFile.getData();
 
-	// Lock the surface
-	_frames[frame]->lock();
-
-	while (imgFile.read((char*)&value, 1))
+	for (int frame = 0; frame < nframes; ++frame)
 	{
-		_frames[frame]->setPixelIterative(&x, &y, value);
+		addFrame(frame);
 
-		if (y >= _height)
+		// Lock the surface
+		_frames[frame]->lock();
+		SDL_Surface *surface = _frames[frame]->getSurface();
+		for (int y = 0; y < _height; ++y)
 		{
-			// Unlock the surface
-			_frames[frame]->unlock();
-
-			frame++;
-			x = 0;
-			y = 0;
-
-			if (frame >= nframes)
-				break;
-			else
-				_frames[frame]->lock();
+			memcpy((Uint8*)surface->pixels + y * surface->pitch, data, _width);
+			data += _width;
 		}
+		// Unlock the surface
+		_frames[frame]->unlock();
 	}
 
-	imgFile.close();
+	buildSpans();
 }
 
 /**
@@ -214,7 +204,7 @@ void SurfaceSet::loadDat(const std::string &filename)
  */
 Surface *SurfaceSet::getFrame(int i)
 {
-	if (_frames.find(i) != _frames.end())
+	if (i >= 0 && (size_t)i < _frames.size())
 	{
 		return _frames[i];
 	}
@@ -222,13 +212,39 @@ Surface *SurfaceSet::getFrame(int i)
 }
 
 /**
- * Creates and returns a particular frame in the surface set.
+ * Creates and returns a particular frame in the surface set,
+ * replacing any frame already there.
  * @param i Frame number in the set.
  * @return Pointer to the respective surface.
  */
 Surface *SurfaceSet::addFrame(int i)
 {
-	_frames[i] = new Surface(_width, _height);
+	return setFrame(i, new Surface(_width, _height));
+}
+
+/**
+ * Puts an existing surface in the set as a particular frame,
+ * replacing any frame already there. The set takes
+ * ownership of the surface.
+ * @param i Frame number in the set.
+ * @param frame Pointer to the surface.
+ * @return Pointer to the respective surface.
+ */
+Surface *SurfaceSet::setFrame(int i, Surface *frame)
+{
+	if ((size_t)i >= _frames.size())
+	{
+		_frames.resize(i + 1, 0);
+	}
+	if (_frames[i])
+	{
+		delete _frames[i];
+	}
+	else
+	{
+		_totalFrames++;
+	}
+	_frames[i] = frame;
 	return _frames[i];
 }
 
@@ -257,7 +273,7 @@ int SurfaceSet::getHeight() const
  */
 size_t SurfaceSet::getTotalFrames() const
 {
-	return _frames.size();
+	return _totalFrames;
 }
 
 /**
@@ -268,13 +284,36 @@ size_t SurfaceSet::getTotalFrames() const
  */
 void SurfaceSet::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
-	for (std::map<int, Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
+	for (std::vector<Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
+	{
+		if (*i)
+		{
+			(*i)->setPalette(colors, firstcolor, ncolors);
+		}
+	}
+}
+
+/**
+ * Encodes the transparent runs of every frame again,
+ * after frames have been replaced or drawn over.
+ */
+void SurfaceSet::buildSpans()
+{
+	for (std::vector<Surface*>::iterator i = _frames.begin(); i != _frames.end(); ++i)
 	{
-		(*i).second->setPalette(colors, firstcolor, ncolors);
+		if (*i)
+		{
+			(*i)->buildSpans();
+		}
 	}
 }
 
-std::map<int, Surface*> *SurfaceSet::getFrames()
+/**
+ * Returns the frames of the set. Frame numbers
+ * that haven't been added are left empty.
+ * @return Pointer to the frames.
+ */
+std::vector<Surface*> *SurfaceSet::getFrames()
 {
 	return &_frames;
 }
@@ -20,7 +20,6 @@
 #define OPENXCOM_SURFACESET_H
 
 #include <vector>
-#include <map>
 #include <string>
 #include <SDL.h>
 
@@ -34,12 +33,15 @@ class Surface;
  * Used to manage single images that contain series of
  * frames inside, like animated sprites, making them easier
  * to access without constant cropping.
+ * Frames are indexed directly by number, with gaps left empty,
+ * and keep their transparent runs encoded for fast shaded blits.
  */
 class SurfaceSet
 {
 private:
 	int _width, _height;
-	std::map<int, Surface*> _frames;
+	std::vector<Surface*> _frames;
+	size_t _totalFrames;
 public:
 	/// Crates a surface set with frames of the specified size.
 	SurfaceSet(int width, int height);
@@ -55,6 +57,8 @@ public:
 	Surface *getFrame(int i);
 	/// Creates a new surface and returns a pointer to it.
 	Surface *addFrame(int i);
+	/// Puts an existing surface in the set.
+	Surface *setFrame(int i, Surface *frame);
 	/// Gets the width of all frames.
 	int getWidth() const;
 	/// Gets the height of all frames.
@@ -63,7 +67,10 @@ public:
 	size_t getTotalFrames() const;
 	/// Sets the surface set's palette.
 	void setPalette(SDL_Color *colors, int firstcolor = 0, int ncolors = 256);
-	std::map<int, Surface*> *getFrames();
+	/// Encodes the transparent runs of all frames.
+	void buildSpans();
+	/// Gets the frames of the set, indexed by frame number.
+	std::vector<Surface*> *getFrames();
 };
 
 }
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ThreadPool.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates the worker threads. If the system can't give us
+ * threads, batches are simply run on the calling thread.
+ * @param threads Number of worker threads besides the caller.
+ */
+ThreadPool::ThreadPool(int threads) : _mutex(0), _wake(0), _done(0), _job(0), _data(0), _count(0), _next(0), _pending(0), _quit(false)
+{
+	if (threads <= 0)
+		return;
+	_mutex = SDL_CreateMutex();
+	_wake = SDL_CreateCond();
+	_done = SDL_CreateCond();
+	if (_mutex == 0 || _wake == 0 || _done == 0)
+	{
+		Log(LOG_WARNING) << "Couldn't create worker threads: " << SDL_GetError();
+		return;
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		SDL_Thread *thread = SDL_CreateThread(worker, (void*)this);
+		if (thread == 0)
+		{
+			Log(LOG_WARNING) << "Couldn't create worker threads: " << SDL_GetError();
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+/**
+ * Wakes up the worker threads and waits for them to quit.
+ */
+ThreadPool::~ThreadPool()
+{
+	if (_mutex != 0)
+	{
+		SDL_mutexP(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_wake);
+		SDL_mutexV(_mutex);
+	}
+	for (std::vector<SDL_Thread*>::iterator i = _threads.begin(); i != _threads.end(); ++i)
+	{
+		SDL_WaitThread(*i, 0);
+	}
+	if (_done != 0)
+		SDL_DestroyCond(_done);
+	if (_wake != 0)
+		SDL_DestroyCond(_wake);
+	if (_mutex != 0)
+		SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Keeps a worker thread waiting for batches until the pool quits.
+ * @param pool Pointer to the thread pool.
+ * @return Thread exit code.
+ */
+int ThreadPool::worker(void *pool)
+{
+	ThreadPool *self = (ThreadPool*)pool;
+	SDL_mutexP(self->_mutex);
+	while (!self->_quit)
+	{
+		if (self->_next < self->_count)
+		{
+			self->work();
+		}
+		else
+		{
+			SDL_CondWait(self->_wake, self->_mutex);
+		}
+	}
+	SDL_mutexV(self->_mutex);
+	return 0;
+}
+
+/**
+ * Takes jobs off the current batch one at a time and runs them
+ * with the lock released. Must be called with the lock held.
+ */
+void ThreadPool::work()
+{
+	while (_next < _count)
+	{
+		int index = _next++;
+		Job job = _job;
+		void *data = _data;
+		SDL_mutexV(_mutex);
+		job(data, index);
+		SDL_mutexP(_mutex);
+		if (--_pending == 0)
+		{
+			SDL_CondBroadcast(_done);
+		}
+	}
+}
+
+/**
+ * Runs a job for every index from 0 to count - 1, spread across
+ * the worker threads and the calling thread, in no particular order.
+ * Jobs must not depend on each other, touch shared state
+ * without their own locking or start batches of their own.
+ * Batches started from different threads run one after another.
+ * @param job Function to call for each index.
+ * @param data Pointer handed to every call.
+ * @param count Number of jobs in the batch.
+ */
+void ThreadPool::run(Job job, void *data, int count)
+{
+	if (_threads.empty() || count <= 1)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			job(data, i);
+		}
+		return;
+	}
+	SDL_mutexP(_mutex);
+	while (_count != 0)
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	_job = job;
+	_data = data;
+	_count = count;
+	_next = 0;
+	_pending = count;
+	SDL_CondBroadcast(_wake);
+	work();
+	while (_pending > 0)
+	{
+		SDL_CondWait(_done, _mutex);
+	}
+	_count = 0;
+	_next = 0;
+	SDL_CondBroadcast(_done);
+	SDL_mutexV(_mutex);
+}
+
+/**
+ * Gets the number of threads a batch is split between,
+ * counting the calling thread.
+ * @return Number of threads.
+ */
+int ThreadPool::getThreadCount() const
+{
+	return (int)_threads.size() + 1;
+}
+
+}
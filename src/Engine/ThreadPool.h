@@ -0,0 +1,64 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_THREADPOOL_H
+#define OPENXCOM_THREADPOOL_H
+
+#include <vector>
+#include <SDL.h>
+
+namespace OpenXcom
+{
+
+/**
+ * A fixed set of worker threads that split batches of
+ * independent jobs between them. The calling thread joins in
+ * on every batch and only returns once all of it is done,
+ * so callers never see a half-finished batch.
+ */
+class ThreadPool
+{
+public:
+	/// A batch job, called once for every index in the batch.
+	typedef void (*Job)(void *data, int index);
+private:
+	std::vector<SDL_Thread*> _threads;
+	SDL_mutex *_mutex;
+	SDL_cond *_wake, *_done;
+	Job _job;
+	void *_data;
+	int _count, _next, _pending;
+	bool _quit;
+	/// Entry point of the worker threads.
+	static int worker(void *pool);
+	/// Runs jobs of the current batch until none are left.
+	void work();
+public:
+	/// Creates a thread pool with a number of worker threads.
+	ThreadPool(int threads);
+	/// Stops and cleans up the worker threads.
+	~ThreadPool();
+	/// Runs a batch of jobs and waits for it to finish.
+	void run(Job job, void *data, int count);
+	/// Gets the number of threads working on a batch.
+	int getThreadCount() const;
+};
+
+}
+
+#endif
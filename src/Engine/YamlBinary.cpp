@@ -0,0 +1,230 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "YamlBinary.h"
+
+namespace OpenXcom
+{
+
+namespace YamlBinary
+{
+
+/// Node trees nested deeper than this are considered damaged.
+const int MAX_DEPTH = 256;
+
+enum NodeKind { NODE_NULL, NODE_SCALAR, NODE_SEQUENCE, NODE_MAP };
+
+/**
+ * Appends an unsigned number in little-endian order.
+ * @param out Buffer to append to.
+ * @param value Number to append.
+ * @param bytes Size of the number in bytes.
+ */
+void writeNumber(std::string &out, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		out += (char)((value >> (i * 8)) & 0xFF);
+	}
+}
+
+/**
+ * Reads an unsigned number in little-endian order.
+ * @param in Buffer to read from.
+ * @param pos Current position in the buffer, moved past the number.
+ * @param value Returns the number.
+ * @param bytes Size of the number in bytes.
+ * @return False if the buffer ends first.
+ */
+bool readNumber(const std::string &in, size_t &pos, uint64_t &value, int bytes)
+{
+	if (in.size() - pos < (size_t)bytes)
+		return false;
+	value = 0;
+	for (int i = 0; i < bytes; ++i)
+	{
+		value |= (uint64_t)(unsigned char)in[pos + i] << (i * 8);
+	}
+	pos += bytes;
+	return true;
+}
+
+/**
+ * Appends a string, prefixed by its length.
+ * @param out Buffer to append to.
+ * @param s String to append.
+ */
+void writeString(std::string &out, const std::string &s)
+{
+	writeNumber(out, s.size(), 4);
+	out += s;
+}
+
+/**
+ * Reads a string prefixed by its length.
+ * @param in Buffer to read from.
+ * @param pos Current position in the buffer, moved past the string.
+ * @param s Returns the string.
+ * @return False if the buffer ends first.
+ */
+bool readString(const std::string &in, size_t &pos, std::string &s)
+{
+	uint64_t size;
+	if (!readNumber(in, pos, size, 4) || in.size() - pos < size)
+		return false;
+	s = in.substr(pos, (size_t)size);
+	pos += (size_t)size;
+	return true;
+}
+
+/**
+ * Writes a YAML node and all its children in binary form.
+ * @param node YAML node.
+ * @param out Buffer to append to.
+ */
+void writeNode(const YAML::Node &node, std::string &out)
+{
+	switch (node.Type())
+	{
+	case YAML::NodeType::Scalar:
+		out += (char)NODE_SCALAR;
+		writeString(out, node.Tag());
+		writeString(out, node.Scalar());
+		break;
+	case YAML::NodeType::Sequence:
+		out += (char)NODE_SEQUENCE;
+		writeNumber(out, node.size(), 4);
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(*i, out);
+		}
+		break;
+	case YAML::NodeType::Map:
+		out += (char)NODE_MAP;
+		writeNumber(out, node.size(), 4);
+		for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+		{
+			writeNode(i->first, out);
+			writeNode(i->second, out);
+		}
+		break;
+	default:
+		out += (char)NODE_NULL;
+		break;
+	}
+}
+
+/**
+ * Reads a YAML node and all its children back from binary form.
+ * Children are created in place through their parent, so the whole
+ * tree shares the same memory instead of merging separate nodes.
+ * @param in Buffer to read from.
+ * @param pos Current position in the buffer, moved past the node.
+ * @param node Node to fill in.
+ * @param depth How deep the node is nested.
+ * @return False if the data is damaged.
+ */
+bool readNode(const std::string &in, size_t &pos, YAML::Node node, int depth)
+{
+	uint64_t kind, count;
+	if (depth > MAX_DEPTH || !readNumber(in, pos, kind, 1))
+		return false;
+	switch (kind)
+	{
+	case NODE_NULL:
+		node = YAML::Null;
+		return true;
+	case NODE_SCALAR:
+		{
+			std::string tag, value;
+			if (!readString(in, pos, tag) || !readString(in, pos, value))
+				return false;
+			node = value;
+			node.SetTag(tag);
+			return true;
+		}
+	case NODE_SEQUENCE:
+		if (!readNumber(in, pos, count, 4))
+			return false;
+		if (count == 0)
+		{
+			node = YAML::Node(YAML::NodeType::Sequence);
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!readNode(in, pos, node[i], depth + 1))
+				return false;
+		}
+		return true;
+	case NODE_MAP:
+		if (!readNumber(in, pos, count, 4))
+			return false;
+		if (count == 0)
+		{
+			node = YAML::Node(YAML::NodeType::Map);
+		}
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			if (pos < in.size() && in[pos] == NODE_SCALAR)
+			{
+				// plain keys are looked up by their value
+				std::string tag, key;
+				++pos;
+				if (!readString(in, pos, tag) || !readString(in, pos, key))
+					return false;
+				// lookups in parsed YAML find the first of any duplicate keys, so the rest are skipped
+				const YAML::Node &map = node;
+				YAML::Node value = map[key] ? YAML::Node(YAML::NodeType::Null) : node[key];
+				if (!readNode(in, pos, value, depth + 1))
+					return false;
+			}
+			else
+			{
+				YAML::Node key, value;
+				if (!readNode(in, pos, key, depth + 1) || !readNode(in, pos, value, depth + 1))
+					return false;
+				node[key] = value;
+			}
+		}
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Hashes a block of data with 64-bit FNV-1a.
+ * @param data Pointer to the data.
+ * @param size Size of the data in bytes.
+ * @return Hash value.
+ */
+uint64_t hash(const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char*)data;
+	uint64_t h = 14695981039346656037ULL;
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= bytes[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+}
+
+}
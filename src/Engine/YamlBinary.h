@@ -0,0 +1,56 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_YAMLBINARY_H
+#define OPENXCOM_YAMLBINARY_H
+
+#include <string>
+#include <stdint.h>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Compact binary encoding of YAML node trees, for files that
+ * only the game itself reads back and that don't need to go
+ * through the YAML emitter and parser.
+ * Numbers are stored in little-endian order, strings prefixed
+ * by their length.
+ */
+namespace YamlBinary
+{
+	/// Appends an unsigned number.
+	void writeNumber(std::string &out, uint64_t value, int bytes);
+	/// Reads an unsigned number.
+	bool readNumber(const std::string &in, size_t &pos, uint64_t &value, int bytes);
+	/// Appends a string.
+	void writeString(std::string &out, const std::string &s);
+	/// Reads a string.
+	bool readString(const std::string &in, size_t &pos, std::string &s);
+	/// Appends a YAML node.
+	void writeNode(const YAML::Node &node, std::string &out);
+	/// Reads a YAML node.
+	bool readNode(const std::string &in, size_t &pos, YAML::Node node, int depth = 0);
+	/// Hashes a block of data.
+	uint64_t hash(const void *data, size_t size);
+}
+
+}
+
+#endif
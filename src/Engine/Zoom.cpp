@@ -18,6 +18,8 @@
  */
 
 #include "Zoom.h"
+#include <algorithm>
+#include <cstring>
 
 //#include "Scalers/hq2x.hpp"
 
@@ -26,6 +28,7 @@
 #include "Logger.h"
 #include "Options.h"
 #include "Screen.h"
+#include "ThreadPool.h"
 
 #include "OpenGL.h"
 
@@ -62,6 +65,98 @@
 namespace OpenXcom
 {
 
+/**
+ * One zoom of the screen, split into horizontal bands
+ * that the thread pool scales independently. Every band
+ * reads the source rows around it as the whole image would,
+ * so the bands join up without seams.
+ */
+struct ZoomBands
+{
+	enum Scaler { ZOOM_HQX, ZOOM_SCALEX, ZOOM_NEAREST };
+	Scaler scaler;
+	SDL_Surface *src, *dst;
+	int factor, rows, total;
+	Uint32 *sax;
+	int *say;
+	Uint8 *csp;
+};
+
+/**
+ * Scales one band of a zoom. HQX and ScaleX bands are ranges
+ * of source rows, nearest neighbour bands are ranges of
+ * destination rows. Destination rows that sample the same
+ * source row as the one above are copied instead of resampled.
+ * @param data Pointer to the zoom.
+ * @param index Band to scale.
+ */
+static void zoomBand(void *data, int index)
+{
+	ZoomBands *zoom = (ZoomBands*)data;
+	SDL_Surface *src = zoom->src, *dst = zoom->dst;
+	int first = index * zoom->rows;
+	int last = std::min(first + zoom->rows, zoom->total);
+	switch (zoom->scaler)
+	{
+	case ZoomBands::ZOOM_HQX:
+		if (zoom->factor == 2)
+			hq2x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, first, last);
+		else if (zoom->factor == 3)
+			hq3x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, first, last);
+		else
+			hq4x_32_rb_rows((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h, first, last);
+		break;
+	case ZoomBands::ZOOM_SCALEX:
+		scale_rows(zoom->factor, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h, first, last);
+		break;
+	case ZoomBands::ZOOM_NEAREST:
+		for (int y = first; y < last; ++y)
+		{
+			Uint8 *dp = (Uint8*)dst->pixels + y * dst->pitch;
+			if (y > first && zoom->say[y] == zoom->say[y - 1])
+			{
+				memcpy(dp, dp - dst->pitch, dst->w);
+				continue;
+			}
+			Uint8 *sp = zoom->csp + zoom->say[y];
+			Uint32 *csax = zoom->sax;
+			for (int x = 0; x < dst->w; ++x)
+			{
+				*dp = *sp;
+				sp += *csax;
+				csax++;
+				dp++;
+			}
+		}
+		break;
+	}
+}
+
+/**
+ * Splits a zoom into bands and scales them on the thread pool,
+ * or on the calling thread when there's no pool.
+ * @param zoom The zoom to scale, with the total number of rows set.
+ * @param pool Thread pool to scale the bands on.
+ */
+static void zoomBands(ZoomBands *zoom, ThreadPool *pool)
+{
+	// keep bands big enough that the rows read around them are a small overhead
+	const int minRows = 16;
+	if (zoom->total <= 0)
+		return;
+	int bands = pool ? pool->getThreadCount() : 1;
+	bands = std::max(1, std::min(bands, zoom->total / minRows));
+	zoom->rows = (zoom->total + bands - 1) / bands;
+	bands = (zoom->total + zoom->rows - 1) / zoom->rows;
+	if (bands > 1)
+	{
+		pool->run(zoomBand, zoom, bands);
+	}
+	else
+	{
+		zoomBand(zoom, 0);
+	}
+}
 
 /**
  * Optimized 8-bit zoomer for resizing by a factor of 2. Doesn't flip.
@@ -655,8 +750,9 @@ bool Zoom::haveSSE2()
  * @param leftBlackBand Size of left black band in pixels (letterboxing).
  * @param rightBlackBand Size of right black band in pixels (letterboxing).
  * @param glOut OpenGL output.
+ * @param pool Thread pool to run the software scalers on.
  */
-void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut)
+void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, int bottomBlackBand, int leftBlackBand, int rightBlackBand, OpenGL *glOut, ThreadPool *pool)
 {
 	if (Screen::isOpenGLEnabled())
 	{
@@ -672,7 +768,7 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	}
 	else if (topBlackBand <= 0 && bottomBlackBand <= 0 && leftBlackBand <= 0 && rightBlackBand <= 0)
 	{
-		_zoomSurfaceY(src, dst, 0, 0);
+		_zoomSurfaceY(src, dst, 0, 0, pool);
 	}
 	else if (dst->w - leftBlackBand - rightBlackBand == src->w && dst->h - topBlackBand - bottomBlackBand == src->h)
 	{
@@ -682,7 +778,7 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
 	else
 	{
 		SDL_Surface *tmp = SDL_CreateRGBSurface(dst->flags, dst->w - leftBlackBand - rightBlackBand, dst->h - topBlackBand - bottomBlackBand, dst->format->BitsPerPixel, 0, 0, 0, 0);
-		_zoomSurfaceY(src, tmp, 0, 0);
+		_zoomSurfaceY(src, tmp, 0, 0, pool);
 		if (src->format->palette != NULL)
 		{
 			SDL_SetPalette(tmp, SDL_LOGPAL|SDL_PHYSPAL, src->format->palette->colors, 0, src->format->palette->ncolors);
@@ -706,17 +802,22 @@ void Zoom::flipWithZoom(SDL_Surface *src, SDL_Surface *dst, int topBlackBand, in
  * @param dst The zoomed surface (output).
  * @param flipx Flag indicating if the image should be horizontally flipped.
  * @param flipy Flag indicating if the image should be vertically flipped.
+ * @param pool Thread pool to split the scaling between, if any.
  * @return 0 for success or -1 for error.
  */
-int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, ThreadPool *pool)
 {
 	int x, y;
-	static Uint32 *sax, *say;
-	Uint32 *csax, *csay;
-	int csx, csy;
-	Uint8 *sp, *dp, *csp;
-	int dgap;
+	static Uint32 *sax;
+	static int *say;
+	Uint32 *csax;
+	int *csay;
+	int csx, csy, offset;
+	Uint8 *csp;
 	static bool proclaimed = false;
+	ZoomBands zoom;
+	zoom.src = src;
+	zoom.dst = dst;
 
 	if (Options::useHQXFilter)
 	{
@@ -728,23 +829,30 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 			initDone = true;
 		}
 
-		// HQX_API void HQX_CALLCONV hq2x_32_rb( uint32_t * src, uint32_t src_rowBytes, uint32_t * dest, uint32_t dest_rowBytes, int width, int height );
-
 		if (dst->w == src->w * 2 && dst->h == src->h * 2)
 		{
-			hq2x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_HQX;
+			zoom.factor = 2;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 3 && dst->h == src->h * 3)
 		{
-			hq3x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_HQX;
+			zoom.factor = 3;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 4 && dst->h == src->h * 4)
 		{
-			hq4x_32_rb((uint32_t*) src->pixels, src->pitch, (uint32_t*) dst->pixels, dst->pitch, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_HQX;
+			zoom.factor = 4;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
@@ -756,19 +864,28 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 
 		if (dst->w == src->w * 2 && dst->h == src->h *2 && !scale_precondition(2, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(2, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_SCALEX;
+			zoom.factor = 2;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 3 && dst->h == src->h *3 && !scale_precondition(3, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(3, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_SCALEX;
+			zoom.factor = 3;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
 		if (dst->w == src->w * 4 && dst->h == src->h *4 && !scale_precondition(4, src->format->BytesPerPixel, src->w, src->h))
 		{
-			scale(4, dst->pixels, dst->pitch, src->pixels, src->pitch, src->format->BytesPerPixel, src->w, src->h);
+			zoom.scaler = ZoomBands::ZOOM_SCALEX;
+			zoom.factor = 4;
+			zoom.total = src->h;
+			zoomBands(&zoom, pool);
 			return 0;
 		}
 
@@ -835,7 +952,7 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		sax = 0;
 		return (-1);
 	}
-	if ((say = (Uint32 *) realloc(say, (dst->h + 1) * sizeof(Uint32))) == NULL) {
+	if ((say = (int *) realloc(say, (dst->h + 1) * sizeof(int))) == NULL) {
 		say = 0;
 		//free(sax);
 		return (-1);
@@ -844,15 +961,13 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 	/*
 	* Pointer setup
 	*/
-	sp = csp = (Uint8 *) src->pixels;
-	dp = (Uint8 *) dst->pixels;
-	dgap = dst->pitch - dst->w;
+	csp = (Uint8 *) src->pixels;
 
 	if (flipx) csp += (src->w-1);
 	if (flipy) csp  = ( (Uint8*)csp + src->pitch*(src->h-1) );
 
 	/*
-	* Precalculate row increments
+	* Precalculate column increments
 	*/
 	csx = 0;
 	csax = sax;
@@ -866,51 +981,31 @@ int Zoom::_zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int fli
 		(*csax) *= (flipx ? -1 : 1);
 		csax++;
 	}
+	/*
+	* Precalculate row offsets, so every band can start anywhere
+	*/
 	csy = 0;
 	csay = say;
+	offset = 0;
 	for (y = 0; y < dst->h; y++) {
+		*csay = offset;
 		csy += src->h;
-		*csay = 0;
 		while (csy >= dst->h) {
 			csy -= dst->h;
-			(*csay)++;
+			offset += src->pitch * (flipy ? -1 : 1);
 		}
-		(*csay) *= src->pitch * (flipy ? -1 : 1);
 		csay++;
 	}
 	/*
 	* Draw
 	*/
-	csay = say;
-	for (y = 0; y < dst->h; y++) {
-		csax = sax;
-		sp = csp;
-		for (x = 0; x < dst->w; x++) {
-			/*
-			* Draw
-			*/
-			*dp = *sp;
-			/*
-			* Advance source pointers
-			*/
-			sp += (*csax);
-			csax++;
-			/*
-			* Advance destination pointer
-			*/
-			dp++;
-		}
-		/*
-		* Advance source pointer (for row)
-		*/
-		csp += (*csay);
-		csay++;
-
-		/*
-		* Advance destination pointers
-		*/
-		dp += dgap;
-	}
+	zoom.scaler = ZoomBands::ZOOM_NEAREST;
+	zoom.factor = 0;
+	zoom.total = dst->h;
+	zoom.sax = sax;
+	zoom.say = say;
+	zoom.csp = csp;
+	zoomBands(&zoom, pool);
 
 	/*
 	* Never remove temp arrays
@@ -77,21 +77,15 @@ AlienBaseState::AlienBaseState(AlienBase *base, GeoscapeState *state) : _state(s
 
 	// Check location of base
 	std::wstring region, country;
-	for (std::vector<Country*>::iterator i = _game->getSavedGame()->getCountries()->begin(); i != _game->getSavedGame()->getCountries()->end(); ++i)
+	Country *baseCountry = _game->getSavedGame()->locateCountry(*_base, _game->getRuleset());
+	if (baseCountry)
 	{
-		if ((*i)->getRules()->insideCountry(_base->getLongitude(), _base->getLatitude())) 
-		{
-			country = tr((*i)->getRules()->getType());
-			break;
-		}
+		country = tr(baseCountry->getRules()->getType());
 	}
-	for (std::vector<Region*>::iterator i = _game->getSavedGame()->getRegions()->begin(); i != _game->getSavedGame()->getRegions()->end(); ++i)
+	Region *baseRegion = _game->getSavedGame()->locateRegion(*_base, _game->getRuleset());
+	if (baseRegion)
 	{
-		if ((*i)->getRules()->insideRegion(_base->getLongitude(), _base->getLatitude())) 
-		{
-			region = tr((*i)->getRules()->getType());
-			break;
-		}
+		region = tr(baseRegion->getRules()->getType());
 	}
 	std::wstring location;
 	if (!country.empty())
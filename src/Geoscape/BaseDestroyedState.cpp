@@ -71,16 +71,9 @@ BaseDestroyedState::BaseDestroyedState(Base *base) : _base(base)
 
 	_txtMessage->setText(tr("STR_THE_ALIENS_HAVE_DESTROYED_THE_UNDEFENDED_BASE").arg(_base->getName()));
 
-	std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin();
-	for (; k != _game->getSavedGame()->getRegions()->end(); ++k)
-	{
-		if ((*k)->getRules()->insideRegion((base)->getLongitude(), (base)->getLatitude()))
-		{
-			break;
-		}
-	}
+	Region *region = _game->getSavedGame()->locateRegion(*base, _game->getRuleset());
 
-	AlienMission* am = _game->getSavedGame()->getAlienMission((*k)->getRules()->getType(), "STR_ALIEN_RETALIATION");
+	AlienMission* am = _game->getSavedGame()->getAlienMission(region->getRules()->getType(), "STR_ALIEN_RETALIATION");
 	for (std::vector<Ufo*>::iterator i = _game->getSavedGame()->getUfos()->begin(); i != _game->getSavedGame()->getUfos()->end();)
 	{
 		if ((*i)->getMission() == am)
@@ -79,14 +79,11 @@ ConfirmNewBaseState::ConfirmNewBaseState(Base *base, Globe *globe) : _base(base)
 	_btnCancel->onKeyboardPress((ActionHandler)&ConfirmNewBaseState::btnCancelClick, Options::keyCancel);
 
 	std::wstring area;
-	for (std::vector<Region*>::iterator i = _game->getSavedGame()->getRegions()->begin(); i != _game->getSavedGame()->getRegions()->end(); ++i)
+	Region *region = _game->getSavedGame()->locateRegion(_base->getLongitude(), _base->getLatitude(), _game->getRuleset());
+	if (region)
 	{
-		if ((*i)->getRules()->insideRegion(_base->getLongitude(), _base->getLatitude()))
-		{
-			_cost = (*i)->getRules()->getBaseCost();
-			area = tr((*i)->getRules()->getType());
-			break;
-		}
+		_cost = region->getRules()->getBaseCost();
+		area = tr(region->getRules()->getType());
 	}
 
 	_txtCost->setColor(Palette::blockOffset(15)-1);
@@ -1029,7 +1029,7 @@ void DogfightState::move()
 			else
 			{
 				// Try to find and attack the originating base.
-				targetRegion = _game->getSavedGame()->locateRegion(*_craft->getBase())->getRules()->getType();
+				targetRegion = _game->getSavedGame()->locateRegion(*_craft->getBase(), _game->getRuleset())->getRules()->getType();
 				// TODO: If the base is removed, the mission is canceled.
 			}
 			// Difference from original: No retaliation until final UFO lands (Original: Is spawned).
@@ -1049,21 +1049,15 @@ void DogfightState::move()
 		{
 			if(_ufo->getShotDownByCraftId() == _craft->getId())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry(_ufo->getLongitude(), _ufo->getLatitude(), _game->getRuleset());
+				if (country)
 				{
-					if((*country)->getRules()->insideCountry(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*country)->addActivityXcom(_ufo->getRules()->getScore()*2);
-						break;
-					}
+					country->addActivityXcom(_ufo->getRules()->getScore()*2);
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion(_ufo->getLongitude(), _ufo->getLatitude(), _game->getRuleset());
+				if (region)
 				{
-					if((*region)->getRules()->insideRegion(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*region)->addActivityXcom(_ufo->getRules()->getScore()*2);
-						break;
-					}
+					region->addActivityXcom(_ufo->getRules()->getScore()*2);
 				}
 				setStatus("STR_UFO_DESTROYED");
 				_game->getResourcePack()->getSound("GEO.CAT", 10)->play(); //11
@@ -1076,21 +1070,15 @@ void DogfightState::move()
 			{
 				setStatus("STR_UFO_CRASH_LANDS");
 				_game->getResourcePack()->getSound("GEO.CAT", 10)->play(); //10
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry(_ufo->getLongitude(), _ufo->getLatitude(), _game->getRuleset());
+				if (country)
 				{
-					if((*country)->getRules()->insideCountry(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*country)->addActivityXcom(_ufo->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(_ufo->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion(_ufo->getLongitude(), _ufo->getLatitude(), _game->getRuleset());
+				if (region)
 				{
-					if((*region)->getRules()->insideRegion(_ufo->getLongitude(), _ufo->getLatitude()))
-					{
-						(*region)->addActivityXcom(_ufo->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(_ufo->getRules()->getScore());
 				}
 			}
 			if (!_globe->insideLand(_ufo->getLongitude(), _ufo->getLatitude()))
@@ -23,6 +23,7 @@
 #include <iomanip>
 #include <ctime>
 #include <algorithm>
+#include <limits>
 #include <functional>
 #include <assert.h>
 #include "../Engine/RNG.h"
@@ -465,6 +466,7 @@ void GeoscapeState::handle(Action *action)
 		if (Options::debug && action->getDetails()->key.keysym.sym == SDLK_d && (SDL_GetModState() & KMOD_CTRL) != 0)
 		{
 			_game->getSavedGame()->setDebugMode();
+			_globe->invalidate();
 			if (_game->getSavedGame()->getDebugMode())
 			{
 				_txtDebug->setText(L"DEBUG MODE");
@@ -510,6 +512,7 @@ void GeoscapeState::init()
 	_globe->onMouseOver(0);
 	_globe->rotateStop();
 	_globe->setFocus(true);
+	_globe->invalidate();
 	_globe->draw();
 
 	// Pop up save screen if it's a new ironman game
@@ -646,10 +649,21 @@ void GeoscapeState::timeAdvance()
 		timeSpan = 12 * 5 * 6 * 2 * 24;
 	}
 
+	int idle = getIdleTicks();
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
+		if (trigger == TIME_5SEC && idle > 0)
+		{
+			// Nothing but landed UFOs counting down happens on this step
+			for (std::vector<Ufo*>::iterator u = _game->getSavedGame()->getUfos()->begin(); u != _game->getSavedGame()->getUfos()->end(); ++u)
+			{
+				(*u)->think();
+			}
+			--idle;
+			continue;
+		}
 		switch (trigger)
 		{
 		case TIME_1MONTH:
@@ -665,6 +679,7 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+		idle = getIdleTicks();
 	}
 
 	_pause = !_dogfightsToBeStarted.empty();
@@ -673,6 +688,61 @@ void GeoscapeState::timeAdvance()
 	_globe->draw();
 }
 
+/**
+ * Works out how many of the coming 5 second steps would do
+ * nothing in time5Seconds() but count down the landed UFOs,
+ * so timeAdvance() can skip straight through them. That's the
+ * case while no UFO is flying or about to take off or vanish,
+ * every craft is idle at its base and every waypoint is in use.
+ * Steps that start a longer time period are always run in full.
+ * @return Number of steps that can be skipped.
+ */
+int GeoscapeState::getIdleTicks() const
+{
+	SavedGame *save = _game->getSavedGame();
+	if (save->getBases()->empty())
+	{
+		return 0;
+	}
+	int idle = std::numeric_limits<int>::max();
+	for (std::vector<Ufo*>::const_iterator i = save->getUfos()->begin(); i != save->getUfos()->end(); ++i)
+	{
+		switch ((*i)->getStatus())
+		{
+		case Ufo::LANDED:
+			// the step where it reaches zero has to run in full
+			idle = std::min(idle, (int)(*i)->getSecondsRemaining() / 5 - 1);
+			break;
+		case Ufo::CRASHED:
+			if (!(*i)->getDetected() || (*i)->getSecondsRemaining() == 0)
+			{
+				return 0;
+			}
+			break;
+		default:
+			return 0;
+		}
+	}
+	for (std::vector<Base*>::const_iterator i = save->getBases()->begin(); i != save->getBases()->end(); ++i)
+	{
+		for (std::vector<Craft*>::const_iterator j = (*i)->getCrafts()->begin(); j != (*i)->getCrafts()->end(); ++j)
+		{
+			if (!(*j)->isIdle())
+			{
+				return 0;
+			}
+		}
+	}
+	for (std::vector<Waypoint*>::const_iterator i = save->getWaypoints()->begin(); i != save->getWaypoints()->end(); ++i)
+	{
+		if ((*i)->getFollowers()->empty())
+		{
+			return 0;
+		}
+	}
+	return std::max(idle, 0);
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
@@ -769,21 +839,15 @@ void GeoscapeState::time5Seconds()
 		{
 			if ((*j)->isDestroyed())
 			{
-				for(std::vector<Country*>::iterator country = _game->getSavedGame()->getCountries()->begin(); country != _game->getSavedGame()->getCountries()->end(); ++country)
+				Country *country = _game->getSavedGame()->locateCountry((*j)->getLongitude(), (*j)->getLatitude(), _game->getRuleset());
+				if (country)
 				{
-					if ((*country)->getRules()->insideCountry((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*country)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					country->addActivityXcom(-(*j)->getRules()->getScore());
 				}
-				for(std::vector<Region*>::iterator region = _game->getSavedGame()->getRegions()->begin(); region != _game->getSavedGame()->getRegions()->end(); ++region)
+				Region *region = _game->getSavedGame()->locateRegion((*j)->getLongitude(), (*j)->getLatitude(), _game->getRuleset());
+				if (region)
 				{
-					if ((*region)->getRules()->insideRegion((*j)->getLongitude(), (*j)->getLatitude()))
-					{
-						(*region)->addActivityXcom(-(*j)->getRules()->getScore());
-						break;
-					}
+					region->addActivityXcom(-(*j)->getRules()->getScore());
 				}
 				// if a transport craft has been shot down, kill all the soldiers on board.
 				if ((*j)->getRules()->getSoldiers() > 0)
@@ -1082,7 +1146,7 @@ void GeoscapeState::time10Minutes()
 			std::vector<Ufo*>::const_iterator uu = std::find_if (_game->getSavedGame()->getUfos()->begin(), _game->getSavedGame()->getUfos()->end(), DetectXCOMBase(**iBase, diff));
 			if (uu != _game->getSavedGame()->getUfos()->end())
 			{
-				discovered[_game->getSavedGame()->locateRegion(**iBase)] = *iBase;
+				discovered[_game->getSavedGame()->locateRegion(**iBase, _game->getRuleset())] = *iBase;
 			}
 		}
 		// Now mark the bases as discovered.
@@ -1126,19 +1190,16 @@ bool GeoscapeState::processTerrorSite(TerrorSite *ts) const
 		return false;
 	}
 	// Score and delete it.
-	Region *region = _game->getSavedGame()->locateRegion(*ts);
+	Region *region = _game->getSavedGame()->locateRegion(*ts, _game->getRuleset());
 	if (region)
 	{
 		region->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
 		//kids, tell your folks... don't ignore terror sites.
 	}
-	for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+	Country *country = _game->getSavedGame()->locateCountry(ts->getLongitude(), ts->getLatitude(), _game->getRuleset());
+	if (country)
 	{
-		if ((*k)->getRules()->insideCountry(ts->getLongitude(), ts->getLatitude()))
-		{
-			(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
-			break;
-		}
+		country->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_TERROR")->getPoints() * 100);
 	}
 	delete ts;
 	return true;
@@ -1247,24 +1308,20 @@ void GeoscapeState::time30Minutes()
 			points++;
 		case Ufo::FLYING:
 			points++;
-			// Get area
-			for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
 			{
-				if ((*k)->getRules()->insideRegion((*u)->getLongitude(), (*u)->getLatitude()))
+				// Get area
+				Region *region = _game->getSavedGame()->locateRegion((*u)->getLongitude(), (*u)->getLatitude(), _game->getRuleset());
+				if (region)
 				{
 					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
+					region->addActivityAlien(points);
 				}
-			}
-			// Get country
-			for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
-			{
-				if ((*k)->getRules()->insideCountry((*u)->getLongitude(), (*u)->getLatitude()))
+				// Get country
+				Country *country = _game->getSavedGame()->locateCountry((*u)->getLongitude(), (*u)->getLatitude(), _game->getRuleset());
+				if (country)
 				{
 					//one point per UFO in-flight per half hour
-					(*k)->addActivityAlien(points);
-					break;
+					country->addActivityAlien(points);
 				}
 			}
 			if (!(*u)->getDetected())
@@ -1453,7 +1510,7 @@ void GenerateSupplyMission::operator()(const AlienBase *base) const
 		//Spawn supply mission for this base.
 		const RuleAlienMission &rule = *_ruleset.getAlienMission("STR_ALIEN_SUPPLY");
 		AlienMission *mission = new AlienMission(rule);
-		mission->setRegion(_save.locateRegion(*base)->getRules()->getType(), _ruleset);
+		mission->setRegion(_save.locateRegion(*base, &_ruleset)->getRules()->getType(), _ruleset);
 		mission->setId(_save.getId("ALIEN_MISSIONS"));
 		mission->setRace(base->getAlienRace());
 		mission->setAlienBase(base);
@@ -1614,21 +1671,15 @@ void GeoscapeState::time1Day()
 	// handle regional and country points for alien bases
 	for(std::vector<AlienBase*>::const_iterator b = _game->getSavedGame()->getAlienBases()->begin(); b != _game->getSavedGame()->getAlienBases()->end(); ++b)
 	{
-		for (std::vector<Region*>::iterator k = _game->getSavedGame()->getRegions()->begin(); k != _game->getSavedGame()->getRegions()->end(); ++k)
+		Region *region = _game->getSavedGame()->locateRegion((*b)->getLongitude(), (*b)->getLatitude(), _game->getRuleset());
+		if (region)
 		{
-			if ((*k)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
-				break;
-			}
+			region->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
 		}
-		for (std::vector<Country*>::iterator k = _game->getSavedGame()->getCountries()->begin(); k != _game->getSavedGame()->getCountries()->end(); ++k)
+		Country *country = _game->getSavedGame()->locateCountry((*b)->getLongitude(), (*b)->getLatitude(), _game->getRuleset());
+		if (country)
 		{
-			if ((*k)->getRules()->insideCountry((*b)->getLongitude(), (*b)->getLatitude()))
-			{
-				(*k)->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
-				break;
-			}
+			country->addActivityAlien(_game->getRuleset()->getAlienMission("STR_ALIEN_BASE")->getPoints() / 10);
 		}
 	}
 
@@ -1681,36 +1732,33 @@ void GeoscapeState::time1Month()
 	{
 		if (newRetaliation)
 		{
-			for (std::vector<Region*>::iterator i = _game->getSavedGame()->getRegions()->begin(); i != _game->getSavedGame()->getRegions()->end(); ++i)
+			Region *region = _game->getSavedGame()->locateRegion((*b)->getLongitude(), (*b)->getLatitude(), _game->getRuleset());
+			if (region)
 			{
-				if ((*i)->getRules()->insideRegion((*b)->getLongitude(), (*b)->getLatitude()))
+				if (!_game->getSavedGame()->getAlienMission(region->getRules()->getType(), "STR_ALIEN_RETALIATION"))
 				{
-					if (!_game->getSavedGame()->getAlienMission((*i)->getRules()->getType(), "STR_ALIEN_RETALIATION"))
+					const RuleAlienMission &rule = *_game->getRuleset()->getAlienMission("STR_ALIEN_RETALIATION");
+					AlienMission *mission = new AlienMission(rule);
+					mission->setId(_game->getSavedGame()->getId("ALIEN_MISSIONS"));
+					mission->setRegion(region->getRules()->getType(), *_game->getRuleset());
+					// get races for retaliation missions
+					std::vector<std::string> races = _game->getRuleset()->getAlienRacesList();
+					for (std::vector<std::string>::iterator i = races.begin(); i != races.end();)
 					{
-						const RuleAlienMission &rule = *_game->getRuleset()->getAlienMission("STR_ALIEN_RETALIATION");
-						AlienMission *mission = new AlienMission(rule);
-						mission->setId(_game->getSavedGame()->getId("ALIEN_MISSIONS"));
-						mission->setRegion((*i)->getRules()->getType(), *_game->getRuleset());
-						// get races for retaliation missions
-						std::vector<std::string> races = _game->getRuleset()->getAlienRacesList();
-						for (std::vector<std::string>::iterator i = races.begin(); i != races.end();)
+						if (_game->getRuleset()->getAlienRace(*i)->canRetaliate())
 						{
-							if (_game->getRuleset()->getAlienRace(*i)->canRetaliate())
-							{
-								i++;
-							}
-							else
-							{
-								i = races.erase(i);
-							}
+							i++;
+						}
+						else
+						{
+							i = races.erase(i);
 						}
-						size_t race = RNG::generate(0, races.size()-1);
-						mission->setRace(races[race]);
-						mission->start(150);
-						_game->getSavedGame()->getAlienMissions().push_back(mission);
-						newRetaliation = false;
 					}
-					break;
+					size_t race = RNG::generate(0, races.size()-1);
+					mission->setRace(races[race]);
+					mission->start(150);
+					_game->getSavedGame()->getAlienMissions().push_back(mission);
+					newRetaliation = false;
 				}
 			}
 		}
@@ -2185,7 +2233,7 @@ void GeoscapeState::determineAlienMissions(bool atGameStart)
 		//
 		AlienStrategy &strategy = _game->getSavedGame()->getAlienStrategy();
 		std::string targetRegion =
-		_game->getSavedGame()->locateRegion(*_game->getSavedGame()->getBases()->front())->getRules()->getType();
+		_game->getSavedGame()->locateRegion(*_game->getSavedGame()->getBases()->front(), _game->getRuleset())->getRules()->getType();
 		// Choose race for this mission.
 		std::string research = _game->getRuleset()->getAlienMissionList().front();
 		const RuleAlienMission &missionRules = *_game->getRuleset()->getAlienMission(research);
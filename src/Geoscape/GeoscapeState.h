@@ -72,6 +72,8 @@ public:
 	void timeDisplay();
 	/// Advances the game timer.
 	void timeAdvance();
+	/// Gets how many 5 second steps would only count down landed UFOs.
+	int getIdleTicks() const;
 	/// Trigger whenever 5 seconds pass.
 	void time5Seconds();
 	/// Trigger whenever 10 minutes pass.
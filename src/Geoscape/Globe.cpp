@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include "Globe.h"
 #include <cmath>
+#include <cstring>
 #include <fstream>
 #include <algorithm>
 #include "../fmath.h"
@@ -60,6 +61,10 @@
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace OpenXcom
 {
 
@@ -172,7 +177,29 @@ struct Ocean
 
 struct CreateShadow
 {
-	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+	/**
+	 * Gets the terminator shade of a globe pixel from the
+	 * squared distance between its normal and the sun direction.
+	 * @param distance Scaled distance, (|earth - sun|^2 - 2) * 125.
+	 * @return Shade before noise is applied.
+	 */
+	static inline Sint16 getShadowGradient(double distance)
+	{
+		if (distance < -110)
+			return -31;
+		else if (distance > 120)
+			return 50;
+		else
+			return static_data.shade_gradient[(Sint16)distance + 120];
+	}
+
+	/**
+	 * Gets the scaled squared distance between a globe normal and the sun direction.
+	 * @param earth Normal of the globe pixel.
+	 * @param sun Direction of the sun.
+	 * @return Scaled distance.
+	 */
+	static inline double getShadowDistance(const Cord& earth, const Cord& sun)
 	{
 		Cord temp = earth;
 		//diff
@@ -186,19 +213,59 @@ struct CreateShadow
 
 		temp.x -= 2;
 		temp.x *= 125.;
+		return temp.x;
+	}
 
-		if (temp.x < -110)
-			temp.x = -31;
-		else if (temp.x > 120)
-			temp.x = 50;
-		else
-			temp.x = static_data.shade_gradient[(Sint16)temp.x + 120];
-
-		temp.x -= noise;
+	/**
+	 * Gets the shades of a row of globe pixels, two pixels
+	 * at a time when SSE2 is available.
+	 * @param earth Normals of the row's pixels.
+	 * @param sun Direction of the sun.
+	 * @param shade Output shades before noise.
+	 * @param count Number of pixels in the row.
+	 */
+	static inline void getShadowRow(const Cord* earth, const Cord& sun, Sint16* shade, int count)
+	{
+		int i = 0;
+#ifdef __SSE2__
+		const __m128d sunX = _mm_set1_pd(sun.x);
+		const __m128d sunY = _mm_set1_pd(sun.y);
+		const __m128d sunZ = _mm_set1_pd(sun.z);
+		const __m128d two = _mm_set1_pd(2.);
+		const __m128d scale = _mm_set1_pd(125.);
+		double distance[2];
+		for (; i + 1 < count; i += 2)
+		{
+			__m128d x = _mm_sub_pd(_mm_loadh_pd(_mm_load_sd(&earth[i].x), &earth[i + 1].x), sunX);
+			__m128d y = _mm_sub_pd(_mm_loadh_pd(_mm_load_sd(&earth[i].y), &earth[i + 1].y), sunY);
+			__m128d z = _mm_sub_pd(_mm_loadh_pd(_mm_load_sd(&earth[i].z), &earth[i + 1].z), sunZ);
+			x = _mm_mul_pd(x, x);
+			y = _mm_mul_pd(y, y);
+			z = _mm_mul_pd(z, z);
+			x = _mm_add_pd(x, _mm_add_pd(z, y));
+			x = _mm_mul_pd(_mm_sub_pd(x, two), scale);
+			_mm_storeu_pd(distance, x);
+			shade[i] = getShadowGradient(distance[0]);
+			shade[i + 1] = getShadowGradient(distance[1]);
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			shade[i] = getShadowGradient(getShadowDistance(earth[i], sun));
+		}
+	}
 
-		if(temp.x > 0.)
+	/**
+	 * Applies a terminator shade to a globe pixel.
+	 * @param dest Color of the pixel.
+	 * @param shade Shade after noise.
+	 * @return Shaded color.
+	 */
+	static inline Uint8 applyShadow(const Uint8& dest, int shade)
+	{
+		if(shade > 0)
 		{
-			const Sint16 val = (temp.x> 31)? 31 : (Sint16)temp.x;
+			const Sint16 val = (shade> 31)? 31 : (Sint16)shade;
 			const int d = dest & helper::ColorGroup;
 			if(d ==  Palette::blockOffset(12) || d ==  Palette::blockOffset(13))
 			{
@@ -231,13 +298,10 @@ struct CreateShadow
 			}
 		}
 	}
-	
-	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise, const int&)
+
+	static inline Uint8 getShadowValue(const Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
 	{
-		if(dest && earth.z)
-			dest = getShadowValue(dest, earth, sun, noise);
-		else
-			dest = 0;
+		return applyShadow(dest, getShadowGradient(getShadowDistance(earth, sun)) - noise);
 	}
 };
 
@@ -271,6 +335,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	_countries = new Surface(width, height, x, y);
 	_markers = new Surface(width, height, x, y);
 	_radars = new Surface(width, height, x, y);
+	_land = new Surface(width, height);
 	_clipper = new FastLineClip(x, x+width, y, y+height);
 
 	// Animation timers
@@ -407,6 +472,7 @@ Globe::~Globe()
 	delete _mkCrashedUfo;
 	delete _mkAlienSite;
 	delete _radars;
+	delete _land;
 	delete _clipper;
 
 	for (std::list<Polygon*>::iterator i = _cacheLand.begin(); i != _cacheLand.end(); ++i)
@@ -817,7 +883,8 @@ bool Globe::insideLand(double lon, double lat) const
 	double oldLon = _cenLon, oldLat = _cenLat;
 	globe->_cenLon = lon;
 	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end() && !inside; ++i)
+	const std::vector<Polygon*> &polygons = _game->getResourcePack()->getPolygons(lon, lat);
+	for (std::vector<Polygon*>::const_iterator i = polygons.begin(); i != polygons.end() && !inside; ++i)
 	{
 		inside = insidePolygon(lon, lat, *i);
 	}
@@ -1061,42 +1128,46 @@ void Globe::rotate()
 }
 
 /**
- * Draws the whole globe, part by part.
+ * Draws the whole globe, part by part. The ocean, land and
+ * country details only depend on the view, so they're only
+ * redrawn when the globe is moved or zoomed, and every other
+ * draw just reshades the cached land for the time of day.
  */
 void Globe::draw()
 {
 	if (_redraw)
 	{
 		cachePolygons();
+		drawOcean();
+		drawLand();
+		drawDetail();
 	}
 	Surface::draw();
-	drawOcean();
-	drawLand();
 	drawRadars();
 	drawShadow();
 	drawMarkers();
-	drawDetail();
 	drawFlights();
 }
 
 
 /**
- * Renders the ocean, shading it according to the time of day.
+ * Renders the ocean into the land layer.
  */
 void Globe::drawOcean()
 {
-	lock();
-	drawCircle(_cenX+1, _cenY, _radius+20, Palette::blockOffset(12)+0);
+	_land->clear();
+	_land->lock();
+	_land->drawCircle(_cenX+1, _cenY, _radius+20, Palette::blockOffset(12)+0);
 //	ShaderDraw<Ocean>(ShaderSurface(this));
-	unlock();
+	_land->unlock();
 }
 
 
 
 
 /**
- * Renders the land, taking all the visible world polygons
- * and texturing and shading them accordingly.
+ * Renders the land into the land layer, taking all the
+ * visible world polygons and texturing them accordingly.
  */
 void Globe::drawLand()
 {
@@ -1113,7 +1184,7 @@ void Globe::drawLand()
 
 		// Apply textures according to zoom and shade
 		int zoom = (2 - (int)floor(_zoom / 2.0)) * NUM_TEXTURES;
-		drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom), 0, 0);
+		_land->drawTexturedPolygon(x, y, (*i)->getPoints(), _texture->getFrame((*i)->getTexture() + zoom), 0, 0);
 	}
 }
 
@@ -1173,17 +1244,68 @@ Cord Globe::getSunDirection(double lon, double lat) const
 }
 
 
+/**
+ * Copies the land layer onto the globe, shading it according
+ * to the time of day. Works a row at a time and only shades
+ * the pixels covered by the globe in that row.
+ */
 void Globe::drawShadow()
 {
-	ShaderMove<Cord> earth = ShaderMove<Cord>(_earthData[_zoom], getWidth(), getHeight());
-	ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(_randomNoiseData, static_data.random_surf_size, static_data.random_surf_size);
-	
-	earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
-	
+	const std::vector<Cord> &earth = _earthData[_zoom];
+	const Cord sun = getSunDirection(_cenLon, _cenLat);
+	const int width = getWidth(), height = getHeight();
+	const int moveX = _cenX - width / 2, moveY = _cenY - height / 2;
+	const int noiseSize = static_data.random_surf_size;
+	const double radius = _zoomRadius[_zoom];
+	_shadeRow.resize(width);
+
 	lock();
-	ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
+	_land->lock();
+	for (int y = 0; y < height; ++y)
+	{
+		const Uint8 *src = (Uint8*)_land->getSurface()->pixels + y * _land->getSurface()->pitch;
+		Uint8 *dest = (Uint8*)getSurface()->pixels + y * getSurface()->pitch;
+		const int earthY = y - moveY;
+		if (earthY < 0 || earthY >= height)
+		{
+			// outside the normal field, so left as is
+			memcpy(dest, src, width);
+			continue;
+		}
+
+		// span of the row that can be covered by the globe
+		const double dy = earthY + .5 - height / 2;
+		int begin = 0, end = 0;
+		if (dy * dy < radius * radius)
+		{
+			const double half = sqrt(radius * radius - dy * dy);
+			begin = std::max(0, std::max(moveX, (int)floor(width / 2 - half) - 1 + moveX));
+			end = std::min(width, std::min(width + moveX, (int)ceil(width / 2 + half) + 1 + moveX));
+		}
+
+		for (int x = 0; x < width; ++x)
+		{
+			if (x < moveX || x >= width + moveX)
+				dest[x] = src[x];
+			else if (x < begin || x >= end)
+				dest[x] = 0;
+		}
+		if (begin >= end)
+			continue;
+
+		const Cord *earthRow = &earth[earthY * width];
+		const Sint16 *noise = &_randomNoiseData[(y % noiseSize) * noiseSize];
+		CreateShadow::getShadowRow(earthRow + begin - moveX, sun, &_shadeRow[begin], end - begin);
+		for (int x = begin; x < end; ++x)
+		{
+			if (src[x] && earthRow[x - moveX].z)
+				dest[x] = CreateShadow::applyShadow(src[x], _shadeRow[x] - noise[x % noiseSize]);
+			else
+				dest[x] = 0;
+		}
+	}
+	_land->unlock();
 	unlock();
-		
 }
 
 
@@ -1353,7 +1475,7 @@ void Globe::drawGlobeCircle(double lat, double lon, double radius, int segments)
 			continue;
 		}
 		if (!pointBack(lon1,lat1))
-			XuLine(_radars, this, x, y, x2, y2, 4);
+			XuLine(_radars, _land, x, y, x2, y2, 4);
 		x2=x; y2=y;
 	}
 }
@@ -2049,7 +2171,8 @@ void Globe::getPolygonTextureAndShade(double lon, double lat, int *texture, int
 	double oldLon = _cenLon, oldLat = _cenLat;
 	globe->_cenLon = lon;
 	globe->_cenLat = lat;
-	for (std::list<Polygon*>::iterator i = _game->getResourcePack()->getPolygons()->begin(); i != _game->getResourcePack()->getPolygons()->end(); ++i)
+	const std::vector<Polygon*> &polygons = _game->getResourcePack()->getPolygons(lon, lat);
+	for (std::vector<Polygon*>::const_iterator i = polygons.begin(); i != polygons.end(); ++i)
 	{
 		if (insidePolygon(lon, lat, *i))
 		{
@@ -2084,11 +2207,11 @@ void Globe::toggleRadarLines()
  */
 void Globe::resize()
 {
-	Surface *surfaces[4] = {this, _markers, _countries, _radars};
+	Surface *surfaces[5] = {this, _markers, _countries, _radars, _land};
 	int width = Options::baseXGeoscape - 64;
 	int height = Options::baseYGeoscape;
 
-	for (int i = 0; i < 4; ++i)
+	for (int i = 0; i < 5; ++i)
 	{
 		surfaces[i]->setWidth(width);
 		surfaces[i]->setHeight(height);
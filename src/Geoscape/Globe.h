@@ -58,6 +58,10 @@ private:
 	SurfaceSet *_texture;
 	Game *_game;
 	Surface *_markers, *_countries, *_radars;
+	/// ocean and land as seen from the current view, before shading
+	Surface *_land;
+	/// per-row scratch buffer for the terminator shading
+	std::vector<Sint16> _shadeRow;
 	bool _blink, _hover;
 	Timer *_blinkTimer, *_rotTimer;
 	std::list<Polygon*> _cacheLand;
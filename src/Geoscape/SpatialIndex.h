@@ -0,0 +1,127 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_SPATIALINDEX_H
+#define OPENXCOM_SPATIALINDEX_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace OpenXcom
+{
+
+/**
+ * A latitude/longitude grid over the globe that maps each
+ * cell to the objects whose area overlaps it, so point lookups
+ * only need to test a handful of candidates instead of every
+ * object. Areas are registered by their bounding box and the
+ * candidates are returned in the order they were inserted, so
+ * "first match" searches keep the same result as a linear scan.
+ */
+template <typename T>
+class SpatialIndex
+{
+private:
+	int _cols, _rows;
+	std::vector< std::vector<T*> > _cells;
+
+	/// Gets the grid column containing a longitude.
+	int getColumn(double lon) const
+	{
+		lon = std::fmod(lon, 2 * M_PI);
+		if (lon < 0)
+			lon += 2 * M_PI;
+		return std::min((int)(lon * _cols / (2 * M_PI)), _cols - 1);
+	}
+	/// Gets the grid row containing a latitude.
+	int getRow(double lat) const
+	{
+		return std::max(0, std::min((int)((lat + M_PI / 2) * _rows / M_PI), _rows - 1));
+	}
+public:
+	/// Creates an empty index with a certain grid size.
+	SpatialIndex(int cols = 180, int rows = 90) : _cols(cols), _rows(rows), _cells(cols * rows)
+	{
+	}
+	/// Gets the width of a grid cell in radians.
+	double getCellWidth() const
+	{
+		return 2 * M_PI / _cols;
+	}
+	/// Gets the height of a grid cell in radians.
+	double getCellHeight() const
+	{
+		return M_PI / _rows;
+	}
+	/// Removes every object from the index.
+	void clear()
+	{
+		for (typename std::vector< std::vector<T*> >::iterator i = _cells.begin(); i != _cells.end(); ++i)
+		{
+			i->clear();
+		}
+	}
+	/**
+	 * Adds an object to every cell overlapping a box.
+	 * A box with lonMin > lonMax wraps around longitude 0,
+	 * same as the areas in the region and country rules.
+	 * @param lonMin Minimum longitude in radians.
+	 * @param lonMax Maximum longitude in radians.
+	 * @param latMin Minimum latitude in radians.
+	 * @param latMax Maximum latitude in radians.
+	 * @param item Object covering the box.
+	 */
+	void insert(double lonMin, double lonMax, double latMin, double latMax, T *item)
+	{
+		int colMin = getColumn(lonMin), colMax = getColumn(lonMax);
+		if (lonMax - lonMin >= 2 * M_PI - getCellWidth())
+		{
+			colMin = 0;
+			colMax = _cols - 1;
+		}
+		int rowMin = getRow(latMin), rowMax = getRow(latMax);
+		for (int row = rowMin; row <= rowMax; ++row)
+		{
+			for (int col = colMin; ; col = (col + 1) % _cols)
+			{
+				std::vector<T*> &cell = _cells[row * _cols + col];
+				if (cell.empty() || cell.back() != item)
+				{
+					cell.push_back(item);
+				}
+				if (col == colMax)
+					break;
+			}
+		}
+	}
+	/**
+	 * Gets the objects that might contain a point.
+	 * @param lon Longitude in radians.
+	 * @param lat Latitude in radians.
+	 * @return Candidates in insertion order.
+	 */
+	const std::vector<T*> &get(double lon, double lat) const
+	{
+		return _cells[getRow(lat) * _cols + getColumn(lon)];
+	}
+};
+
+}
+
+#endif
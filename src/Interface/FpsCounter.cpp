@@ -19,10 +19,12 @@
 
 #include "FpsCounter.h"
 #include <cmath>
+#include <algorithm>
 #include "../Engine/Palette.h"
 #include "../Engine/Action.h"
 #include "../Engine/Timer.h"
 #include "../Engine/Options.h"
+#include "../Engine/Logger.h"
 #include "NumberText.h"
 
 namespace OpenXcom
@@ -35,7 +37,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0)
+FpsCounter::FpsCounter(int width, int height, int x, int y) : Surface(width, height, x, y), _frames(0), _presents(0), _lastFrame(0), _frameTotal(0), _frameWorst(0), _presentTotal(0), _presentWorst(0)
 {
 	_visible = Options::fpsCounter;
 
@@ -99,13 +101,25 @@ void FpsCounter::think()
 }
 
 /**
- * Updates the amount of Frames per Second.
+ * Updates the amount of Frames per Second
+ * and the frame pacing statistics.
  */
 void FpsCounter::update()
 {
 	int fps = (int)floor((double)_frames / _timer->getTime() * 1000);
 	_text->setValue(fps);
+	if (_visible)
+	{
+		int frameTime = _frames ? _frameTotal / _frames : 0;
+		int presentTime = _presents ? _presentTotal / _presents : 0;
+		Log(LOG_DEBUG) << "FPS: " << fps << " frame: " << frameTime << "ms (worst " << _frameWorst << "ms) present: " << presentTime << "ms (worst " << _presentWorst << "ms)";
+	}
 	_frames = 0;
+	_frameTotal = 0;
+	_frameWorst = 0;
+	_presents = 0;
+	_presentTotal = 0;
+	_presentWorst = 0;
 	_redraw = true;
 }
 
@@ -118,8 +132,32 @@ void FpsCounter::draw()
 	_text->blit(this);
 }
 
+/**
+ * Counts a frame that was drawn and how long
+ * it's been since the previous one.
+ */
 void FpsCounter::addFrame()
 {
+	Uint32 now = SDL_GetTicks();
+	if (_lastFrame != 0)
+	{
+		Uint32 time = now - _lastFrame;
+		_frameTotal += time;
+		_frameWorst = std::max(_frameWorst, time);
+	}
+	_lastFrame = now;
 	_frames++;
 }
+
+/**
+ * Counts a frame that reached the display.
+ * @param time Time from handing the frame to the screen until it was shown, in milliseconds.
+ */
+void FpsCounter::addPresent(Uint32 time)
+{
+	_presentTotal += time;
+	_presentWorst = std::max(_presentWorst, time);
+	_presents++;
+}
+
 }
@@ -32,13 +32,18 @@ class Action;
 /**
  * Counts the amount of frames each second
  * and displays them in a NumberText surface.
+ * Also keeps frame pacing statistics over the
+ * same second: how far apart frames were drawn
+ * and how long they took to be presented, which
+ * are logged while the counter is shown.
  */
 class FpsCounter : public Surface
 {
 private:
 	NumberText *_text;
 	Timer *_timer;
-	int _frames;
+	int _frames, _presents;
+	Uint32 _lastFrame, _frameTotal, _frameWorst, _presentTotal, _presentWorst;
 public:
 	/// Creates a new FPS counter linked to a game.
 	FpsCounter(int width, int height, int x, int y);
@@ -56,7 +61,10 @@ public:
 	void update();
 	/// Draws the FPS counter.
 	void draw();
+	/// Counts a drawn frame.
 	void addFrame();
+	/// Counts a frame that reached the display.
+	void addPresent(Uint32 time);
 };
 
 }
@@ -20,11 +20,10 @@
 #include <cctype>
 #include <cmath>
 #include <sstream>
+#include <algorithm>
 #include "../Engine/Font.h"
 #include "../Engine/Options.h"
 #include "../Engine/Language.h"
-#include "../Engine/ShaderDraw.h"
-#include "../Engine/ShaderMove.h"
 
 namespace OpenXcom
 {
@@ -351,6 +350,24 @@ void Text::processText()
 		return;
 	}
 
+	// Reuse the measurements of identical text, unless it switches fonts midway
+	bool cache = (_text.find(L'\x02') == std::wstring::npos);
+	int format = _wrap ? (getWidth() << 2 | (_indent ? 2 : 0) | _lang->getTextWrapping()) : -1;
+	if (cache)
+	{
+		const FontLayout *layout = _font->getLayout(_text, format);
+		if (layout != 0)
+		{
+			_text = layout->text;
+			_wrappedText = layout->wrappedText;
+			_lineWidth = layout->lineWidth;
+			_lineHeight = layout->lineHeight;
+			_redraw = true;
+			return;
+		}
+	}
+	std::wstring original = _text;
+
 	std::wstring *str = &_text;
 
 	// Use a separate string for wordwrapping text
@@ -398,7 +415,7 @@ void Text::processText()
 		// Keep track of the width of the last line and word
 		else if ((*str)[c] != 1)
 		{
-			if (font->getChar((*str)[c]) == 0)
+			if (font->getGlyph((*str)[c]) == 0)
 			{
 				(*str)[c] = L'?';
 			}
@@ -452,6 +469,15 @@ void Text::processText()
 		}
 	}
 
+	if (cache)
+	{
+		FontLayout *layout = _font->addLayout(original, format);
+		layout->text = _text;
+		layout->wrappedText = _wrappedText;
+		layout->lineWidth = _lineWidth;
+		layout->lineHeight = _lineHeight;
+	}
+
 	_redraw = true;
 }
 
@@ -499,17 +525,37 @@ int Text::getLineX(int line) const
 namespace
 {
 
-struct PaletteShift
+/**
+ * Draws the solid pixels of a font character onto a surface,
+ * shifting them to the text color.
+ * @param dest Surface to draw onto.
+ * @param font Font the character belongs to.
+ * @param glyph Character to draw.
+ * @param x X position in pixels.
+ * @param y Y position in pixels.
+ * @param off Text color.
+ * @param mul Color multiplier for high contrast.
+ * @param mid Middle of the font palette to invert around, 0 for none.
+ */
+void drawGlyph(SDL_Surface *dest, Font *font, const FontGlyph *glyph, int x, int y, int off, int mul, int mid)
 {
-	static inline void func(Uint8& dest, Uint8& src, int off, int mul, int mid)
+	SDL_Surface *src = font->getSurface()->getSurface();
+	for (std::vector<FontSpan>::const_iterator i = glyph->spans.begin(); i != glyph->spans.end(); ++i)
 	{
-		if(src)
+		int dy = y + i->y;
+		if (dy < 0 || dy >= dest->h)
+			continue;
+		int begin = std::max(0, -(x + i->x));
+		int end = std::min(i->length, dest->w - (x + i->x));
+		Uint8 *s = (Uint8*)src->pixels + (glyph->rect.y + i->y) * src->pitch + glyph->rect.x + i->x;
+		Uint8 *d = (Uint8*)dest->pixels + dy * dest->pitch + x + i->x;
+		for (int j = begin; j < end; ++j)
 		{
-			int inverseOffset = mid ? 2 * (mid - src) : 0;
-			dest = off + src * mul + inverseOffset;
+			int inverseOffset = mid ? 2 * (mid - s[j]) : 0;
+			d[j] = off + s[j] * mul + inverseOffset;
 		}
 	}
-};
+}
 
 } //namespace
 
@@ -613,10 +659,9 @@ void Text::draw()
 		{
 			if (dir < 0)
 				x += dir * font->getCharSize(*c).w;
-			Surface* chr = font->getChar(*c);
-			chr->setX(x);
-			chr->setY(y);
-			ShaderDraw<PaletteShift>(ShaderSurface(this, 0, 0), ShaderCrop(chr), ShaderScalar(color), ShaderScalar(mul), ShaderScalar(mid));
+			const FontGlyph *glyph = font->getGlyph(*c);
+			if (glyph != 0)
+				drawGlyph(_surface, font, glyph, x, y, color, mul, mid);
 			if (dir > 0)
 				x += dir * font->getCharSize(*c).w;
 		}
@@ -38,7 +38,7 @@ namespace OpenXcom
  * @param x X position in pixels.
  * @param y Y position in pixels.
  */
-TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _texts(), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _selRow(0), _color(0), _dot(false), _selectable(false), _condensed(false), _contrast(false), _wrap(false),
+TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _texts(), _renderers(), _columns(), _big(0), _small(0), _font(0), _scroll(0), _visibleRows(0), _selRow(0), _color(0), _dot(false), _selectable(false), _condensed(false), _contrast(false), _wrap(false),
 																								   _bg(0), _selector(0), _margin(0), _scrolling(true), _arrowLeft(), _arrowRight(), _arrowPos(-1), _scrollPos(4), _arrowType(ARROW_VERTICAL),
 																								   _leftClick(0), _leftPress(0), _leftRelease(0), _rightClick(0), _rightPress(0), _rightRelease(0), _arrowsLeftEdge(0), _arrowsRightEdge(0), _comboBox(0)
 {
@@ -59,12 +59,9 @@ TextList::TextList(int width, int height, int x, int y) : InteractiveSurface(wid
  */
 TextList::~TextList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::map< std::pair<size_t, int>, Text* >::iterator i = _renderers.begin(); i != _renderers.end(); ++i)
 	{
-		for (std::vector<Text*>::iterator v = (*u).begin(); v < (*u).end(); ++v)
-		{
-			delete *v;
-		}
+		delete i->second;
 	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
@@ -151,8 +148,9 @@ void TextList::unpress(State *state)
  */
 void TextList::setCellColor(size_t row, size_t column, Uint8 color)
 {
-	_texts[row][column]->setColor(color);
-	_redraw = true;
+	_texts[row][column].color = color;
+	_texts[row][column].color2 = color;
+	updateCell(row, column);
 }
 
 /**
@@ -162,11 +160,12 @@ void TextList::setCellColor(size_t row, size_t column, Uint8 color)
  */
 void TextList::setRowColor(size_t row, Uint8 color)
 {
-	for (std::vector<Text*>::iterator i = _texts[row].begin(); i < _texts[row].end(); ++i)
+	for (size_t i = 0; i < _texts[row].size(); ++i)
 	{
-		(*i)->setColor(color);
+		_texts[row][i].color = color;
+		_texts[row][i].color2 = color;
+		updateCell(row, i);
 	}
-	_redraw = true;
 }
 
 /**
@@ -177,7 +176,7 @@ void TextList::setRowColor(size_t row, Uint8 color)
  */
 std::wstring TextList::getCellText(size_t row, size_t column) const
 {
-	return _texts[row][column]->getText();
+	return _texts[row][column].text;
 }
 
 /**
@@ -188,8 +187,8 @@ std::wstring TextList::getCellText(size_t row, size_t column) const
  */
 void TextList::setCellText(size_t row, size_t column, const std::wstring &text)
 {
-	_texts[row][column]->setText(text);
-	_redraw = true;
+	_texts[row][column].text = text;
+	updateCell(row, column);
 }
 
 /**
@@ -199,7 +198,7 @@ void TextList::setCellText(size_t row, size_t column, const std::wstring &text)
  */
 int TextList::getColumnX(size_t column) const
 {
-	return getX() + _texts[0][column]->getX();
+	return getX() + _texts[0][column].x;
 }
 
 /**
@@ -209,7 +208,36 @@ int TextList::getColumnX(size_t column) const
  */
 int TextList::getRowY(size_t row) const
 {
-	return getY() + _texts[row][0]->getY();
+	int y = 0;
+	if (!_rows.empty())
+	{
+		if (_scroll > 0 && _rows[_scroll] == _rows[_scroll-1])
+			y -= _font->getHeight() + _font->getSpacing();
+		for (size_t i = _rows[_scroll]; i < row; ++i)
+		{
+			y += getRowHeight(i) + _font->getSpacing();
+		}
+		for (size_t i = row; i < _rows[_scroll]; ++i)
+		{
+			y -= getRowHeight(i) + _font->getSpacing();
+		}
+	}
+	return getY() + y;
+}
+
+/**
+ * Returns the height of a specific text row in the list,
+ * which is taller if any of it has been wordwrapped.
+ * @param row Row number.
+ * @return Height in pixels.
+ */
+int TextList::getRowHeight(size_t row) const
+{
+	if (!_texts[row].empty())
+	{
+		return _texts[row].front().height;
+	}
+	return _font->getHeight();
 }
 
 /**
@@ -249,52 +277,43 @@ void TextList::addRow(int cols, ...)
 {
 	va_list args;
 	va_start(args, cols);
-	std::vector<Text*> temp;
+	std::vector<TextListCell> temp;
 	int rowX = 0, rows = 1;
 
 	for (int i = 0; i < cols; ++i)
 	{
 		// Place text
-		Text* txt = new Text(_columns[i], _font->getHeight(), _margin + rowX, getY());
-		txt->setPalette(this->getPalette());
-		txt->initText(_big, _small, _lang);
-		txt->setColor(_color);
-		txt->setSecondaryColor(_color2);
-		if (_align[i])
-		{
-			txt->setAlign(_align[i]);
-		}
-		txt->setHighContrast(_contrast);
-		if (_font == _big)
-		{
-			txt->setBig();
-		}
-		else
-		{
-			txt->setSmall();
-		}
-		txt->setText(va_arg(args, wchar_t*));
+		TextListCell cell;
+		cell.text = va_arg(args, wchar_t*);
+		cell.x = _margin + rowX;
+		cell.height = _font->getHeight();
+		cell.color = _color;
+		cell.color2 = _color2;
+		cell.align = _align[i];
+		cell.small = (_font != _big);
+		cell.wrap = false;
+		Text *txt = layoutCell(cell, i);
 		// Wordwrap text if necessary
 		if (_wrap && txt->getTextWidth() > txt->getWidth())
 		{
-			txt->setHeight(_font->getHeight() * 2 + _font->getSpacing());
-			txt->setWordWrap(true, true);
+			cell.height = _font->getHeight() * 2 + _font->getSpacing();
+			cell.wrap = true;
+			txt = layoutCell(cell, i);
 			rows = 2;
 		}
 		// Places dots between text
 		if (_dot && i < cols - 1)
 		{
-			std::wstring buf = txt->getText();
 			unsigned int w = txt->getTextWidth();
 			while (w < _columns[i])
 			{
-				w += _font->getChar('.')->getCrop()->w + _font->getSpacing();
-				buf += '.';
+				w += _font->getCharSize(L'.').w;
+				cell.text += '.';
 			}
-			txt->setText(buf);
+			txt = layoutCell(cell, i);
 		}
 
-		temp.push_back(txt);
+		temp.push_back(cell);
 		if (_condensed)
 		{
 			rowX += txt->getTextWidth();
@@ -310,38 +329,8 @@ void TextList::addRow(int cols, ...)
 		_rows.push_back(_texts.size() - 1);
 	}
 
-
 	// Place arrow buttons
-	if (_arrowPos != -1)
-	{
-		ArrowShape shape1, shape2;
-		if (_arrowType == ARROW_VERTICAL)
-		{
-			shape1 = ARROW_SMALL_UP;
-			shape2 = ARROW_SMALL_DOWN;
-		}
-		else
-		{
-			shape1 = ARROW_SMALL_LEFT;
-			shape2 = ARROW_SMALL_RIGHT;
-		}
-		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
-		a1->setListButton();
-		a1->setPalette(this->getPalette());
-		a1->setColor(_up->getColor());
-		a1->onMouseClick(_leftClick, 0);
-		a1->onMousePress(_leftPress);
-		a1->onMouseRelease(_leftRelease);
-		_arrowLeft.push_back(a1);
-		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
-		a2->setListButton();
-		a2->setPalette(this->getPalette());
-		a2->setColor(_up->getColor());
-		a2->onMouseClick(_rightClick, 0);
-		a2->onMousePress(_rightPress);
-		a2->onMouseRelease(_rightRelease);
-		_arrowRight.push_back(a2);
-	}
+	createArrowButtons();
 
 	_redraw = true;
 	va_end(args);
@@ -378,12 +367,9 @@ void TextList::setColumns(int cols, ...)
 void TextList::setPalette(SDL_Color *colors, int firstcolor, int ncolors)
 {
 	Surface::setPalette(colors, firstcolor, ncolors);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::map< std::pair<size_t, int>, Text* >::iterator i = _renderers.begin(); i != _renderers.end(); ++i)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			(*v)->setPalette(colors, firstcolor, ncolors);
-		}
+		i->second->setPalette(colors, firstcolor, ncolors);
 	}
 	for (std::vector<ArrowButton*>::iterator i = _arrowLeft.begin(); i < _arrowLeft.end(); ++i)
 	{
@@ -416,6 +402,11 @@ void TextList::initText(Font *big, Font *small, Language *lang)
 	_font = small;
 	_lang = lang;
 
+	for (std::map< std::pair<size_t, int>, Text* >::iterator i = _renderers.begin(); i != _renderers.end(); ++i)
+	{
+		i->second->initText(_big, _small, _lang);
+	}
+
 	delete _selector;
 	_selector = new Surface(getWidth(), _font->getHeight() + _font->getSpacing(), getX(), getY());
 	_selector->setPalette(getPalette());
@@ -449,11 +440,12 @@ void TextList::setColor(Uint8 color)
 	_up->setColor(color);
 	_down->setColor(color);
 	_scrollbar->setColor(color);
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
+	for (std::vector< std::vector<TextListCell> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
 	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
+		for (std::vector<TextListCell>::iterator v = u->begin(); v < u->end(); ++v)
 		{
-			(*v)->setColor(color);
+			v->color = color;
+			v->color2 = color;
 		}
 	}
 }
@@ -507,13 +499,6 @@ void TextList::setWordWrap(bool wrap)
 void TextList::setHighContrast(bool contrast)
 {
 	_contrast = contrast;
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			(*v)->setHighContrast(contrast);
-		}
-	}
 	_scrollbar->setHighContrast(contrast);
 }
 
@@ -666,6 +651,7 @@ void TextList::setArrowColumn(int pos, ArrowOrientation type)
 	_arrowType = type;
 	_arrowsLeftEdge = getX() + _arrowPos;
 	_arrowsRightEdge = _arrowsLeftEdge + 12 + 11;
+	createArrowButtons();
 }
 
 /**
@@ -751,14 +737,6 @@ void TextList::onRightArrowRelease(ActionHandler handler)
  */
 void TextList::clearList()
 {
-	for (std::vector< std::vector<Text*> >::iterator u = _texts.begin(); u < _texts.end(); ++u)
-	{
-		for (std::vector<Text*>::iterator v = u->begin(); v < u->end(); ++v)
-		{
-			delete (*v);
-		}
-		u->clear();
-	}
 	scrollUp(true, false);
 	_texts.clear();
 	_rows.clear();
@@ -847,9 +825,146 @@ void TextList::updateVisible()
 	{
 		_visibleRows++;
 	}
+	createArrowButtons();
 	updateArrows();
 }
 
+/**
+ * Creates the left/right arrow buttons for any visible row
+ * that doesn't have them yet. The buttons belong to the row's
+ * position on screen, not to the row itself, so they're
+ * reused as the list scrolls.
+ */
+void TextList::createArrowButtons()
+{
+	if (_arrowPos == -1)
+		return;
+	ArrowShape shape1, shape2;
+	if (_arrowType == ARROW_VERTICAL)
+	{
+		shape1 = ARROW_SMALL_UP;
+		shape2 = ARROW_SMALL_DOWN;
+	}
+	else
+	{
+		shape1 = ARROW_SMALL_LEFT;
+		shape2 = ARROW_SMALL_RIGHT;
+	}
+	while (_arrowLeft.size() < std::min(_visibleRows, _texts.size()))
+	{
+		ArrowButton *a1 = new ArrowButton(shape1, 11, 8, getX() + _arrowPos, getY());
+		a1->setListButton();
+		a1->setPalette(this->getPalette());
+		a1->setColor(_up->getColor());
+		a1->onMouseClick(_leftClick, 0);
+		a1->onMousePress(_leftPress);
+		a1->onMouseRelease(_leftRelease);
+		_arrowLeft.push_back(a1);
+		ArrowButton *a2 = new ArrowButton(shape2, 11, 8, getX() + _arrowPos + 12, getY());
+		a2->setListButton();
+		a2->setPalette(this->getPalette());
+		a2->setColor(_up->getColor());
+		a2->onMouseClick(_rightClick, 0);
+		a2->onMousePress(_rightPress);
+		a2->onMouseRelease(_rightRelease);
+		_arrowRight.push_back(a2);
+	}
+}
+
+/**
+ * Returns the Text used to render every cell of a column
+ * with a certain height, creating it the first time.
+ * @param column Column number.
+ * @param height Cell height in pixels.
+ * @return Pointer to the Text.
+ */
+Text *TextList::getRenderer(size_t column, int height)
+{
+	std::pair<size_t, int> key = std::make_pair(column, height);
+	std::map< std::pair<size_t, int>, Text* >::iterator i = _renderers.find(key);
+	if (i != _renderers.end())
+	{
+		return i->second;
+	}
+	Text *txt = new Text(_columns[column], height, 0, 0);
+	txt->setPalette(this->getPalette());
+	txt->initText(_big, _small, _lang);
+	_renderers[key] = txt;
+	return txt;
+}
+
+/**
+ * Sets up the renderer of a cell with its contents. Big text
+ * that doesn't fit falls back to the small font, same as Text,
+ * and the cell keeps it from then on.
+ * @param cell Cell to lay out.
+ * @param column Column number.
+ * @return Pointer to the Text with the cell laid out.
+ */
+Text *TextList::layoutCell(TextListCell &cell, size_t column)
+{
+	Text *txt = getRenderer(column, cell.height);
+	txt->setAlign(cell.align);
+	txt->setHighContrast(_contrast);
+	txt->setColor(cell.color);
+	txt->setSecondaryColor(cell.color2);
+	txt->setWordWrap(cell.wrap, cell.wrap);
+	if (cell.small && txt->getFont() != _small)
+	{
+		txt->setSmall();
+	}
+	else if (!cell.small && txt->getFont() != _big)
+	{
+		txt->setBig();
+	}
+	txt->setText(cell.text);
+	cell.small = (txt->getFont() == _small);
+	return txt;
+}
+
+/**
+ * Draws a cell onto the list at its row position.
+ * @param cell Cell to draw.
+ * @param column Column number.
+ * @param y Y position of the row in pixels.
+ */
+void TextList::drawCell(TextListCell &cell, size_t column, int y)
+{
+	Text *txt = layoutCell(cell, column);
+	txt->setX(cell.x);
+	txt->setY(y);
+	txt->blit(this);
+}
+
+/**
+ * Updates the list after a cell changed. Visible cells are
+ * redrawn on their own unless the columns depend on each
+ * other, while hidden ones wait until they're scrolled into view.
+ * @param row Row number.
+ * @param column Column number.
+ */
+void TextList::updateCell(size_t row, size_t column)
+{
+	TextListCell &cell = _texts[row][column];
+	if (_rows.empty() || row < _rows[_scroll] || row >= _rows[_scroll] + _visibleRows)
+	{
+		if (!cell.small)
+		{
+			layoutCell(cell, column);
+		}
+	}
+	else if (_redraw || _condensed)
+	{
+		_redraw = true;
+	}
+	else
+	{
+		int y = getRowY(row) - getY();
+		drawRect(cell.x, y, _columns[column], cell.height, 0);
+		drawCell(cell, column, y);
+	}
+}
+
 /**
  * Changes whether the list can be scrolled.
  * @param scrolling True to allow scrolling, false otherwise.
@@ -880,19 +995,11 @@ void TextList::draw()
 			y -= _font->getHeight() + _font->getSpacing();
 		for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
 		{
-			for (std::vector<Text*>::iterator j = _texts[i].begin(); j < _texts[i].end(); ++j)
-			{
-				(*j)->setY(y);
-				(*j)->blit(this);
-			}
-			if (!_texts[i].empty())
-			{
-				y += _texts[i].front()->getHeight() + _font->getSpacing();
-			}
-			else
+			for (size_t j = 0; j < _texts[i].size(); ++j)
 			{
-				y += _font->getHeight() + _font->getSpacing();
+				drawCell(_texts[i][j], j, y);
 			}
+			y += getRowHeight(i) + _font->getSpacing();
 		}
 	}
 }
@@ -912,11 +1019,11 @@ void TextList::blit(Surface *surface)
 	{
 		if (_arrowPos != -1 && !_rows.empty())
 		{
-			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+			for (size_t i = 0; i < _visibleRows && i < _arrowLeft.size() && _rows[_scroll] + i < _texts.size(); ++i)
 			{
-				_arrowLeft[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowLeft[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowLeft[i]->blit(surface);
-				_arrowRight[i]->setY(getY() + (i - _scroll) * (_font->getHeight() + _font->getSpacing()));
+				_arrowRight[i]->setY(getY() + i * (_font->getHeight() + _font->getSpacing()));
 				_arrowRight[i]->blit(surface);
 			}
 		}
@@ -941,7 +1048,7 @@ void TextList::handle(Action *action, State *state)
 	{
 		if (!_rows.empty())
 		{
-			for (size_t i = _rows[_scroll]; i < _texts.size() && i < _rows[_scroll] + _visibleRows; ++i)
+			for (size_t i = 0; i < _visibleRows && i < _arrowLeft.size() && _rows[_scroll] + i < _texts.size(); ++i)
 			{
 				_arrowLeft[i]->handle(action, state);
 				_arrowRight[i]->handle(action, state);
@@ -1057,9 +1164,8 @@ void TextList::mouseOver(Action *action, State *state)
 		_selRow = std::max(0, (int)(_scroll + (int)floor(action->getRelativeYMouse() / (h * action->getYScale()))));
 		if (_selRow < _rows.size())
 		{
-			Text *selText = _texts[_rows[_selRow]].front();
-			int y = getY() + selText->getY();
-			int h = selText->getHeight() + _font->getSpacing();
+			int y = getRowY(_rows[_selRow]);
+			int h = getRowHeight(_rows[_selRow]) + _font->getSpacing();
 			if (y < getY() || y + h > getY() + getHeight())
 			{
 				h /= 2;
@@ -33,16 +33,31 @@ class ArrowButton;
 class ComboBox;
 class ScrollBar;
 
+/**
+ * Contents of a single cell in a TextList.
+ * Cells are only turned into pixels when their row is visible.
+ */
+struct TextListCell
+{
+	std::wstring text;
+	int x, height;
+	Uint8 color, color2;
+	TextHAlign align;
+	bool small, wrap;
+};
+
 /**
  * List of Text's split into columns.
  * Contains a set of Text's that are automatically lined up by
  * rows and columns, like a big table, making it easy to manage
- * them together.
+ * them together. Only the visible rows are rendered, through
+ * one Text per column shared by every row.
  */
 class TextList : public InteractiveSurface
 {
 private:
-	std::vector< std::vector<Text*> > _texts;
+	std::vector< std::vector<TextListCell> > _texts;
+	std::map< std::pair<size_t, int>, Text* > _renderers;
 	std::vector<size_t> _columns, _rows;
 	Font *_big, *_small, *_font;
 	Language *_lang;
@@ -66,6 +81,18 @@ private:
 	void updateArrows();
 	/// Updates the visible rows.
 	void updateVisible();
+	/// Creates the arrow buttons for the visible rows.
+	void createArrowButtons();
+	/// Gets the Text used to render a column.
+	Text *getRenderer(size_t column, int height);
+	/// Lays out a cell for rendering.
+	Text *layoutCell(TextListCell &cell, size_t column);
+	/// Draws a cell onto the text list.
+	void drawCell(TextListCell &cell, size_t column, int y);
+	/// Redraws a cell after it's changed.
+	void updateCell(size_t row, size_t column);
+	/// Gets the height of a certain row.
+	int getRowHeight(size_t row) const;
 public:
 	/// Creates a text list with the specified size and position.
 	TextList(int width, int height, int x = 0, int y = 0);
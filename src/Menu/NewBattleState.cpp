@@ -328,7 +328,7 @@ void NewBattleState::load(const std::string &filename)
 				}
 
 				// Generate items
-				base->getItems()->getContents()->clear();
+				base->getItems()->clear();
 				const std::vector<std::string> &items = rule->getItemsList();
 				for (std::vector<std::string>::const_iterator i = items.begin(); i != items.end(); ++i)
 				{
@@ -349,12 +349,13 @@ void NewBattleState::load(const std::string &filename)
 				else
 				{
 					_craft = base->getCrafts()->front();
-					for (std::map<std::string, int>::iterator i = _craft->getItems()->getContents()->begin(); i != _craft->getItems()->getContents()->end(); ++i)
+					const std::vector<int> &items = _craft->getItems()->getContents();
+					for (size_t i = 0; i < items.size(); ++i)
 					{
-						RuleItem *rule = _game->getRuleset()->getItem(i->first);
+						RuleItem *rule = _game->getRuleset()->getItem(i);
 						if (!rule)
 						{
-							i->second = 0;
+							_craft->getItems()->removeItem(i, items[i]);
 						}
 					}
 				}
@@ -422,7 +423,7 @@ void NewBattleState::initSave()
 	base->getSoldiers()->clear();
 	for (std::vector<Craft*>::iterator i = base->getCrafts()->begin(); i != base->getCrafts()->end(); ++i) delete (*i);
 	base->getCrafts()->clear();
-	base->getItems()->getContents()->clear();
+	base->getItems()->clear();
 
 	_craft = new Craft(rule->getCraft(_crafts[_cbxCraft->getSelected()]), base, 1);
 	base->getCrafts()->push_back(_craft);
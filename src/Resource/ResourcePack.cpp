@@ -17,6 +17,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ResourcePack.h"
+#include <algorithm>
+#include <cmath>
 #include <SDL_mixer.h>
 #include "../Engine/Palette.h"
 #include "../Engine/Font.h"
@@ -124,6 +126,80 @@ std::list<Polygon*> *ResourcePack::getPolygons()
 	return &_polygons;
 }
 
+/**
+ * Returns the polygons whose bounding box covers a point,
+ * in the same order as the list of polygons.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Reference to the candidate polygons.
+ */
+const std::vector<Polygon*> &ResourcePack::getPolygons(double lon, double lat) const
+{
+	return _polygonIndex.get(lon, lat);
+}
+
+/**
+ * Registers every world polygon in the cells of the polygon
+ * index covered by its bounding box. The box is taken around
+ * the shortest longitude span of the corners, and padded by a
+ * cell since the edges aren't exactly lines of latitude and
+ * longitude. Polygons reaching near a pole, or wrapping all the
+ * way around one, cover every longitude up to that pole.
+ */
+void ResourcePack::indexPolygons()
+{
+	const double polar = 75 * M_PI / 180;
+	_polygonIndex.clear();
+	for (std::list<Polygon*>::iterator i = _polygons.begin(); i != _polygons.end(); ++i)
+	{
+		Polygon *poly = *i;
+		if (poly->getPoints() == 0)
+			continue;
+		std::vector<double> lons;
+		double latMin = poly->getLatitude(0), latMax = latMin;
+		for (int j = 0; j < poly->getPoints(); ++j)
+		{
+			double lon = std::fmod(poly->getLongitude(j), 2 * M_PI);
+			if (lon < 0)
+				lon += 2 * M_PI;
+			lons.push_back(lon);
+			latMin = std::min(latMin, poly->getLatitude(j));
+			latMax = std::max(latMax, poly->getLatitude(j));
+		}
+		// the span is everything outside the largest gap between corners
+		std::sort(lons.begin(), lons.end());
+		double gap = lons.front() + 2 * M_PI - lons.back();
+		double lonMin = lons.front(), lonMax = lons.back();
+		for (size_t j = 1; j < lons.size(); ++j)
+		{
+			if (lons[j] - lons[j - 1] > gap)
+			{
+				gap = lons[j] - lons[j - 1];
+				lonMin = lons[j];
+				lonMax = lons[j - 1] + 2 * M_PI;
+			}
+		}
+		bool north = (latMax + latMin > 0);
+		latMin -= _polygonIndex.getCellHeight();
+		latMax += _polygonIndex.getCellHeight();
+		if (gap < M_PI || latMax > polar || latMin < -polar)
+		{
+			lonMin = 0;
+			lonMax = 2 * M_PI;
+			if (latMax > polar || (gap < M_PI && north))
+				latMax = M_PI / 2;
+			if (latMin < -polar || (gap < M_PI && !north))
+				latMin = -M_PI / 2;
+		}
+		else
+		{
+			lonMin -= _polygonIndex.getCellWidth();
+			lonMax += _polygonIndex.getCellWidth();
+		}
+		_polygonIndex.insert(lonMin, lonMax, latMin, latMax, poly);
+	}
+}
+
 /**
  * Returns the list of polylines in the resource set.
  * @return Pointer to the list of polylines.
@@ -24,6 +24,7 @@
 #include <list>
 #include <vector>
 #include <SDL.h>
+#include "../Geoscape/SpatialIndex.h"
 
 namespace OpenXcom
 {
@@ -60,9 +61,12 @@ protected:
 	std::map<std::string, SurfaceSet*> _sets;
 	std::map<std::string, SoundSet*> _sounds;
 	std::list<Polygon*> _polygons;
+	SpatialIndex<Polygon> _polygonIndex;
 	std::list<Polyline*> _polylines;
 	std::map<std::string, Music*> _musics;
 	std::vector<Uint16> _voxelData;
+	/// Builds the spatial index of the world polygons.
+	void indexPolygons();
 public:
 	/// Create a new resource pack with a folder's contents.
 	ResourcePack();
@@ -76,6 +80,8 @@ public:
 	SurfaceSet *getSurfaceSet(const std::string &name) const;
 	/// Gets the list of world polygons.
 	std::list<Polygon*> *getPolygons();
+	/// Gets the world polygons that might contain a point.
+	const std::vector<Polygon*> &getPolygons(double lon, double lat) const;
 	/// Gets the list of world polylines.
 	std::list<Polyline*> *getPolylines();
 	/// Gets a particular music.
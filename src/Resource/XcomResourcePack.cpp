@@ -45,6 +45,7 @@
 #include "../Ruleset/ExtraSprites.h"
 #include "../Ruleset/ExtraSounds.h"
 #include "../Engine/AdlibMusic.h"
+#include "../Engine/ThreadPool.h"
 
 namespace OpenXcom
 {
@@ -68,15 +69,232 @@ struct HairBleach
 	}
 };
 
+/// Kinds of file the loading threads can decode.
+enum ResourceType { RES_SCR, RES_SPK, RES_BDY, RES_IMAGE, RES_PCK, RES_DAT, RES_CAT_WAV, RES_CAT_RAW };
+
+/**
+ * Batch of resource files that don't depend on each other,
+ * decoded together on the thread pool. The objects they're
+ * decoded into are all created beforehand, so every job only
+ * fills in its own object and the maps of the resource
+ * pack are never touched from the workers.
+ */
+class ResourceQueue
+{
+private:
+	struct Entry
+	{
+		ResourceType type;
+		Surface *surface;
+		SurfaceSet *set;
+		SoundSet *sound;
+		std::string path, tab, error;
+	};
+	std::vector<Entry> _entries;
+
+	/**
+	 * Decodes one file of the batch. Errors are kept
+	 * for the loading thread to report afterwards, nothing
+	 * may be thrown out of a worker thread.
+	 * @param queue Pointer to the queue.
+	 * @param index Entry number.
+	 */
+	static void decode(void *queue, int index)
+	{
+		Entry &entry = ((ResourceQueue*)queue)->_entries[index];
+		try
+		{
+			switch (entry.type)
+			{
+			case RES_SCR:
+				entry.surface->loadScr(entry.path);
+				break;
+			case RES_SPK:
+				entry.surface->loadSpk(entry.path);
+				break;
+			case RES_BDY:
+				entry.surface->loadBdy(entry.path);
+				break;
+			case RES_IMAGE:
+				entry.surface->loadImage(entry.path);
+				break;
+			case RES_PCK:
+				entry.set->loadPck(entry.path, entry.tab);
+				break;
+			case RES_DAT:
+				entry.set->loadDat(entry.path);
+				break;
+			case RES_CAT_WAV:
+			case RES_CAT_RAW:
+				entry.sound->loadCat(entry.path, entry.type == RES_CAT_WAV);
+				break;
+			}
+		}
+		catch (std::exception &e)
+		{
+			entry.error = e.what();
+		}
+		catch (...)
+		{
+			entry.error = entry.path + " couldn't be loaded";
+		}
+	}
+
+	/// Adds an entry to the batch.
+	void add(ResourceType type, Surface *surface, SurfaceSet *set, SoundSet *sound, const std::string &path, const std::string &tab)
+	{
+		Entry entry;
+		entry.type = type;
+		entry.surface = surface;
+		entry.set = set;
+		entry.sound = sound;
+		entry.path = path;
+		entry.tab = tab;
+		_entries.push_back(entry);
+	}
+public:
+	/// Queues an image file to decode into a surface.
+	void add(ResourceType type, Surface *surface, const std::string &path)
+	{
+		add(type, surface, 0, 0, path, "");
+	}
+	/// Queues a PCK or DAT file to decode into a surface set.
+	void add(ResourceType type, SurfaceSet *set, const std::string &path, const std::string &tab = "")
+	{
+		add(type, 0, set, 0, path, tab);
+	}
+	/// Queues a CAT file to decode into a sound set.
+	void add(ResourceType type, SoundSet *sound, const std::string &path)
+	{
+		add(type, 0, 0, sound, path, "");
+	}
+	/**
+	 * Decodes every queued file, spread over the thread pool
+	 * if there is one, and empties the queue.
+	 * @param pool Pointer to the thread pool, or 0 to decode here.
+	 * @throw Exception The first error in queue order, if any.
+	 */
+	void run(ThreadPool *pool)
+	{
+		if (pool)
+		{
+			pool->run(decode, this, _entries.size());
+		}
+		else
+		{
+			for (size_t i = 0; i < _entries.size(); ++i)
+			{
+				decode(this, i);
+			}
+		}
+		std::vector<Entry> entries;
+		entries.swap(_entries);
+		for (std::vector<Entry>::const_iterator i = entries.begin(); i != entries.end(); ++i)
+		{
+			if (!i->error.empty())
+			{
+				throw Exception(i->error);
+			}
+		}
+	}
+};
+
+/**
+ * Mod images decoded ahead of time on the thread pool,
+ * so applying the extra sprites in order only has to
+ * pick them up. Each image is decoded into a surface of the
+ * size it's expected to be used at; anything that doesn't
+ * match (or failed) is just loaded again on the spot.
+ */
+class ImageCache
+{
+private:
+	struct Image
+	{
+		Surface *surface;
+		int width, height;
+	};
+	std::map<std::string, Image> _images;
+	ResourceQueue _queue;
+public:
+	/// Cleans up any images that weren't used.
+	~ImageCache()
+	{
+		for (std::map<std::string, Image>::iterator i = _images.begin(); i != _images.end(); ++i)
+		{
+			delete i->second.surface;
+		}
+	}
+	/// Queues an image to decode at a certain size.
+	void add(const std::string &path, int width, int height)
+	{
+		if (_images.find(path) != _images.end())
+			return;
+		Image image;
+		image.surface = new Surface(width, height);
+		image.width = width;
+		image.height = height;
+		_images[path] = image;
+		_queue.add(RES_IMAGE, image.surface, path);
+	}
+	/// Decodes all queued images.
+	void run(ThreadPool *pool)
+	{
+		try
+		{
+			_queue.run(pool);
+		}
+		catch (Exception &)
+		{
+			// reported when the image is actually used
+		}
+	}
+	/**
+	 * Gets a decoded image, handing it over to the caller.
+	 * @param path Full path to the image.
+	 * @param width Width of the surface to load it in.
+	 * @param height Height of the surface to load it in.
+	 * @return Pointer to the new surface.
+	 */
+	Surface *take(const std::string &path, int width, int height)
+	{
+		std::map<std::string, Image>::iterator i = _images.find(path);
+		if (i != _images.end())
+		{
+			Image image = i->second;
+			_images.erase(i);
+			if (image.width == width && image.height == height && image.surface->getSurface() != 0)
+			{
+				return image.surface;
+			}
+			delete image.surface;
+		}
+		Surface *surface = new Surface(width, height);
+		try
+		{
+			surface->loadImage(path);
+		}
+		catch (Exception &)
+		{
+			delete surface;
+			throw;
+		}
+		return surface;
+	}
+};
+
 }
 	
 /**
  * Initializes the resource pack by loading all the resources
  * contained in the original game folder.
+ * Files that don't depend on each other are decoded in batches
+ * on the thread pool, everything else is done here in order.
  * @param extraSprites List of mod extra sprites.
  * @param extraSounds List of mod extra sounds.
+ * @param pool Pointer to the thread pool to decode files on, if any.
  */
-XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds) : ResourcePack()
+XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds, ThreadPool *pool) : ResourcePack(), _pool(pool)
 {
 	// Load palettes
 	const char *pal[] = {"PAL_GEOSCAPE", "PAL_BASESCAPE", "PAL_GRAPHS", "PAL_UFOPAEDIA", "PAL_BATTLEPEDIA"};
@@ -136,11 +354,12 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 	}
 
 	// Load surfaces
+	ResourceQueue queue;
 	{
 		std::ostringstream s;
 		s << "GEODATA/" << "INTERWIN.DAT";
 		_surfaces["INTERWIN.DAT"] = new Surface(160, 556);
-		_surfaces["INTERWIN.DAT"]->loadScr(CrossPlatform::getDataFile(s.str()));
+		queue.add(RES_SCR, _surfaces["INTERWIN.DAT"], CrossPlatform::getDataFile(s.str()));
 	}
 
 	std::string geograph = CrossPlatform::getDataFolder("GEOGRAPH/");
@@ -150,7 +369,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::string path = geograph + *i;
 		std::transform(i->begin(), i->end(), i->begin(), toupper);
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadScr(path);
+		queue.add(RES_SCR, _surfaces[*i], path);
 	}
 	std::vector<std::string> bdys = CrossPlatform::getFolderContents(geograph, "BDY");
 	for (std::vector<std::string>::iterator i = bdys.begin(); i != bdys.end(); ++i)
@@ -158,44 +377,12 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::string path = geograph + *i;
 		std::transform(i->begin(), i->end(), i->begin(), toupper);
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadBdy(path);
-	}
-
-	// bigger geoscape background
-	int newWidth = 320 - 64, newHeight = 200;
-	Surface *newGeo = new Surface(newWidth*3, newHeight*3);
-	Surface *oldGeo = _surfaces["GEOBORD.SCR"];
-	for (int x = 0; x < newWidth; ++x)
-	{
-		for (int y = 0; y < newHeight; ++y)
-		{
-			newGeo->setPixel(newWidth+x, newHeight+y, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth-x-1, newHeight+y, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth*3-x-1, newHeight+y, oldGeo->getPixel(x, y));
-			
-			newGeo->setPixel(newWidth+x, newHeight-y-1, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth-x-1, newHeight-y-1, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth*3-x-1, newHeight-y-1, oldGeo->getPixel(x, y));
-			
-			newGeo->setPixel(newWidth+x, newHeight*3-y-1, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth-x-1, newHeight*3-y-1, oldGeo->getPixel(x, y));
-			newGeo->setPixel(newWidth*3-x-1, newHeight*3-y-1, oldGeo->getPixel(x, y));
-		}
+		queue.add(RES_BDY, _surfaces[*i], path);
 	}
-	_surfaces["ALTGEOBORD.SCR"] = newGeo;
 
 	// here we create an "alternate" background surface for the base info screen.
 	_surfaces["ALTBACK07.SCR"] = new Surface(320, 200);
-	_surfaces["ALTBACK07.SCR"]->loadScr(CrossPlatform::getDataFile("GEOGRAPH/BACK07.SCR"));
-	for (int y = 172; y >= 152; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+4, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
-	for (int y = 147; y >= 134; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+9, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
-	for (int y = 132; y >= 109; --y)
-		for (int x = 5; x <= 314; ++x)
-			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+10, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	queue.add(RES_SCR, _surfaces["ALTBACK07.SCR"], CrossPlatform::getDataFile("GEOGRAPH/BACK07.SCR"));
 
 	std::vector<std::string> spks = CrossPlatform::getFolderContents(geograph, "SPK");
 	for (std::vector<std::string>::iterator i = spks.begin(); i != spks.end(); ++i)
@@ -203,7 +390,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::string path = geograph + *i;
 		std::transform(i->begin(), i->end(), i->begin(), toupper);
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadSpk(path);
+		queue.add(RES_SPK, _surfaces[*i], path);
 	}
 
 	// Load intro
@@ -214,7 +401,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		std::string path = ufointro + *i;
 		std::transform(i->begin(), i->end(), i->begin(), toupper);
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadImage(path);
+		queue.add(RES_IMAGE, _surfaces[*i], path);
 	}
 
 	// Load surface sets
@@ -234,22 +421,60 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 			std::ostringstream s2;
 			s2 << "GEOGRAPH/" << tab;
 			_sets[sets[i]] = new SurfaceSet(32, 40);
-			_sets[sets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+			queue.add(RES_PCK, _sets[sets[i]], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 		}
 		else
 		{
 			_sets[sets[i]] = new SurfaceSet(32, 32);
-			_sets[sets[i]]->loadDat(CrossPlatform::getDataFile(s.str()));
+			queue.add(RES_DAT, _sets[sets[i]], CrossPlatform::getDataFile(s.str()));
 		}
 	}
 	_sets["SCANG.DAT"] = new SurfaceSet(4, 4);
 	std::ostringstream scang;
 	scang << "GEODATA/" << "SCANG.DAT";
-	_sets["SCANG.DAT"]->loadDat (CrossPlatform::getDataFile(scang.str()));
+	queue.add(RES_DAT, _sets["SCANG.DAT"], CrossPlatform::getDataFile(scang.str()));
+
+	queue.run(_pool);
+
+	// bigger geoscape background
+	int newWidth = 320 - 64, newHeight = 200;
+	Surface *newGeo = new Surface(newWidth*3, newHeight*3);
+	Surface *oldGeo = _surfaces["GEOBORD.SCR"];
+	for (int x = 0; x < newWidth; ++x)
+	{
+		for (int y = 0; y < newHeight; ++y)
+		{
+			newGeo->setPixel(newWidth+x, newHeight+y, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth-x-1, newHeight+y, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth*3-x-1, newHeight+y, oldGeo->getPixel(x, y));
+			
+			newGeo->setPixel(newWidth+x, newHeight-y-1, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth-x-1, newHeight-y-1, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth*3-x-1, newHeight-y-1, oldGeo->getPixel(x, y));
+			
+			newGeo->setPixel(newWidth+x, newHeight*3-y-1, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth-x-1, newHeight*3-y-1, oldGeo->getPixel(x, y));
+			newGeo->setPixel(newWidth*3-x-1, newHeight*3-y-1, oldGeo->getPixel(x, y));
+		}
+	}
+	_surfaces["ALTGEOBORD.SCR"] = newGeo;
+
+	// adjust the "alternate" background surface for the base info screen.
+	for (int y = 172; y >= 152; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+4, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	for (int y = 147; y >= 134; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+9, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+	for (int y = 132; y >= 109; --y)
+		for (int x = 5; x <= 314; ++x)
+			_surfaces["ALTBACK07.SCR"]->setPixel(x, y+10, _surfaces["ALTBACK07.SCR"]->getPixel(x,y));
+
 	// Load polygons
 	std::ostringstream s;
 	s << "GEODATA/" << "WORLD.DAT";
 	Globe::loadDat(CrossPlatform::getDataFile(s.str()), &_polygons);
+	indexPolygons();
 
 	// Load polylines (extracted from game)
 	// -10 = Start of line
@@ -436,7 +661,7 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 				if (CrossPlatform::fileExists(file))
 				{
 					sound = new SoundSet();
-					sound->loadCat(file, wav);
+					queue.add(wav ? RES_CAT_WAV : RES_CAT_RAW, sound, file);
 					Options::currentSound = (wav) ? SOUND_14 : SOUND_10;
 				}
 			}
@@ -453,14 +678,16 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/INTRO.CAT")))
 		{
 			SoundSet *s = _sounds["INTRO.CAT"] = new SoundSet();
-			s->loadCat(CrossPlatform::getDataFile("SOUND/INTRO.CAT"), false);
+			queue.add(RES_CAT_RAW, s, CrossPlatform::getDataFile("SOUND/INTRO.CAT"));
 		}
 
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT")))
 		{
 			SoundSet *s = _sounds["SAMPLE3.CAT"] = new SoundSet();
-			s->loadCat(CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT"), true);
+			queue.add(RES_CAT_WAV, s, CrossPlatform::getDataFile("SOUND/SAMPLE3.CAT"));
 		}
+
+		queue.run(_pool);
 	}
 
 	TextButton::soundPress = getSound("GEO.CAT", 0);
@@ -508,7 +735,52 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 		}
 
 	Log(LOG_INFO) << "Loading extra resources from ruleset...";
-	
+
+	// Decode all the mod images up front, the sheets are then put together in order
+	ImageCache images;
+	for (std::vector< std::pair<std::string, ExtraSprites *> >::const_iterator i = extraSprites.begin(); i != extraSprites.end(); ++i)
+	{
+		ExtraSprites *spritePack = i->second;
+		bool subdivision = (spritePack->getSubX() != 0 && spritePack->getSubY() != 0);
+		if (spritePack->getSingleImage())
+		{
+			images.add(CrossPlatform::getDataFile(spritePack->getSprites()->operator[](0)), spritePack->getWidth(), spritePack->getHeight());
+			continue;
+		}
+		int width = subdivision ? spritePack->getSubX() : spritePack->getWidth();
+		int height = subdivision ? spritePack->getSubY() : spritePack->getHeight();
+		if (_sets.find(i->first) != _sets.end())
+		{
+			width = _sets[i->first]->getWidth();
+			height = _sets[i->first]->getHeight();
+		}
+		for (std::map<int, std::string>::iterator j = spritePack->getSprites()->begin(); j != spritePack->getSprites()->end(); ++j)
+		{
+			std::string fileName = j->second;
+			if (fileName.substr(fileName.length() - 1, 1) == "/")
+			{
+				std::string folder = CrossPlatform::getDataFolder(fileName);
+				std::vector<std::string> contents = CrossPlatform::getFolderContents(folder);
+				for (std::vector<std::string>::iterator k = contents.begin(); k != contents.end(); ++k)
+				{
+					if (isImageFile((*k).substr((*k).length() -4, (*k).length())))
+					{
+						images.add(folder + CrossPlatform::getDataFile(*k), width, height);
+					}
+				}
+			}
+			else if (subdivision)
+			{
+				images.add(CrossPlatform::getDataFile(fileName), spritePack->getWidth(), spritePack->getHeight());
+			}
+			else
+			{
+				images.add(CrossPlatform::getDataFile(fileName), width, height);
+			}
+		}
+	}
+	images.run(_pool);
+
 	for (std::vector< std::pair<std::string, ExtraSprites *> >::const_iterator i = extraSprites.begin(); i != extraSprites.end(); ++i)
 	{
 		std::string sheetName = i->first;
@@ -519,17 +791,16 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 			if (_surfaces.find(sheetName) == _surfaces.end())
 			{
 				Log(LOG_DEBUG) << "Creating new single image: " << sheetName;
-				_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
 			}
 			else
 			{
 				Log(LOG_DEBUG) << "Adding/Replacing single image: " << sheetName;
 				delete _surfaces[sheetName];
-				_surfaces[sheetName] = new Surface(spritePack->getWidth(), spritePack->getHeight());
+				_surfaces.erase(sheetName);
 			}
 			s.str("");
 			s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](0));
-			_surfaces[sheetName]->loadImage(s.str());
+			_surfaces[sheetName] = images.take(s.str(), spritePack->getWidth(), spritePack->getHeight());
 		}
 		else
 		{
@@ -579,21 +850,22 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 						{
 							s.str("");
 							s << folder.str() << CrossPlatform::getDataFile(*k);
-							if (_sets[sheetName]->getFrame(offset))
+							SurfaceSet *set = _sets[sheetName];
+							if (set->getFrame(offset))
 							{
 								Log(LOG_DEBUG) << "Replacing frame: " << offset;
-								_sets[sheetName]->getFrame(offset)->loadImage(s.str());
+								set->setFrame(offset, images.take(s.str(), set->getWidth(), set->getHeight()));
 							}
 							else
 							{
 								if (adding)
 								{
-									_sets[sheetName]->addFrame(offset)->loadImage(s.str());
+									set->setFrame(offset, images.take(s.str(), set->getWidth(), set->getHeight()));
 								}
 								else
 								{
 									Log(LOG_DEBUG) << "Adding frame: " << offset + spritePack->getModIndex();
-									_sets[sheetName]->addFrame(offset + spritePack->getModIndex())->loadImage(s.str());
+									set->setFrame(offset + spritePack->getModIndex(), images.take(s.str(), set->getWidth(), set->getHeight()));
 								}
 							}
 							offset++;
@@ -609,23 +881,23 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 					if (spritePack->getSubX() == 0 && spritePack->getSubY() == 0)
 					{
 						s << CrossPlatform::getDataFile(fileName);
-						if (_sets[sheetName]->getFrame(startFrame))
+						SurfaceSet *set = _sets[sheetName];
+						if (set->getFrame(startFrame))
 						{
 							Log(LOG_DEBUG) << "Replacing frame: " << startFrame;
-							_sets[sheetName]->getFrame(startFrame)->loadImage(s.str());
+							set->setFrame(startFrame, images.take(s.str(), set->getWidth(), set->getHeight()));
 						}
 						else
 						{
 							Log(LOG_DEBUG) << "Adding frame: " << startFrame << ", using index: " << startFrame + spritePack->getModIndex();
-							_sets[sheetName]->addFrame(startFrame + spritePack->getModIndex())->loadImage(s.str());
+							set->setFrame(startFrame + spritePack->getModIndex(), images.take(s.str(), set->getWidth(), set->getHeight()));
 						}
 					}
 					else
 					{
-						Surface *temp = new Surface(spritePack->getWidth(), spritePack->getHeight());
 						s.str("");
 						s << CrossPlatform::getDataFile(spritePack->getSprites()->operator[](startFrame));
-						temp->loadImage(s.str());
+						Surface *temp = images.take(s.str(), spritePack->getWidth(), spritePack->getHeight());
 						int xDivision = spritePack->getWidth() / spritePack->getSubX();
 						int yDivision = spritePack->getHeight() / spritePack->getSubY();
 						int offset = startFrame;
@@ -662,20 +934,24 @@ XcomResourcePack::XcomResourcePack(std::vector<std::pair<std::string, ExtraSprit
 					}
 				}
 			}
+			_sets[sheetName]->buildSpans();
 		}
 	}
 
 	// copy constructor doesn't like doing this directly, so let's make a second handobs file the old fashioned way.
 	// handob2 is used for all the left handed sprites.
 	_sets["HANDOB2.PCK"] = new SurfaceSet(_sets["HANDOB.PCK"]->getWidth(), _sets["HANDOB.PCK"]->getHeight());
-	std::map<int, Surface*> *handob = _sets["HANDOB.PCK"]->getFrames();
-	for (std::map<int, Surface*>::const_iterator i = handob->begin(); i != handob->end(); ++i)
+	std::vector<Surface*> *handob = _sets["HANDOB.PCK"]->getFrames();
+	for (size_t i = 0; i != handob->size(); ++i)
 	{
-		Surface *surface1 = _sets["HANDOB2.PCK"]->addFrame(i->first);
-		Surface *surface2 = i->second;
+		Surface *surface2 = handob->at(i);
+		if (surface2 == 0)
+			continue;
+		Surface *surface1 = _sets["HANDOB2.PCK"]->addFrame(i);
 		surface1->setPalette(surface2->getPalette());
 		surface2->blit(surface1);
 	}
+	_sets["HANDOB2.PCK"]->buildSpans();
 
 	for (std::vector< std::pair<std::string, ExtraSounds *> >::const_iterator i = extraSounds.begin(); i != extraSounds.end(); ++i)
 	{
@@ -752,49 +1028,51 @@ XcomResourcePack::~XcomResourcePack()
  */
 void XcomResourcePack::loadBattlescapeResources()
 {
+	ResourceQueue queue;
+
 	// Load Battlescape ICONS
 	std::ostringstream s;
 	s << "UFOGRAPH/" << "SPICONS.DAT";
 	_sets["SPICONS.DAT"] = new SurfaceSet(32, 24);
-	_sets["SPICONS.DAT"]->loadDat(CrossPlatform::getDataFile(s.str()));
+	queue.add(RES_DAT, _sets["SPICONS.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	s.str("");
 	std::ostringstream s2;
 	s << "UFOGRAPH/" << "CURSOR.PCK";
 	s2 << "UFOGRAPH/" << "CURSOR.TAB";
 	_sets["CURSOR.PCK"] = new SurfaceSet(32, 40);
-	_sets["CURSOR.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	queue.add(RES_PCK, _sets["CURSOR.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "SMOKE.PCK";
 	s2 << "UFOGRAPH/" << "SMOKE.TAB";
 	_sets["SMOKE.PCK"] = new SurfaceSet(32, 40);
-	_sets["SMOKE.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	queue.add(RES_PCK, _sets["SMOKE.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 	
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "HIT.PCK";
 	s2 << "UFOGRAPH/" << "HIT.TAB";
 	_sets["HIT.PCK"] = new SurfaceSet(32, 40);
-	_sets["HIT.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	queue.add(RES_PCK, _sets["HIT.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	s2.str("");
 	s << "UFOGRAPH/" << "X1.PCK";
 	s2 << "UFOGRAPH/" << "X1.TAB";
 	_sets["X1.PCK"] = new SurfaceSet(128, 64);
-	_sets["X1.PCK"]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+	queue.add(RES_PCK, _sets["X1.PCK"], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 
 	s.str("");
 	_sets["MEDIBITS.DAT"] = new SurfaceSet(52, 58);
 	s << "UFOGRAPH/" << "MEDIBITS.DAT";
-	_sets["MEDIBITS.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	queue.add(RES_DAT, _sets["MEDIBITS.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	s.str("");
 	_sets["DETBLOB.DAT"] = new SurfaceSet(16, 16);
 	s << "UFOGRAPH/" << "DETBLOB.DAT";
-	_sets["DETBLOB.DAT"]->loadDat (CrossPlatform::getDataFile(s.str()));
+	queue.add(RES_DAT, _sets["DETBLOB.DAT"], CrossPlatform::getDataFile(s.str()));
 
 	// Load Battlescape Terrain (only blacks are loaded, others are loaded just in time)
 	std::string bsets[] = {"BLANKS.PCK"};
@@ -807,7 +1085,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::ostringstream s2;
 		s2 << "TERRAIN/" << tab;
 		_sets[bsets[i]] = new SurfaceSet(32, 40);
-		_sets[bsets[i]]->loadPck(CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
+		queue.add(RES_PCK, _sets[bsets[i]], CrossPlatform::getDataFile(s.str()), CrossPlatform::getDataFile(s2.str()));
 	}
 
 	// Load Battlescape units
@@ -822,17 +1100,8 @@ void XcomResourcePack::loadBattlescapeResources()
 			_sets[*i] = new SurfaceSet(32, 40);
 		else
 			_sets[*i] = new SurfaceSet(32, 48);
-		_sets[*i]->loadPck(path, tab);
-	}
-	// incomplete chryssalid set: 1.0 data: stop loading.
-	if (_sets.find("CHRYS.PCK") != _sets.end() && !_sets["CHRYS.PCK"]->getFrame(225))
-	{
-		Log(LOG_FATAL) << "Version 1.0 data detected";
-		throw Exception("Invalid CHRYS.PCK, please patch your X-COM data to the latest version");
+		queue.add(RES_PCK, _sets[*i], path, tab);
 	}
-	s.str("");
-	s << "GEODATA/" << "LOFTEMPS.DAT";
-	MapDataSet::loadLOFTEMPS(CrossPlatform::getDataFile(s.str()), &_voxelData);
 
 	std::string scrs[] = {"TAC00.SCR"};
 
@@ -841,7 +1110,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::ostringstream s;
 		s << "UFOGRAPH/" << scrs[i];
 		_surfaces[scrs[i]] = new Surface(320, 200);
-		_surfaces[scrs[i]]->loadScr(CrossPlatform::getDataFile(s.str()));
+		queue.add(RES_SCR, _surfaces[scrs[i]], CrossPlatform::getDataFile(s.str()));
 	}
 	
 
@@ -853,22 +1122,17 @@ void XcomResourcePack::loadBattlescapeResources()
 						  "PAL_BATTLESCAPE_1",
 						  "PAL_BATTLESCAPE_2",
 						  "PAL_BATTLESCAPE_3"};
+	Surface *lbmSurfaces[sizeof(lbms)/sizeof(lbms[0])];
 
 	for (size_t i = 0; i < sizeof(lbms)/sizeof(lbms[0]); ++i)
 	{
 		std::ostringstream s;
 		s << "UFOGRAPH/" << lbms[i];
+		lbmSurfaces[i] = 0;
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s.str())))
 		{
-			if (!i)
-			{
-				delete _palettes["PAL_BATTLESCAPE"];
-			}
-			Surface *tempSurface = new Surface(1, 1);
-			tempSurface->loadImage(CrossPlatform::getDataFile(s.str()));
-			_palettes[pals[i]] = new Palette();
-			_palettes[pals[i]]->setColors(tempSurface->getPalette(), 256);
-			delete tempSurface;
+			lbmSurfaces[i] = new Surface(1, 1);
+			queue.add(RES_IMAGE, lbmSurfaces[i], CrossPlatform::getDataFile(s.str()));
 		}
 	}
 
@@ -887,7 +1151,7 @@ void XcomResourcePack::loadBattlescapeResources()
 		if (CrossPlatform::fileExists(CrossPlatform::getDataFile(s.str())))
 		{
 			_surfaces[spks[i]] = new Surface(320, 200);
-			_surfaces[spks[i]]->loadSpk(CrossPlatform::getDataFile(s.str()));
+			queue.add(RES_SPK, _surfaces[spks[i]], CrossPlatform::getDataFile(s.str()));
 		}
 	}
 
@@ -912,7 +1176,7 @@ void XcomResourcePack::loadBattlescapeResources()
 			*i = *i + "PCK";
 		}
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadBdy(path);
+		queue.add(RES_BDY, _surfaces[*i], path);
 	}
 
 	// Load Battlescape inventory
@@ -922,9 +1186,47 @@ void XcomResourcePack::loadBattlescapeResources()
 		std::string path = ufograph + *i;
 		std::transform(i->begin(), i->end(), i->begin(), toupper);
 		_surfaces[*i] = new Surface(320, 200);
-		_surfaces[*i]->loadSpk(path);
+		queue.add(RES_SPK, _surfaces[*i], path);
+	}
+
+	try
+	{
+		queue.run(_pool);
+	}
+	catch (Exception &)
+	{
+		for (size_t i = 0; i < sizeof(lbms)/sizeof(lbms[0]); ++i)
+		{
+			delete lbmSurfaces[i];
+		}
+		throw;
+	}
+
+	// Battlescape palettes come from the LBM images
+	for (size_t i = 0; i < sizeof(lbms)/sizeof(lbms[0]); ++i)
+	{
+		if (lbmSurfaces[i])
+		{
+			if (!i)
+			{
+				delete _palettes["PAL_BATTLESCAPE"];
+			}
+			_palettes[pals[i]] = new Palette();
+			_palettes[pals[i]]->setColors(lbmSurfaces[i]->getPalette(), 256);
+			delete lbmSurfaces[i];
+		}
 	}
 
+	// incomplete chryssalid set: 1.0 data: stop loading.
+	if (_sets.find("CHRYS.PCK") != _sets.end() && !_sets["CHRYS.PCK"]->getFrame(225))
+	{
+		Log(LOG_FATAL) << "Version 1.0 data detected";
+		throw Exception("Invalid CHRYS.PCK, please patch your X-COM data to the latest version");
+	}
+	s.str("");
+	s << "GEODATA/" << "LOFTEMPS.DAT";
+	MapDataSet::loadLOFTEMPS(CrossPlatform::getDataFile(s.str()), &_voxelData);
+
 	//"fix" of hair color of male personal armor
 	if (Options::battleHairBleach)
 	{
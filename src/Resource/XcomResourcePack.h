@@ -30,15 +30,18 @@ class ExtraSounds;
 class CatFile;
 class GMCatFile;
 class Music;
+class ThreadPool;
 
 /**
  * Resource pack for the X-Com: UFO Defense game.
  */
 class XcomResourcePack : public ResourcePack
 {
+private:
+	ThreadPool *_pool;
 public:
 	/// Creates the X-Com ruleset.
-	XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds);
+	XcomResourcePack(std::vector<std::pair<std::string, ExtraSprites *> > extraSprites, std::vector<std::pair<std::string, ExtraSounds *> > extraSounds, ThreadPool *pool = 0);
 	/// Cleans up the X-Com ruleset.
 	~XcomResourcePack();
 	/// Loads battlescape specific resources.
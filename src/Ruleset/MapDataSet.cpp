@@ -18,12 +18,13 @@
  */
 #include "MapDataSet.h"
 #include "MapData.h"
-#include <fstream>
+#include <cstring>
 #include <sstream>
 #include <SDL_endian.h>
 #include "../Engine/Exception.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/FileMap.h"
 
 namespace OpenXcom
 {
@@ -163,14 +164,18 @@ void MapDataSet::loadData()
 	s << "TERRAIN/" << _name << ".MCD";
 
 	// Load file
-	std::ifstream mapFile (CrossPlatform::getDataFile(s.str()).c_str(), std::ios::in | std::ios::binary);
+	FileMap mapFile(CrossPlatform::getDataFile(s.str()));
 	if (!mapFile)
 	{
 		throw Exception(s.str() + " not found");
 	}
 
-	while (mapFile.read((char*)&mcd, sizeof(MCD)))
+	size_t records = mapFile.getSize() / sizeof(MCD);
+	_objects.reserve(records);
+
+	for (size_t record = 0; record < records; ++record)
 	{
+		memcpy(&mcd, mapFile.getData() + record * sizeof(MCD), sizeof(MCD));
 		MapData *to = new MapData(this);
 		_objects.push_back(to);
 
@@ -213,14 +218,6 @@ void MapDataSet::loadData()
 		objNumber++;
 	}
 
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid MCD file");
-	}
-
-	mapFile.close();
-
 	// process the mapdataset to put block values on floortiles (as we don't have em in UFO)
 	for (std::vector<MapData*>::iterator i = _objects.begin(); i != _objects.end(); ++i)
 	{
@@ -268,26 +265,21 @@ void MapDataSet::unloadData()
 void MapDataSet::loadLOFTEMPS(const std::string &filename, std::vector<Uint16> *voxelData)
 {
 	// Load file
-	std::ifstream mapFile (filename.c_str(), std::ios::in | std::ios::binary);
+	FileMap mapFile(filename);
 	if (!mapFile)
 	{
 		throw Exception(filename + " not found");
 	}
 
-	Uint16 value;
+	size_t values = mapFile.getSize() / sizeof(Uint16);
+	voxelData->reserve(voxelData->size() + values);
 
-	while (mapFile.read((char*)&value, sizeof(value)))
+	for (size_t i = 0; i < values; ++i)
 	{
-		value = SDL_SwapLE16(value);
-		voxelData->push_back(value);
+		Uint16 value;
+		memcpy(&value, mapFile.getData() + i * sizeof(value), sizeof(value));
+		voxelData->push_back(SDL_SwapLE16(value));
 	}
-
-	if (!mapFile.eof())
-	{
-		throw Exception("Invalid LOFTEMPS");
-	}
-
-	mapFile.close();
 }
 
 /**
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RuleIds.h"
+#include <map>
+#include <vector>
+
+namespace OpenXcom
+{
+
+namespace RuleIds
+{
+
+namespace
+{
+
+/// IDs of every interned name.
+std::map<std::string, int> _ids;
+/// Names of every ID, in order.
+std::vector<std::string> _names;
+
+}
+
+/**
+ * Gets the ID of a rule name. Names seen for the
+ * first time get the next free ID.
+ * @param name Rule name.
+ * @return ID of the name.
+ */
+int intern(const std::string &name)
+{
+	std::map<std::string, int>::const_iterator i = _ids.find(name);
+	if (i != _ids.end())
+	{
+		return i->second;
+	}
+	int id = _names.size();
+	_ids[name] = id;
+	_names.push_back(name);
+	return id;
+}
+
+/**
+ * Gets the ID of a rule name without handing out
+ * a new one, for lookups that shouldn't add names.
+ * @param name Rule name.
+ * @return ID of the name, or -1 if it has none.
+ */
+int find(const std::string &name)
+{
+	std::map<std::string, int>::const_iterator i = _ids.find(name);
+	if (i != _ids.end())
+	{
+		return i->second;
+	}
+	return -1;
+}
+
+/**
+ * Gets the rule name an ID was handed out for.
+ * @param id ID of the name.
+ * @return Rule name.
+ */
+const std::string &getName(int id)
+{
+	return _names[id];
+}
+
+/**
+ * Gets the amount of IDs handed out so far,
+ * which bounds any table indexed by them.
+ * @return Amount of IDs.
+ */
+int size()
+{
+	return _names.size();
+}
+
+}
+
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_RULEIDS_H
+#define OPENXCOM_RULEIDS_H
+
+#include <string>
+
+namespace OpenXcom
+{
+
+/**
+ * Interns rule names, handing out a dense integer ID for
+ * each one so runtime objects can refer to rules by number
+ * and keep flat tables instead of maps keyed by strings.
+ * IDs are shared by every kind of rule, so an item and
+ * the unit or research with the same name share one too.
+ * They only last for the session, saves keep the names.
+ */
+namespace RuleIds
+{
+	/// Gets the ID of a name, giving it a new one if needed.
+	int intern(const std::string &name);
+	/// Gets the ID of a name, if it has one.
+	int find(const std::string &name);
+	/// Gets the name an ID stands for.
+	const std::string &getName(int id);
+	/// Gets the amount of IDs handed out.
+	int size();
+}
+
+}
+
+#endif
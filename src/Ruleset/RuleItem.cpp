@@ -17,6 +17,7 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleItem.h"
+#include <algorithm>
 #include "RuleInventory.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/Surface.h"
@@ -35,7 +36,7 @@ RuleItem::RuleItem(const std::string &type) : _type(type), _name(type), _size(0.
 											_painKiller(0), _heal(0), _stimulant(0), _woundRecovery(0), _healthRecovery(0), _stunRecovery(0), _energyRecovery(0), _tuUse(0), _recoveryPoints(0), _armor(20), _turretType(-1),
 											_recover(true), _liveAlien(false), _blastRadius(-1), _attraction(0), _flatRate(false), _arcingShot(false), _listOrder(0),
 											_maxRange(200), _aimRange(200), _snapRange(15), _autoRange(7), _minRange(0), _dropoff(2), _bulletSpeed(0), _explosionSpeed(0), _autoShots(3), _shotgunPellets(0), _zombieUnit(""),
-											_strengthApplied(false), _skillApplied(true), _LOSRequired(false), _meleeSound(39), _meleePower(0), _meleeAnimation(0), _meleeHitSound(-1)
+											_strengthApplied(false), _skillApplied(true), _LOSRequired(false), _meleeSound(39), _meleePower(0), _meleeAnimation(0), _meleeHitSound(-1), _id(-1)
 {
 }
 
@@ -448,6 +449,48 @@ std::vector<std::string> *RuleItem::getCompatibleAmmo()
 	return &_compatibleAmmo;
 }
 
+/**
+ * Checks if an item can be loaded into this one,
+ * comparing against the ammo rules resolved by link().
+ * @param ammo Rules of the item to check.
+ * @return True if the item is compatible ammo.
+ */
+bool RuleItem::isCompatibleAmmo(const RuleItem *ammo) const
+{
+	return std::find(_compatibleAmmoRules.begin(), _compatibleAmmoRules.end(), ammo) != _compatibleAmmoRules.end();
+}
+
+/**
+ * Links this item to the ruleset's other items,
+ * resolving the compatible ammo names to their rules.
+ * Ammo types without rules are skipped.
+ * @param id Rule ID of the item type.
+ * @param items Map of item types to rules.
+ */
+void RuleItem::link(int id, const std::map<std::string, RuleItem*> &items)
+{
+	_id = id;
+	_compatibleAmmoRules.clear();
+	for (std::vector<std::string>::const_iterator i = _compatibleAmmo.begin(); i != _compatibleAmmo.end(); ++i)
+	{
+		std::map<std::string, RuleItem*>::const_iterator j = items.find(*i);
+		if (j != items.end())
+		{
+			_compatibleAmmoRules.push_back(j->second);
+		}
+	}
+}
+
+/**
+ * Gets the rule ID of the item type, for
+ * containers and tables indexed by item.
+ * @return The rule ID, or -1 if not linked.
+ */
+int RuleItem::getId() const
+{
+	return _id;
+}
+
 /**
  * Gets the item's damage type.
  * @return The damage type.
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -49,6 +50,7 @@ private:
 	int _fireSound, _hitSound, _hitAnimation;
 	int _power;
 	std::vector<std::string> _compatibleAmmo;
+	std::vector<const RuleItem*> _compatibleAmmoRules;
 	ItemDamageType _damageType;
 	int _accuracyAuto, _accuracySnap, _accuracyAimed, _tuAuto, _tuSnap, _tuAimed;
 	int _clipSize, _accuracyMelee, _tuMelee;
@@ -68,6 +70,7 @@ private:
 	std::string _zombieUnit;
 	bool _strengthApplied, _skillApplied, _LOSRequired;
 	int _meleeSound, _meleePower, _meleeAnimation, _meleeHitSound;
+	int _id;
 public:
 	/// Creates a blank item ruleset.
 	RuleItem(const std::string &type);
@@ -131,6 +134,12 @@ public:
 	int getTUMelee() const;
 	/// Gets list of compatible ammo.
 	std::vector<std::string> *getCompatibleAmmo();
+	/// Checks if an item is compatible ammo for this one.
+	bool isCompatibleAmmo(const RuleItem *ammo) const;
+	/// Links the item to the ruleset's other items.
+	void link(int id, const std::map<std::string, RuleItem*> &items);
+	/// Gets the item's rule ID.
+	int getId() const;
 	/// Gets the item's damage type.
 	ItemDamageType getDamageType() const;
 	/// Gets the item's type.
@@ -17,11 +17,12 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "RuleResearch.h"
+#include <algorithm>
 
 namespace OpenXcom
 {
 
-RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(), _requires(), _needItem(false), _listOrder(0)
+RuleResearch::RuleResearch(const std::string & name) : _name(name), _lookup(""), _cost(0), _points(0), _getOneFree(), _requires(), _needItem(false), _listOrder(0), _index(-1)
 {
 }
 
@@ -138,4 +139,108 @@ int RuleResearch::getListOrder() const
 	return _listOrder;
 }
 
+/**
+ * Resolves a list of research names into their ruleset indices.
+ * Names that don't match any research are kept as -1, so they
+ * are never considered discovered.
+ * @param names List of research names.
+ * @param indices Map of research names to indices.
+ * @param out List to fill with the indices.
+ */
+void RuleResearch::resolve(const std::vector<std::string> &names, const std::map<std::string, int> &indices, std::vector<int> &out)
+{
+	out.clear();
+	for (std::vector<std::string>::const_iterator i = names.begin(); i != names.end(); ++i)
+	{
+		std::map<std::string, int>::const_iterator j = indices.find(*i);
+		out.push_back(j != indices.end() ? j->second : -1);
+	}
+}
+
+/**
+ * Links this research into the ruleset's research index,
+ * resolving all the research names it refers to.
+ * @param index Index of this research in the ruleset.
+ * @param indices Map of research names to indices.
+ */
+void RuleResearch::link(int index, const std::map<std::string, int> &indices)
+{
+	_index = index;
+	resolve(_dependencies, indices, _dependencyIndices);
+	resolve(_unlocks, indices, _unlockIndices);
+	resolve(_getOneFree, indices, _getOneFreeIndices);
+	resolve(_requires, indices, _requiresIndices);
+	_dependents.clear();
+}
+
+/**
+ * Adds a research that lists this one as a dependency
+ * or in its unlocks. The list is kept sorted and unique,
+ * so it follows the ruleset's research order.
+ * @param index Index of the dependent research.
+ */
+void RuleResearch::addDependent(int index)
+{
+	std::vector<int>::iterator i = std::lower_bound(_dependents.begin(), _dependents.end(), index);
+	if (i == _dependents.end() || *i != index)
+	{
+		_dependents.insert(i, index);
+	}
+}
+
+/**
+ * Gets the index of this research in the ruleset's research list.
+ * @return The research index, or -1 if not linked.
+ */
+int RuleResearch::getIndex() const
+{
+	return _index;
+}
+
+/**
+ * Gets the indices of the dependencies of this research.
+ * @return The list of indices (-1 for unknown research).
+ */
+const std::vector<int> &RuleResearch::getDependencyIndices() const
+{
+	return _dependencyIndices;
+}
+
+/**
+ * Gets the indices of the ResearchProjects unlocked by this research.
+ * @return The list of indices (-1 for unknown research).
+ */
+const std::vector<int> &RuleResearch::getUnlockedIndices() const
+{
+	return _unlockIndices;
+}
+
+/**
+ * Gets the indices of the ResearchProjects granted for free by this research.
+ * @return The list of indices (-1 for unknown research).
+ */
+const std::vector<int> &RuleResearch::getGetOneFreeIndices() const
+{
+	return _getOneFreeIndices;
+}
+
+/**
+ * Gets the indices of the requirements for this ResearchProject.
+ * @return The list of indices (-1 for unknown research).
+ */
+const std::vector<int> &RuleResearch::getRequirementIndices() const
+{
+	return _requiresIndices;
+}
+
+/**
+ * Gets the indices of the research which list this one
+ * as a dependency or in their unlocks, in ruleset order.
+ * @return The list of indices.
+ */
+const std::vector<int> &RuleResearch::getDependents() const
+{
+	return _dependents;
+}
+
 }
@@ -21,6 +21,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -44,7 +45,10 @@ class RuleResearch
 	int _cost, _points;
 	std::vector<std::string> _dependencies, _unlocks, _getOneFree, _requires;
 	bool _needItem;
-	int _listOrder;
+	int _listOrder, _index;
+	std::vector<int> _dependencyIndices, _unlockIndices, _getOneFreeIndices, _requiresIndices, _dependents;
+	/// Resolves a list of research names into indices.
+	static void resolve(const std::vector<std::string> &names, const std::map<std::string, int> &indices, std::vector<int> &out);
 public:
 	RuleResearch(const std::string & name);
 	/// Loads the research from YAML.
@@ -69,6 +73,22 @@ public:
 	const std::vector<std::string> & getRequirements() const;
 	/// Gets the list weight for this research item.
 	int getListOrder() const;
+	/// Links the research into the ruleset's research index.
+	void link(int index, const std::map<std::string, int> &indices);
+	/// Adds a research that depends on or is unlocked through this one.
+	void addDependent(int index);
+	/// Gets the index of this research in the ruleset.
+	int getIndex() const;
+	/// Gets the indices of the research dependencies.
+	const std::vector<int> &getDependencyIndices() const;
+	/// Gets the indices of the ResearchProjects unlocked by this research.
+	const std::vector<int> &getUnlockedIndices() const;
+	/// Gets the indices of the ResearchProjects granted for free by this research.
+	const std::vector<int> &getGetOneFreeIndices() const;
+	/// Gets the indices of the requirements for this ResearchProject.
+	const std::vector<int> &getRequirementIndices() const;
+	/// Gets the indices of the research that can become available through this one.
+	const std::vector<int> &getDependents() const;
 };
 }
 
@@ -23,6 +23,7 @@
 #include "../Engine/Options.h"
 #include "../Engine/Exception.h"
 #include "../Engine/CrossPlatform.h"
+#include "RulesetCache.h"
 #include "SoldierNamePool.h"
 #include "RuleCountry.h"
 #include "RuleRegion.h"
@@ -30,6 +31,7 @@
 #include "RuleCraft.h"
 #include "RuleCraftWeapon.h"
 #include "RuleItem.h"
+#include "RuleIds.h"
 #include "RuleUfo.h"
 #include "RuleTerrain.h"
 #include "MapDataSet.h"
@@ -196,24 +198,26 @@ Ruleset::~Ruleset()
 /**
  * Loads a ruleset's contents from the given source.
  * @param source The source to use.
+ * @param cache Cache of parsed ruleset files, if any.
  */
-void Ruleset::load(const std::string &source)
+void Ruleset::load(const std::string &source, RulesetCache *cache)
 {
 	std::string dirname = CrossPlatform::getDataFolder("Ruleset/" + source + '/');
 	if (!CrossPlatform::folderExists(dirname))
-		loadFile(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"));
+		loadFile(CrossPlatform::getDataFile("Ruleset/" + source + ".rul"), cache);
 	else
-		loadFiles(dirname);
+		loadFiles(dirname, cache);
 }
 
 /**
  * Loads a ruleset's contents from a YAML file.
  * Rules that match pre-existing rules overwrite them.
  * @param filename YAML filename.
+ * @param cache Cache of parsed ruleset files, if any.
  */
-void Ruleset::loadFile(const std::string &filename)
+void Ruleset::loadFile(const std::string &filename, RulesetCache *cache)
 {
-	YAML::Node doc = YAML::LoadFile(filename);
+	YAML::Node doc = cache ? cache->load(filename) : YAML::LoadFile(filename);
 
 	for (YAML::const_iterator i = doc["countries"].begin(); i != doc["countries"].end(); ++i)
 	{
@@ -501,14 +505,15 @@ void Ruleset::loadFile(const std::string &filename)
 /**
  * Loads the contents of all the rule files in the given directory.
  * @param dirname The name of an existing directory containing rule files.
+ * @param cache Cache of parsed ruleset files, if any.
  */
-void Ruleset::loadFiles(const std::string &dirname)
+void Ruleset::loadFiles(const std::string &dirname, RulesetCache *cache)
 {
 	std::vector<std::string> names = CrossPlatform::getFolderContents(dirname, "rul");
 
 	for (std::vector<std::string>::iterator i = names.begin(); i != names.end(); ++i)
 	{
-		loadFile(dirname + *i);
+		loadFile(dirname + *i, cache);
 	}
 }
 
@@ -704,6 +709,16 @@ RuleCraft *Ruleset::getCraft(const std::string &id) const
 	if (_crafts.end() != i) return i->second; else return 0;
 }
 
+/**
+ * Returns the rules for the specified craft.
+ * @param id Rule ID of the craft type.
+ * @return Rules for the craft.
+ */
+RuleCraft *Ruleset::getCraft(int id) const
+{
+	if (id >= 0 && id < (int)_craftTable.size()) return _craftTable[id]; else return 0;
+}
+
 /**
  * Returns the list of all crafts
  * provided by the ruleset.
@@ -742,10 +757,18 @@ const std::vector<std::string> &Ruleset::getCraftWeaponsList() const
  */
 RuleItem *Ruleset::getItem(const std::string &id) const
 {
-	if (_items.find(id) != _items.end())
-		return _items.find(id)->second;
-	else
-		return 0;
+	std::map<std::string, RuleItem*>::const_iterator i = _items.find(id);
+	if (_items.end() != i) return i->second; else return 0;
+}
+
+/**
+ * Returns the rules for the specified item.
+ * @param id Rule ID of the item type.
+ * @return Rules for the item, or 0 when the item is not found.
+ */
+RuleItem *Ruleset::getItem(int id) const
+{
+	if (id >= 0 && id < (int)_itemTable.size()) return _itemTable[id]; else return 0;
 }
 
 /**
@@ -842,6 +865,16 @@ Unit *Ruleset::getUnit(const std::string &name) const
 	if (_units.end() != i) return i->second; else return 0;
 }
 
+/**
+ * Returns the info about a specific unit.
+ * @param id Rule ID of the unit name.
+ * @return Rules for the units.
+ */
+Unit *Ruleset::getUnit(int id) const
+{
+	if (id >= 0 && id < (int)_unitTable.size()) return _unitTable[id]; else return 0;
+}
+
 /**
  * Returns the info about a specific alien race.
  * @param name Race name.
@@ -895,6 +928,16 @@ Armor *Ruleset::getArmor(const std::string &name) const
 	if (_armors.end() != i) return i->second; else return 0;
 }
 
+/**
+ * Returns the info about a specific armor.
+ * @param id Rule ID of the armor name.
+ * @return Rules for the armor.
+ */
+Armor *Ruleset::getArmor(int id) const
+{
+	if (id >= 0 && id < (int)_armorTable.size()) return _armorTable[id]; else return 0;
+}
+
 /**
  * Returns the list of all armors
  * provided by the ruleset.
@@ -1006,6 +1049,16 @@ RuleResearch *Ruleset::getResearch (const std::string &id) const
 	if (_research.end() != i) return i->second; else return 0;
 }
 
+/**
+ * Returns the rules for the specified research project.
+ * @param id Rule ID of the research project type.
+ * @return Rules for the research project.
+ */
+RuleResearch *Ruleset::getResearch (int id) const
+{
+	if (id >= 0 && id < (int)_researchTable.size()) return _researchTable[id]; else return 0;
+}
+
 /**
  * Returns the list of research projects.
  * @return The list of research projects.
@@ -1116,13 +1169,48 @@ private:
  */
 const City *Ruleset::locateCity(double lon, double lat) const
 {
-	for (std::map<std::string, RuleRegion*>::const_iterator rr = _regions.begin(); rr != _regions.end(); ++rr)
+	const std::vector<City*> &cities = _cityIndex.get(lon, lat);
+	std::vector<City*>::const_iterator city = std::find_if(cities.begin(), cities.end(), EqualCoordinates(lon, lat));
+	if (city != cities.end())
 	{
-		const std::vector<City*> &cities = *rr->second->getCities();
-		std::vector<City *>::const_iterator citer = std::find_if(cities.begin(), cities.end(), EqualCoordinates(lon, lat));
-		if (citer != cities.end())
+		return *city;
+	}
+	return 0;
+}
+
+/**
+ * Finds the country containing coordinates @a lon, @a lat.
+ * @param lon The longitude.
+ * @param lat The latitude.
+ * @return A pointer to the country rules, or 0 if the point isn't in any country.
+ */
+RuleCountry *Ruleset::locateCountry(double lon, double lat) const
+{
+	const std::vector<RuleCountry*> &countries = _countryIndex.get(lon, lat);
+	for (std::vector<RuleCountry*>::const_iterator i = countries.begin(); i != countries.end(); ++i)
+	{
+		if ((*i)->insideCountry(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Finds the region containing coordinates @a lon, @a lat.
+ * @param lon The longitude.
+ * @param lat The latitude.
+ * @return A pointer to the region rules, or 0 if the point isn't in any region.
+ */
+RuleRegion *Ruleset::locateRegion(double lon, double lat) const
+{
+	const std::vector<RuleRegion*> &regions = _regionIndex.get(lon, lat);
+	for (std::vector<RuleRegion*>::const_iterator i = regions.begin(); i != regions.end(); ++i)
+	{
+		if ((*i)->insideRegion(lon, lat))
 		{
-			return *citer;
+			return *i;
 		}
 	}
 	return 0;
@@ -1199,7 +1287,7 @@ template <typename T>
 struct compareRule : public std::binary_function<const std::string&, const std::string&, bool>
 {
 	Ruleset *_ruleset;
-	typedef T*(Ruleset::*RuleLookup)(const std::string &id);
+	typedef T*(Ruleset::*RuleLookup)(const std::string &id) const;
 	RuleLookup _lookup;
 
 	compareRule(Ruleset *ruleset, RuleLookup lookup) : _ruleset(ruleset), _lookup(lookup)
@@ -1314,6 +1402,130 @@ void Ruleset::sortLists()
 	std::sort(_craftWeaponsIndex.begin(), _craftWeaponsIndex.end(), compareRule<RuleCraftWeapon>(this));
 	std::sort(_armorsIndex.begin(), _armorsIndex.end(), compareRule<Armor>(this));
 	std::sort(_ufopaediaIndex.begin(), _ufopaediaIndex.end(), compareRule<ArticleDefinition>(this));
+	linkIds();
+	linkResearch();
+	linkItems();
+	indexGlobe();
+}
+
+/**
+ * Fills a table of rules indexed by the rule IDs of their names.
+ * @param rules Map of rule names to rules.
+ * @param table Table to fill, 0 wherever an ID names no rule of this kind.
+ */
+template <typename T>
+static void buildIdTable(const std::map<std::string, T*> &rules, std::vector<T*> &table)
+{
+	table.clear();
+	for (typename std::map<std::string, T*>::const_iterator i = rules.begin(); i != rules.end(); ++i)
+	{
+		size_t id = RuleIds::intern(i->first);
+		if (id >= table.size())
+		{
+			table.resize(id + 1, 0);
+		}
+		table[id] = i->second;
+	}
+}
+
+/**
+ * Hands out rule IDs for the names of the rules looked up
+ * the most, and builds the flat tables that take them,
+ * so runtime objects holding IDs skip the name lookups.
+ */
+void Ruleset::linkIds()
+{
+	buildIdTable(_crafts, _craftTable);
+	buildIdTable(_items, _itemTable);
+	buildIdTable(_units, _unitTable);
+	buildIdTable(_armors, _armorTable);
+	buildIdTable(_research, _researchTable);
+}
+
+/**
+ * Gives every research project its position in the sorted
+ * research list as an index, resolves the research names each
+ * project refers to, and records for each project which others
+ * list it as a dependency or unlock, so the saved game can track
+ * research with plain indices instead of name lookups.
+ */
+void Ruleset::linkResearch()
+{
+	std::map<std::string, int> indices;
+	for (size_t i = 0; i != _researchIndex.size(); ++i)
+	{
+		indices[_researchIndex[i]] = i;
+	}
+	for (size_t i = 0; i != _researchIndex.size(); ++i)
+	{
+		getResearch(_researchIndex[i])->link(i, indices);
+	}
+	for (size_t i = 0; i != _researchIndex.size(); ++i)
+	{
+		RuleResearch *research = getResearch(_researchIndex[i]);
+		for (std::vector<int>::const_iterator j = research->getDependencyIndices().begin(); j != research->getDependencyIndices().end(); ++j)
+		{
+			if (*j != -1)
+			{
+				getResearch(_researchIndex[*j])->addDependent(i);
+			}
+		}
+		for (std::vector<int>::const_iterator j = research->getUnlockedIndices().begin(); j != research->getUnlockedIndices().end(); ++j)
+		{
+			if (*j != -1)
+			{
+				getResearch(_researchIndex[*j])->addDependent(i);
+			}
+		}
+	}
+}
+
+/**
+ * Gives every item its rule ID and resolves its compatible
+ * ammo to rules, so loading weapons compares pointers
+ * instead of names.
+ */
+void Ruleset::linkItems()
+{
+	for (std::map<std::string, RuleItem*>::iterator i = _items.begin(); i != _items.end(); ++i)
+	{
+		i->second->link(RuleIds::find(i->first), _items);
+	}
+}
+
+/**
+ * Registers the areas of every country and region and the
+ * position of every city in a grid over the globe, so
+ * point lookups only test the rules covering that cell.
+ * Rules are inserted in list order so lookups return the
+ * same match a scan of the list would.
+ */
+void Ruleset::indexGlobe()
+{
+	_countryIndex.clear();
+	_regionIndex.clear();
+	_cityIndex.clear();
+	for (std::vector<std::string>::const_iterator i = _countriesIndex.begin(); i != _countriesIndex.end(); ++i)
+	{
+		RuleCountry *country = getCountry(*i);
+		for (size_t j = 0; j != country->getLonMin().size(); ++j)
+		{
+			_countryIndex.insert(country->getLonMin()[j], country->getLonMax()[j], country->getLatMin()[j], country->getLatMax()[j], country);
+		}
+	}
+	for (std::vector<std::string>::const_iterator i = _regionsIndex.begin(); i != _regionsIndex.end(); ++i)
+	{
+		RuleRegion *region = getRegion(*i);
+		for (size_t j = 0; j != region->getLonMin().size(); ++j)
+		{
+			_regionIndex.insert(region->getLonMin()[j], region->getLonMax()[j], region->getLatMin()[j], region->getLatMax()[j], region);
+		}
+		for (std::vector<City*>::const_iterator j = region->getCities()->begin(); j != region->getCities()->end(); ++j)
+		{
+			double lon = (*j)->getLongitude(), lat = (*j)->getLatitude();
+			_cityIndex.insert(lon - CITY_EPSILON, lon + CITY_EPSILON, lat - CITY_EPSILON, lat + CITY_EPSILON, *j);
+		}
+	}
 }
 
 /**
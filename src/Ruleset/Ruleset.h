@@ -24,6 +24,7 @@
 #include <string>
 #include <yaml-cpp/yaml.h>
 #include "../Savegame/GameTime.h"
+#include "../Geoscape/SpatialIndex.h"
 
 namespace OpenXcom
 {
@@ -59,6 +60,7 @@ class ExtraSprites;
 class ExtraSounds;
 class ExtraStrings;
 class StatString;
+class RulesetCache;
 
 /**
  * Set of rules and stats for a game.
@@ -105,20 +107,36 @@ protected:
 	std::vector<std::vector<int> > _alienItemLevels;
 	int _modIndex, _facilityListOrder, _craftListOrder, _itemListOrder, _researchListOrder,  _manufactureListOrder, _ufopaediaListOrder, _invListOrder;
 	std::vector<std::string> _psiRequirements; // it's a cache for psiStrengthEval
+	SpatialIndex<RuleCountry> _countryIndex;
+	SpatialIndex<RuleRegion> _regionIndex;
+	SpatialIndex<City> _cityIndex;
+	std::vector<RuleCraft*> _craftTable;
+	std::vector<RuleItem*> _itemTable;
+	std::vector<Unit*> _unitTable;
+	std::vector<Armor*> _armorTable;
+	std::vector<RuleResearch*> _researchTable;
 	/// Loads a ruleset from a YAML file.
-	void loadFile(const std::string &filename);
+	void loadFile(const std::string &filename, RulesetCache *cache);
 	/// Loads all ruleset files from a directory.
-	void loadFiles(const std::string &dirname);
+	void loadFiles(const std::string &dirname, RulesetCache *cache);
 	/// Loads a ruleset element.
 	template <typename T>
 	T *loadRule(const YAML::Node &node, std::map<std::string, T*> *map, std::vector<std::string> *index = 0, const std::string &key = "type");
+	/// Assigns research indices and builds the research dependency graph.
+	void linkResearch();
+	/// Builds the tables of rules by rule ID.
+	void linkIds();
+	/// Assigns item IDs and resolves compatible ammo.
+	void linkItems();
+	/// Builds the spatial indices of countries, regions and cities.
+	void indexGlobe();
 public:
 	/// Creates a blank ruleset.
 	Ruleset();
 	/// Cleans up the ruleset.
 	~Ruleset();
 	/// Loads a ruleset from the given source.
-	void load(const std::string &source);
+	void load(const std::string &source, RulesetCache *cache = 0);
 	/// Generates the starting saved game.
 	SavedGame *newSave() const;
 	/// Gets the pool list for soldier names.
@@ -137,6 +155,8 @@ public:
 	const std::vector<std::string> &getBaseFacilitiesList() const;
 	/// Gets the ruleset for a craft type.
 	RuleCraft *getCraft(const std::string &id) const;
+	/// Gets the ruleset for a craft type by rule ID.
+	RuleCraft *getCraft(int id) const;
 	/// Gets the available crafts.
 	const std::vector<std::string> &getCraftsList() const;
 	/// Gets the ruleset for a craft weapon type.
@@ -145,6 +165,8 @@ public:
 	const std::vector<std::string> &getCraftWeaponsList() const;
 	/// Gets the ruleset for an item type.
 	RuleItem *getItem(const std::string &id) const;
+	/// Gets the ruleset for an item type by rule ID.
+	RuleItem *getItem(int id) const;
 	/// Gets the available items.
 	const std::vector<std::string> &getItemsList() const;
 	/// Gets the ruleset for a UFO type.
@@ -161,6 +183,8 @@ public:
 	RuleSoldier *getSoldier(const std::string &name) const;
 	/// Gets generated unit rules.
 	Unit *getUnit(const std::string &name) const;
+	/// Gets generated unit rules by rule ID.
+	Unit *getUnit(int id) const;
 	/// Gets alien race rules.
 	AlienRace *getAlienRace(const std::string &name) const;
 	/// Gets the available alien races.
@@ -171,6 +195,8 @@ public:
 	const std::vector<std::string> &getDeploymentsList() const;
 	/// Gets armor rules.
 	Armor *getArmor(const std::string &name) const;
+	/// Gets armor rules by rule ID.
+	Armor *getArmor(int id) const;
 	/// Gets the available armors.
 	const std::vector<std::string> &getArmorsList() const;
 	/// Gets Ufopaedia article definition.
@@ -191,6 +217,8 @@ public:
 	int getPersonnelTime() const;
 	/// Gets the ruleset for a specific research project.
 	RuleResearch *getResearch (const std::string &id) const;
+	/// Gets the ruleset for a specific research project by rule ID.
+	RuleResearch *getResearch (int id) const;
 	/// Gets the list of all research projects.
 	const std::vector<std::string> &getResearchList () const;
 	/// Gets the ruleset for a specific manufacture project.
@@ -207,6 +235,10 @@ public:
 	const std::vector<std::string> &getAlienMissionList() const;
 	/// Gets the city at the specified coordinates.
 	const City *locateCity(double lon, double lat) const;
+	/// Gets the country at the specified coordinates.
+	RuleCountry *locateCountry(double lon, double lat) const;
+	/// Gets the region at the specified coordinates.
+	RuleRegion *locateRegion(double lon, double lat) const;
 	/// Gets the alien item level table.
 	const std::vector<std::vector<int> > &getAlienItemLevels() const;
 	/// Gets the Defined starting base.
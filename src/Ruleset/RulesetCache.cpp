@@ -0,0 +1,179 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "RulesetCache.h"
+#include <fstream>
+#include "../Engine/FileMap.h"
+#include "../Engine/Logger.h"
+#include "../Engine/YamlBinary.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Identifies ruleset cache files.
+const char CACHE_MAGIC[4] = {'O', 'X', 'R', 'C'};
+/// Changes whenever the binary format does.
+const uint32_t CACHE_VERSION = 1;
+
+}
+
+/**
+ * Opens the cache file and reads in all its entries.
+ * A missing, outdated or damaged file just leaves
+ * the cache empty, to be filled in again.
+ * @param path Full path to the cache file.
+ */
+RulesetCache::RulesetCache(const std::string &path) : _path(path), _changed(false)
+{
+	FileMap file(path);
+	if (!file)
+	{
+		_changed = true;
+		return;
+	}
+	std::string in;
+	if (file.getSize() > 0)
+	{
+		in.assign((const char*)file.getData(), file.getSize());
+	}
+
+	size_t pos = sizeof(CACHE_MAGIC);
+	uint64_t version, count;
+	if (in.compare(0, sizeof(CACHE_MAGIC), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+		!YamlBinary::readNumber(in, pos, version, 4) || version != CACHE_VERSION ||
+		!YamlBinary::readNumber(in, pos, count, 4))
+	{
+		Log(LOG_INFO) << "Ruleset cache is outdated, rebuilding.";
+		_changed = true;
+		return;
+	}
+
+	for (uint64_t i = 0; i < count; ++i)
+	{
+		std::string filename;
+		Entry entry;
+		uint64_t checksum;
+		if (!YamlBinary::readString(in, pos, filename) ||
+			!YamlBinary::readNumber(in, pos, entry.hash, 8) ||
+			!YamlBinary::readNumber(in, pos, checksum, 8) ||
+			!YamlBinary::readString(in, pos, entry.data) ||
+			YamlBinary::hash(entry.data.data(), entry.data.size()) != checksum)
+		{
+			Log(LOG_WARNING) << "Ruleset cache is damaged, rebuilding.";
+			_entries.clear();
+			_changed = true;
+			return;
+		}
+		entry.used = false;
+		_entries[filename] = entry;
+	}
+}
+
+/**
+ * Cleans up the ruleset cache. Nothing is written
+ * back to the file unless save() was called.
+ */
+RulesetCache::~RulesetCache()
+{
+}
+
+/**
+ * Loads a YAML ruleset file. If the cache has an entry for
+ * the same contents it's rebuilt from that, otherwise the
+ * file is parsed and the result added to the cache.
+ * @param filename Full path to the ruleset file.
+ * @return Root node of the file.
+ */
+YAML::Node RulesetCache::load(const std::string &filename)
+{
+	FileMap file(filename);
+	if (!file)
+	{
+		// let the parser report it
+		return YAML::LoadFile(filename);
+	}
+	std::string contents;
+	if (file.getSize() > 0)
+	{
+		contents.assign((const char*)file.getData(), file.getSize());
+	}
+	uint64_t contentsHash = YamlBinary::hash(contents.data(), contents.size());
+
+	std::map<std::string, Entry>::iterator i = _entries.find(filename);
+	if (i != _entries.end() && i->second.hash == contentsHash)
+	{
+		YAML::Node doc(YAML::NodeType::Null);
+		size_t pos = 0;
+		if (YamlBinary::readNode(i->second.data, pos, doc, 0) && pos == i->second.data.size())
+		{
+			i->second.used = true;
+			return doc;
+		}
+	}
+
+	YAML::Node doc = YAML::Load(contents);
+	Entry entry;
+	entry.hash = contentsHash;
+	YamlBinary::writeNode(doc, entry.data);
+	entry.used = true;
+	_entries[filename] = entry;
+	_changed = true;
+	return doc;
+}
+
+/**
+ * Writes the cache back to its file if anything changed,
+ * keeping only the entries for files loaded this time.
+ */
+void RulesetCache::save()
+{
+	std::string out(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	YamlBinary::writeNumber(out, CACHE_VERSION, 4);
+	size_t count = 0;
+	std::string entries;
+	for (std::map<std::string, Entry>::const_iterator i = _entries.begin(); i != _entries.end(); ++i)
+	{
+		if (!i->second.used)
+		{
+			_changed = true;
+			continue;
+		}
+		YamlBinary::writeString(entries, i->first);
+		YamlBinary::writeNumber(entries, i->second.hash, 8);
+		YamlBinary::writeNumber(entries, YamlBinary::hash(i->second.data.data(), i->second.data.size()), 8);
+		YamlBinary::writeString(entries, i->second.data);
+		count++;
+	}
+	if (!_changed)
+		return;
+	YamlBinary::writeNumber(out, count, 4);
+	out += entries;
+
+	std::ofstream file(_path.c_str(), std::ios::out | std::ios::binary);
+	if (!file || !file.write(out.data(), out.size()))
+	{
+		Log(LOG_WARNING) << "Failed to save " << _path;
+		return;
+	}
+	_changed = false;
+}
+
+}
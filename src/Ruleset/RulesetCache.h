@@ -0,0 +1,62 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef OPENXCOM_RULESETCACHE_H
+#define OPENXCOM_RULESETCACHE_H
+
+#include <map>
+#include <string>
+#include <stdint.h>
+#include <yaml-cpp/yaml.h>
+
+namespace OpenXcom
+{
+
+/**
+ * Cache of parsed ruleset files, stored in a compact binary
+ * form so unchanged files don't have to go through the YAML
+ * parser on every launch. Each file is keyed by a hash of its
+ * contents, so edited files are parsed again, and every entry
+ * carries a checksum so a damaged cache is just ignored.
+ */
+class RulesetCache
+{
+private:
+	struct Entry
+	{
+		uint64_t hash;
+		std::string data;
+		bool used;
+	};
+	std::string _path;
+	std::map<std::string, Entry> _entries;
+	bool _changed;
+public:
+	/// Opens a ruleset cache file.
+	RulesetCache(const std::string &path);
+	/// Cleans up the ruleset cache.
+	~RulesetCache();
+	/// Loads a ruleset file, from the cache if possible.
+	YAML::Node load(const std::string &filename);
+	/// Saves the entries used this time back to the file.
+	void save();
+};
+
+}
+
+#endif
@@ -155,15 +155,11 @@ void Base::load(const YAML::Node &node, SavedGame *save, bool newGame, bool newB
 
 	_items->load(node["items"]);
 	// Some old saves have bad items, better get rid of them to avoid further bugs
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	for (size_t i = 0; i < _items->getContents().size(); ++i)
 	{
-		if (std::find(_rule->getItemsList().begin(), _rule->getItemsList().end(), i->first) == _rule->getItemsList().end())
+		if (_rule->getItem(i) == 0)
 		{
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
+			_items->removeItem(i, _items->getItem(i));
 		}
 	}
 
@@ -1081,11 +1077,12 @@ int Base::getUsedPsiLabs() const
 int Base::getUsedContainment() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); ++i)
+	const std::vector<int> &items = _items->getContents();
+	for (size_t i = 0; i < items.size(); ++i)
 	{
-		if (_rule->getItem((i)->first)->getAlien())
+		if (items[i] != 0 && _rule->getItem(i)->getAlien())
 		{
-			total += (i)->second;
+			total += items[i];
 		}
 	}
 	for (std::vector<Transfer*>::const_iterator i = _transfers.begin(); i != _transfers.end(); ++i)
@@ -1259,10 +1256,11 @@ void Base::setupDefenses()
 	}
 
 	// add vehicles left on the base
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end(); )
+	for (size_t itemId = 0; itemId < _items->getContents().size(); ++itemId)
 	{
-		std::string itemId = (i)->first;
-		int itemQty = (i)->second;
+		int itemQty = _items->getItem(itemId);
+		if (itemQty == 0)
+			continue;
 		RuleItem *rule = _rule->getItem(itemId);
 		if (rule->isFixed())
 		{
@@ -1281,24 +1279,20 @@ void Base::setupDefenses()
 			{
 				RuleItem *ammo = _rule->getItem(rule->getCompatibleAmmo()->front());
 				int ammoPerVehicle = ammo->getClipSize();
-				int baseQty = _items->getItem(ammo->getType()) / ammoPerVehicle;
+				int baseQty = _items->getItem(ammo->getId()) / ammoPerVehicle;
 				if (!baseQty)
 				{
-					++i;
 					continue;
 				}
 				int canBeAdded = std::min(itemQty, baseQty);
 				for (int j=0; j<canBeAdded; ++j)
 				{
 					_vehicles.push_back(new Vehicle(rule, ammoPerVehicle, size));
-					_items->removeItem(ammo->getType(), ammoPerVehicle);
+					_items->removeItem(ammo->getId(), ammoPerVehicle);
 				}
 				_items->removeItem(itemId, canBeAdded);
 			}
-
-			i = _items->getContents()->begin(); // we have to start over because iterator is broken because of the removeItem
 		}
-		else ++i;
 	}
 }
 
@@ -1443,12 +1437,12 @@ void Base::destroyFacility(std::vector<BaseFacility*>::iterator facility)
 				}
 			}
 			// remove all items
-			while (!(*facility)->getCraft()->getItems()->getContents()->empty())
+			const std::vector<int> &craftItems = (*facility)->getCraft()->getItems()->getContents();
+			for (size_t i = 0; i < craftItems.size(); ++i)
 			{
-				std::map<std::string, int>::iterator i = (*facility)->getCraft()->getItems()->getContents()->begin();
-				_items->addItem(i->first, i->second);
-				(*facility)->getCraft()->getItems()->removeItem(i->first, i->second);
+				_items->addItem(i, craftItems[i]);
 			}
+			(*facility)->getCraft()->getItems()->clear();
 			for (std::vector<Craft*>::iterator i = _crafts.begin(); i != _crafts.end(); ++i)
 			{
 				if (*i == (*facility)->getCraft())
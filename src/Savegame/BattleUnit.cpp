@@ -1805,15 +1805,11 @@ bool BattleUnit::checkAmmo()
 	for (std::vector<BattleItem*>::iterator i = getInventory()->begin(); i != getInventory()->end(); ++i)
 	{
 		ammo = (*i);
-		for (std::vector<std::string>::iterator c = weapon->getRules()->getCompatibleAmmo()->begin(); c != weapon->getRules()->getCompatibleAmmo()->end(); ++c)
+		if (weapon->getRules()->isCompatibleAmmo(ammo->getRules()))
 		{
-			if ((*c) == ammo->getRules()->getType())
-			{
-				wrong = false;
-				break;
-			}
+			wrong = false;
+			break;
 		}
-		if (!wrong) break;
 	}
 
 	if (wrong) return false; // didn't find any compatible ammo in inventory
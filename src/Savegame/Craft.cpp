@@ -110,15 +110,11 @@ void Craft::load(const YAML::Node &node, const Ruleset *rule, SavedGame *save)
 	}
 
 	_items->load(node["items"]);
-	for (std::map<std::string, int>::iterator i = _items->getContents()->begin(); i != _items->getContents()->end();)
+	for (size_t i = 0; i < _items->getContents().size(); ++i)
 	{
-		if (std::find(rule->getItemsList().begin(), rule->getItemsList().end(), i->first) == rule->getItemsList().end())
+		if (rule->getItem(i) == 0)
 		{
-			_items->getContents()->erase(i++);
-		}
-		else
-		{
-			++i;
+			_items->removeItem(i, _items->getItem(i));
 		}
 	}
 	for (YAML::const_iterator i = node["vehicles"].begin(); i != node["vehicles"].end(); ++i)
@@ -842,6 +838,16 @@ bool Craft::isDestroyed() const
 	return (_damage >= _rules->getMaxDamage());
 }
 
+/**
+ * A craft sitting in its base with no destination and
+ * no takeoff pending doesn't change on a geoscape step.
+ * @return Is the craft idle?
+ */
+bool Craft::isIdle() const
+{
+	return (_status != "STR_OUT" && _dest == 0 && _speed == 0 && _takeoff == 0 && !isDestroyed());
+}
+
 /**
  * Returns the amount of space available for
  * soldiers and vehicles.
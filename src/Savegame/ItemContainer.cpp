@@ -19,6 +19,7 @@
 #include "ItemContainer.h"
 #include "../Ruleset/Ruleset.h"
 #include "../Ruleset/RuleItem.h"
+#include "../Ruleset/RuleIds.h"
 
 namespace OpenXcom
 {
@@ -43,17 +44,27 @@ ItemContainer::~ItemContainer()
  */
 void ItemContainer::load(const YAML::Node &node)
 {
-	_qty = node.as< std::map<std::string, int> >(_qty);
+	for (YAML::const_iterator i = node.begin(); i != node.end(); ++i)
+	{
+		addItem(i->first.as<std::string>(), i->second.as<int>());
+	}
 }
 
 /**
  * Saves the item container to a YAML file.
+ * Items are saved by name, rule IDs only last for the session.
  * @return YAML node.
  */
 YAML::Node ItemContainer::save() const
 {
 	YAML::Node node;
-	node = _qty;
+	for (size_t i = 0; i < _qty.size(); ++i)
+	{
+		if (_qty[i] != 0)
+		{
+			node[RuleIds::getName(i)] = _qty[i];
+		}
+	}
 	return node;
 }
 
@@ -68,9 +79,19 @@ void ItemContainer::addItem(const std::string &id, int qty)
 	{
 		return;
 	}
-	if (_qty.find(id) == _qty.end())
+	addItem(RuleIds::intern(id), qty);
+}
+
+/**
+ * Adds an item amount to the container.
+ * @param id Rule ID of the item.
+ * @param qty Item quantity.
+ */
+void ItemContainer::addItem(int id, int qty)
+{
+	if (id >= (int)_qty.size())
 	{
-		_qty[id] = 0;
+		_qty.resize(id + 1, 0);
 	}
 	_qty[id] += qty;
 }
@@ -82,7 +103,21 @@ void ItemContainer::addItem(const std::string &id, int qty)
  */
 void ItemContainer::removeItem(const std::string &id, int qty)
 {
-	if (id.empty() || _qty.find(id) == _qty.end())
+	if (id.empty())
+	{
+		return;
+	}
+	removeItem(RuleIds::find(id), qty);
+}
+
+/**
+ * Removes an item amount from the container.
+ * @param id Rule ID of the item.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeItem(int id, int qty)
+{
+	if (id < 0 || id >= (int)_qty.size())
 	{
 		return;
 	}
@@ -92,7 +127,7 @@ void ItemContainer::removeItem(const std::string &id, int qty)
 	}
 	else
 	{
-		_qty.erase(id);
+		_qty[id] = 0;
 	}
 }
 
@@ -107,16 +142,21 @@ int ItemContainer::getItem(const std::string &id) const
 	{
 		return 0;
 	}
+	return getItem(RuleIds::find(id));
+}
 
-	std::map<std::string, int>::const_iterator it = _qty.find(id);
-	if (it == _qty.end())
+/**
+ * Returns the quantity of an item in the container.
+ * @param id Rule ID of the item.
+ * @return Item quantity.
+ */
+int ItemContainer::getItem(int id) const
+{
+	if (id < 0 || id >= (int)_qty.size())
 	{
 		return 0;
 	}
-	else
-	{
-		return it->second;
-	}
+	return _qty[id];
 }
 
 /**
@@ -126,9 +166,9 @@ int ItemContainer::getItem(const std::string &id) const
 int ItemContainer::getTotalQuantity() const
 {
 	int total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (std::vector<int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
 	{
-		total += i->second;
+		total += *i;
 	}
 	return total;
 }
@@ -141,20 +181,33 @@ int ItemContainer::getTotalQuantity() const
 double ItemContainer::getTotalSize(const Ruleset *rule) const
 {
 	double total = 0;
-	for (std::map<std::string, int>::const_iterator i = _qty.begin(); i != _qty.end(); ++i)
+	for (size_t i = 0; i < _qty.size(); ++i)
 	{
-		total += rule->getItem(i->first)->getSize() * i->second;
+		if (_qty[i] != 0)
+		{
+			total += rule->getItem(i)->getSize() * _qty[i];
+		}
 	}
 	return total;
 }
 
 /**
- * Returns all the items currently contained within.
+ * Removes all the items from the container.
+ */
+void ItemContainer::clear()
+{
+	_qty.clear();
+}
+
+/**
+ * Returns all the items currently contained within,
+ * as quantities indexed by the rule ID of each item.
+ * Items the container doesn't have are 0.
  * @return List of contents.
  */
-std::map<std::string, int> *ItemContainer::getContents()
+const std::vector<int> &ItemContainer::getContents() const
 {
-	return &_qty;
+	return _qty;
 }
 
 }
@@ -20,7 +20,7 @@
 #define OPENXCOM_ITEMCONTAINER_H
 
 #include <string>
-#include <map>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace OpenXcom
@@ -32,11 +32,13 @@ class Ruleset;
  * Represents the items contained by a certain entity,
  * like base stores, craft equipment, etc.
  * Handles all necessary item management tasks.
+ * Quantities are kept in a flat table indexed by
+ * the rule ID of each item type.
  */
 class ItemContainer
 {
 private:
-	std::map<std::string, int> _qty;
+	std::vector<int> _qty;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -48,16 +50,24 @@ public:
 	YAML::Node save() const;
 	/// Adds an item to the container.
 	void addItem(const std::string &id, int qty = 1);
+	/// Adds an item to the container by rule ID.
+	void addItem(int id, int qty = 1);
 	/// Removes an item from the container.
 	void removeItem(const std::string &id, int qty = 1);
+	/// Removes an item from the container by rule ID.
+	void removeItem(int id, int qty = 1);
 	/// Gets an item in the container.
 	int getItem(const std::string &id) const;
+	/// Gets an item in the container by rule ID.
+	int getItem(int id) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
 	double getTotalSize(const Ruleset *rule) const;
+	/// Removes every item from the container.
+	void clear();
 	/// Gets all the items in the container.
-	std::map<std::string, int> *getContents();
+	const std::vector<int> &getContents() const;
 };
 
 }
@@ -67,6 +67,8 @@ SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(
 		_tileSearch[i].x = ((i%11) - 5);
 		_tileSearch[i].y = ((i/11) - 5); 
 	}
+	_rngSeed = RNG::getStream()->next();
+	_rng = RNG::Stream(_rngSeed).substream(_turn);
 }
 
 /**
@@ -74,10 +76,6 @@ SavedBattleGame::SavedBattleGame() : _battleState(0), _mapsize_x(0), _mapsize_y(
  */
 SavedBattleGame::~SavedBattleGame()
 {
-	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-	{
-		delete _tiles[i];
-	}
 	delete[] _tiles;
 
 	for (std::vector<MapDataSet*>::iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
@@ -122,6 +120,17 @@ void SavedBattleGame::load(const YAML::Node &node, Ruleset *rule, SavedGame* sav
 	_missionType = node["missionType"].as<std::string>(_missionType);
 	_globalShade = node["globalshade"].as<int>(_globalShade);
 	_turn = node["turn"].as<int>(_turn);
+	// with a new seed on load, keep the fresh one this battle was created with
+	bool keepSeed = savedGame->isIronman() || !Options::newSeedOnLoad;
+	if (keepSeed)
+	{
+		_rngSeed = node["rngSeed"].as<uint64_t>(_rngSeed);
+	}
+	_rng = RNG::Stream(_rngSeed).substream(_turn);
+	if (keepSeed && node["rng"])
+	{
+		_rng.load(node["rng"]);
+	}
 	int selectedUnit = node["selectedUnit"].as<int>();
 
 	for (YAML::const_iterator i = node["mapdatasets"].begin(); i != node["mapdatasets"].end(); ++i)
@@ -366,6 +375,8 @@ YAML::Node SavedBattleGame::save() const
 	node["missionType"] = _missionType;
 	node["globalshade"] = _globalShade;
 	node["turn"] = _turn;
+	node["rngSeed"] = _rngSeed;
+	node["rng"] = _rng.save();
 	node["selectedUnit"] = (_selectedUnit?_selectedUnit->getId():-1);
 	for (std::vector<MapDataSet*>::const_iterator i = _mapDataSets.begin(); i != _mapDataSets.end(); ++i)
 	{
@@ -441,6 +452,16 @@ Tile **SavedBattleGame::getTiles() const
 	return _tiles;
 }
 
+/**
+ * Gets the arrays holding the fields of all tiles that the whole map sweeps read,
+ * for operations that touch every tile at once.
+ * @return Pointer to the tile store.
+ */
+TileStore *SavedBattleGame::getTileStore()
+{
+	return &_tileStore;
+}
+
 /**
  * Initializes the array of tiles and creates a pathfinding object.
  * @param mapsize_x
@@ -451,10 +472,6 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 {
 	if (!_nodes.empty())
 	{
-		for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
-		{
-			delete _tiles[i];
-		}
 		delete[] _tiles;
 
 		for (std::vector<Node*>::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
@@ -469,14 +486,24 @@ void SavedBattleGame::initMap(int mapsize_x, int mapsize_y, int mapsize_z)
 	_mapsize_y = mapsize_y;
 	_mapsize_z = mapsize_z;
 	_tiles = new Tile*[_mapsize_z * _mapsize_y * _mapsize_x];
-	/* create tile objects */
+	/* the fields the map sweeps read go in one array per field, the tiles are views into those arrays */
+	_tileStore.resize(_mapsize_z * _mapsize_y * _mapsize_x);
+	_tileViews.clear();
+	_tileViews.reserve(_mapsize_z * _mapsize_y * _mapsize_x);
 	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
 	{
 		Position pos;
 		getTileCoords(i, &pos.x, &pos.y, &pos.z);
-		_tiles[i] = new Tile(pos);
+		_tileViews.push_back(Tile(pos, &_tileStore, i));
+	}
+	for (int i = 0; i < _mapsize_z * _mapsize_y * _mapsize_x; ++i)
+	{
+		_tiles[i] = &_tileViews[i];
+	}
+	if (_tileEngine)
+	{
+		_tileEngine->resetMap();
 	}
-
 }
 
 /**
@@ -777,11 +804,24 @@ int SavedBattleGame::getTurn() const
 	return _turn;
 }
 
+/**
+ * Returns the random stream the battle draws from.
+ * It restarts from the battle's seed every turn.
+ * @return Pointer to the stream.
+ */
+RNG::Stream *SavedBattleGame::getRNG()
+{
+	return &_rng;
+}
+
 /**
  * Ends the current turn and progresses to the next one.
  */
 void SavedBattleGame::endTurn()
 {
+	int turn = _turn;
+	// distance fields only hold for the turn they were built in
+	getPathfinding()->invalidateReachMaps();
 	if (_side == FACTION_PLAYER)
 	{
 		if (_selectedUnit && _selectedUnit->getOriginalFaction() == FACTION_PLAYER)
@@ -819,6 +859,12 @@ void SavedBattleGame::endTurn()
 		while (_selectedUnit && _selectedUnit->getFaction() != FACTION_PLAYER)
 			selectNextPlayerUnit();
 	}
+	// every turn draws from its own stream, so a turn plays out the same no matter how the previous ones went
+	if (_turn != turn)
+	{
+		_rng = RNG::Stream(_rngSeed).substream(_turn);
+	}
+
 	int liveSoldiers, liveAliens;
 
 	_battleState->getBattleGame()->tallyUnits(liveAliens, liveSoldiers, false);
@@ -1463,6 +1509,7 @@ bool SavedBattleGame::setUnitPosition(BattleUnit *bu, const Position &position,
 			getTile(position + Position(x,y,0))->setUnit(bu, getTile(position + Position(x,y,-1)));
 		}
 	}
+	getPathfinding()->invalidateReachMaps();
 
 	return true;
 }
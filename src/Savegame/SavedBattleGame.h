@@ -26,6 +26,8 @@
 #include <SDL.h>
 #include <yaml-cpp/yaml.h>
 #include "BattleUnit.h"
+#include "Tile.h"
+#include "../Engine/RNG.h"
 
 namespace OpenXcom
 {
@@ -54,6 +56,8 @@ private:
 	BattlescapeState *_battleState;
 	int _mapsize_x, _mapsize_y, _mapsize_z;
 	std::vector<MapDataSet*> _mapDataSets;
+	TileStore _tileStore;
+	std::vector<Tile> _tileViews;
 	Tile **_tiles;
 	BattleUnit *_selectedUnit, *_lastSelectedUnit;
 	std::vector<Node*> _nodes;
@@ -77,6 +81,8 @@ private:
 	bool _kneelReserved;
 	std::vector< std::vector<std::pair<int, int> > > _baseModules;
 	int _depth;
+	uint64_t _rngSeed;
+	RNG::Stream _rng;
 	/// Selects a soldier.
 	BattleUnit *selectPlayerUnit(int dir, bool checkReselect = false, bool setReselect = false, bool checkInventory = false);
 public:
@@ -104,6 +110,8 @@ public:
 	int getGlobalShade() const;
 	/// Gets a pointer to the tiles, a tile is the smallest component of battlescape.
 	Tile **getTiles() const;
+	/// Gets the per-field arrays behind the tiles.
+	TileStore *getTileStore();
 	/// Gets a pointer to the list of nodes.
 	std::vector<Node*> *getNodes();
 	/// Gets a pointer to the list of items.
@@ -167,6 +175,8 @@ public:
 	UnitFaction getSide() const;
 	/// Gets the turn number.
 	int getTurn() const;
+	/// Gets the random stream of the battle.
+	RNG::Stream *getRNG();
 	/// Ends the turn.
 	void endTurn();
 	/// Sets debug mode.
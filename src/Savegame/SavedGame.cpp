@@ -30,6 +30,7 @@
 #include "../Engine/Exception.h"
 #include "../Engine/Options.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/YamlBinary.h"
 #include "SavedBattleGame.h"
 #include "GameTime.h"
 #include "Country.h"
@@ -50,6 +51,7 @@
 #include "AlienStrategy.h"
 #include "AlienMission.h"
 #include "../Ruleset/RuleRegion.h"
+#include "../Ruleset/RuleCountry.h"
 
 namespace OpenXcom
 {
@@ -58,6 +60,248 @@ const std::string SavedGame::AUTOSAVE_GEOSCAPE = "_autogeo_.asav",
    				  SavedGame::AUTOSAVE_BATTLESCAPE = "_autobattle_.asav",
 				  SavedGame::QUICKSAVE = "_quick_.asav";
 
+namespace
+{
+
+/// Identifies binary save files.
+const char SAVE_MAGIC[4] = {'O', 'X', 'S', 'V'};
+/// Changes whenever the binary save format does.
+const uint32_t SAVE_VERSION = 1;
+
+/**
+ * Writes a save file one section at a time, either as the
+ * usual YAML documents or in the binary save format.
+ * Binary saves are a header followed by a checksummed,
+ * length-prefixed section per subsystem, each written out
+ * as soon as it's ready, so only one section's nodes are
+ * held at a time. Sections are whole subsystems though:
+ * all the bases, or the whole battlescape, are one each.
+ */
+class SaveWriter
+{
+private:
+	std::ostream &_file;
+	bool _binary;
+	YAML::Emitter _yaml;
+public:
+	/// Starts a save file with the brief game info.
+	SaveWriter(std::ostream &file, const YAML::Node &brief, bool binary) : _file(file), _binary(binary)
+	{
+		if (_binary)
+		{
+			std::string header(SAVE_MAGIC, sizeof(SAVE_MAGIC));
+			YamlBinary::writeNumber(header, SAVE_VERSION, 4);
+			_file.write(header.data(), header.size());
+			write("brief", brief);
+		}
+		else
+		{
+			_yaml << brief;
+			_yaml << YAML::BeginDoc << YAML::BeginMap;
+		}
+	}
+	/// Writes a section of the full game data.
+	void write(const std::string &key, const YAML::Node &node)
+	{
+		if (node.IsNull())
+			return;
+		if (_binary)
+		{
+			std::string data, header;
+			YamlBinary::writeNode(node, data);
+			YamlBinary::writeString(header, key);
+			YamlBinary::writeNumber(header, YamlBinary::hash(data.data(), data.size()), 8);
+			YamlBinary::writeNumber(header, data.size(), 4);
+			_file.write(header.data(), header.size());
+			_file.write(data.data(), data.size());
+		}
+		else
+		{
+			_yaml << YAML::Key << key << YAML::Value << node;
+		}
+	}
+	/// Writes a single value of the full game data.
+	template <typename T>
+	void write(const std::string &key, const T &value)
+	{
+		write(key, YAML::Node(value));
+	}
+	/// Finishes the save file.
+	bool finish()
+	{
+		if (!_binary)
+		{
+			_yaml << YAML::EndMap;
+			_file << _yaml.c_str();
+		}
+		_file.flush();
+		return _file.good();
+	}
+};
+
+/**
+ * Reads a fixed amount of bytes from a save file. Sizes
+ * come from the file itself, so they're checked against
+ * what's left of it before anything is allocated.
+ * @param file Save file.
+ * @param size Amount of bytes.
+ * @param left Bytes left in the file, updated with the bytes read.
+ * @param data Returns the bytes read.
+ * @return False if the file ends first.
+ */
+bool readBytes(std::istream &file, uint64_t size, uint64_t &left, std::string &data)
+{
+	if (size > left)
+	{
+		return false;
+	}
+	left -= size;
+	data.resize((size_t)size);
+	return size == 0 || file.read(&data[0], size);
+}
+
+/**
+ * Reads the next section of a binary save file.
+ * @param file Save file.
+ * @param filename Save filename, for errors.
+ * @param left Bytes left in the file, updated with the bytes read.
+ * @param name Returns the section name.
+ * @param data Returns the section contents.
+ * @return False if there are no more sections.
+ */
+bool readSection(std::istream &file, const std::string &filename, uint64_t &left, std::string &name, std::string &data)
+{
+	if (left == 0)
+	{
+		return false;
+	}
+	std::string buf;
+	size_t pos = 0;
+	uint64_t size, checksum;
+	if (!readBytes(file, 4, left, buf) ||
+		!YamlBinary::readNumber(buf, pos, size, 4) ||
+		!readBytes(file, size, left, name))
+	{
+		throw Exception(filename + " is damaged");
+	}
+	pos = 0;
+	if (!readBytes(file, 12, left, buf) ||
+		!YamlBinary::readNumber(buf, pos, checksum, 8) ||
+		!YamlBinary::readNumber(buf, pos, size, 4) ||
+		!readBytes(file, size, left, data) ||
+		YamlBinary::hash(data.data(), data.size()) != checksum)
+	{
+		throw Exception(filename + " is damaged");
+	}
+	return true;
+}
+
+/**
+ * Reads the documents of a save file, in either format.
+ * Binary sections are decoded one at a time into the
+ * matching keys of the full game data. This doesn't stream
+ * the load: the whole document is built here before
+ * SavedGame::load() goes through it, same as with YAML,
+ * the binary format only makes decoding it cheaper.
+ * @param filename Full path to the save file.
+ * @param brief Returns the brief game info.
+ * @param doc Returns the full game data, or 0 to only read the brief info.
+ */
+void readSaveFile(const std::string &filename, YAML::Node &brief, YAML::Node *doc)
+{
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	std::string header;
+	size_t pos = sizeof(SAVE_MAGIC);
+	uint64_t version, left = 0;
+	if (file)
+	{
+		file.seekg(0, std::ios::end);
+		std::streamoff length = file.tellg();
+		file.seekg(0, std::ios::beg);
+		left = length > 0 ? (uint64_t)length : 0;
+	}
+	if (!file || !readBytes(file, sizeof(SAVE_MAGIC) + 4, left, header) ||
+		header.compare(0, sizeof(SAVE_MAGIC), SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0)
+	{
+		file.close();
+		if (doc == 0)
+		{
+			brief = YAML::LoadFile(filename);
+			return;
+		}
+		std::vector<YAML::Node> docs = YAML::LoadAllFromFile(filename);
+		if (docs.size() < 2)
+		{
+			throw Exception(filename + " is not a vaild save file");
+		}
+		brief = docs[0];
+		*doc = docs[1];
+		return;
+	}
+	YamlBinary::readNumber(header, pos, version, 4);
+	if (version > SAVE_VERSION)
+	{
+		throw Exception(filename + " was saved by a newer version");
+	}
+
+	std::string name, data;
+	if (!readSection(file, filename, left, name, data) || name != "brief")
+	{
+		throw Exception(filename + " is not a vaild save file");
+	}
+	pos = 0;
+	YAML::Node node(YAML::NodeType::Null);
+	if (!YamlBinary::readNode(data, pos, node) || pos != data.size())
+	{
+		throw Exception(filename + " is damaged");
+	}
+	brief = node;
+	if (doc == 0)
+		return;
+	*doc = YAML::Node(YAML::NodeType::Map);
+	while (readSection(file, filename, left, name, data))
+	{
+		pos = 0;
+		if (!YamlBinary::readNode(data, pos, (*doc)[name]) || pos != data.size())
+		{
+			throw Exception(filename + " is damaged");
+		}
+	}
+}
+
+/**
+ * Saves every object in a list.
+ * @param list List of objects.
+ * @return YAML node with each object.
+ */
+template <typename T>
+YAML::Node saveList(const std::vector<T*> &list)
+{
+	YAML::Node node;
+	for (typename std::vector<T*>::const_iterator i = list.begin(); i != list.end(); ++i)
+	{
+		node.push_back((*i)->save());
+	}
+	return node;
+}
+
+/**
+ * Saves the names of a list of research topics.
+ * @param list List of research rules.
+ * @return YAML node with each name.
+ */
+YAML::Node saveNames(const std::vector<const RuleResearch*> &list)
+{
+	YAML::Node node;
+	for (std::vector<const RuleResearch*>::const_iterator i = list.begin(); i != list.end(); ++i)
+	{
+		node.push_back((*i)->getName());
+	}
+	return node;
+}
+
+}
+
 struct findRuleResearch : public std::unary_function<ResearchProject *,
 								bool>
 {
@@ -99,6 +343,7 @@ SavedGame::SavedGame() : _difficulty(DIFF_BEGINNER), _ironman(false), _globeLon(
 {
 	_time = new GameTime(6, 1, 1, 1999, 12, 0, 0);
 	_alienStrategy = new AlienStrategy();
+	_rng = RNG::split();
 	_funds.push_back(0);
 	_maintenance.push_back(0);
 	_researchScores.push_back(0);
@@ -214,7 +459,8 @@ std::vector<SaveInfo> SavedGame::getList(Language *lang, bool autoquick)
 SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 {
 	std::string fullname = Options::getUserFolder() + file;
-	YAML::Node doc = YAML::LoadFile(fullname);
+	YAML::Node doc;
+	readSaveFile(fullname, doc, 0);
 	SaveInfo save;
 
 	save.fileName = file;
@@ -281,22 +527,18 @@ SaveInfo SavedGame::getSaveInfo(const std::string &file, Language *lang)
 }
 
 /**
- * Loads a saved game's contents from a YAML file.
+ * Loads a saved game's contents from a YAML or binary file.
  * @note Assumes the saved game is blank.
- * @param filename YAML filename.
+ * @param filename Save filename.
  * @param rule Ruleset for the saved game.
  */
 void SavedGame::load(const std::string &filename, Ruleset *rule)
 {
 	std::string s = Options::getUserFolder() + filename;
-	std::vector<YAML::Node> file = YAML::LoadAllFromFile(s);
-	if (file.empty())
-	{
-		throw Exception(filename + " is not a vaild save file");
-	}
+	YAML::Node brief, doc;
+	readSaveFile(s, brief, &doc);
 
 	// Get brief save info
-	YAML::Node brief = file[0];
 	/*
 	std::string version = brief["version"].as<std::string>();
 	if (version != OPENXCOM_VERSION_SHORT)
@@ -316,10 +558,9 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 	_ironman = brief["ironman"].as<bool>(_ironman);
 
 	// Get full save data
-	YAML::Node doc = file[1];
 	_difficulty = (GameDifficulty)doc["difficulty"].as<int>(_difficulty);
 	if (doc["rng"] && (_ironman || !Options::newSeedOnLoad))
-		RNG::setSeed(doc["rng"].as<uint64_t>());
+		_rng.load(doc["rng"]);
 	_monthsPassed = doc["monthsPassed"].as<int>(_monthsPassed);
 	_graphRegionToggles = doc["graphRegionToggles"].as<std::string>(_graphRegionToggles);
 	_graphCountryToggles = doc["graphCountryToggles"].as<std::string>(_graphCountryToggles);
@@ -413,7 +654,7 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 		std::string research = it->as<std::string>();
 		if (rule->getResearch(research))
 		{
-			_discovered.push_back(rule->getResearch(research));
+			markResearched(rule->getResearch(research));
 		}
 	}
 	
@@ -443,20 +684,19 @@ void SavedGame::load(const std::string &filename, Ruleset *rule)
 }
 
 /**
- * Saves a saved game's contents to a YAML file.
- * @param filename YAML filename.
+ * Saves a saved game's contents to a file, in the binary
+ * format unless YAML saves are preferred.
+ * @param filename Save filename.
  */
 void SavedGame::save(const std::string &filename) const
 {
 	std::string s = Options::getUserFolder() + filename;
-	std::ofstream sav(s.c_str());
+	std::ofstream sav(s.c_str(), Options::binarySaves ? std::ios::out | std::ios::binary : std::ios::out);
 	if (!sav)
 	{
 		throw Exception("Failed to save " + filename);
 	}
 
-	YAML::Emitter out;
-
 	// Saves the brief game info used in the saves list
 	YAML::Node brief;
 	brief["name"] = Language::wstrToUtf8(_name);
@@ -471,80 +711,52 @@ void SavedGame::save(const std::string &filename) const
 	brief["rulesets"] = Options::rulesets;
 	if (_ironman)
 		brief["ironman"] = _ironman;
-	out << brief;
+	SaveWriter out(sav, brief, Options::binarySaves);
 	// Saves the full game data to the save
-	out << YAML::BeginDoc;
-	YAML::Node node;
-	node["difficulty"] = (int)_difficulty;
-	node["monthsPassed"] = _monthsPassed;
-	node["graphRegionToggles"] = _graphRegionToggles;
-	node["graphCountryToggles"] = _graphCountryToggles;
-	node["graphFinanceToggles"] = _graphFinanceToggles;
-	node["rng"] = RNG::getSeed();
-	node["funds"] = _funds;
-	node["maintenance"] = _maintenance;
-	node["researchScores"] = _researchScores;
-	node["incomes"] = _incomes;
-	node["expenditures"] = _expenditures;
-	node["warned"] = _warned;
-	node["globeLon"] = _globeLon;
-	node["globeLat"] = _globeLat;
-	node["globeZoom"] = _globeZoom;
-	node["ids"] = _ids;
-	for (std::vector<Country*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
-	{
-		node["countries"].push_back((*i)->save());
-	}
-	for (std::vector<Region*>::const_iterator i = _regions.begin(); i != _regions.end(); ++i)
-	{
-		node["regions"].push_back((*i)->save());
-	}
-	for (std::vector<Base*>::const_iterator i = _bases.begin(); i != _bases.end(); ++i)
-	{
-		node["bases"].push_back((*i)->save());
-	}
-	for (std::vector<Waypoint*>::const_iterator i = _waypoints.begin(); i != _waypoints.end(); ++i)
-	{
-		node["waypoints"].push_back((*i)->save());
-	}
-	for (std::vector<TerrorSite*>::const_iterator i = _terrorSites.begin(); i != _terrorSites.end(); ++i)
-	{
-		node["terrorSites"].push_back((*i)->save());
-	}
+	out.write("difficulty", (int)_difficulty);
+	out.write("monthsPassed", _monthsPassed);
+	out.write("graphRegionToggles", _graphRegionToggles);
+	out.write("graphCountryToggles", _graphCountryToggles);
+	out.write("graphFinanceToggles", _graphFinanceToggles);
+	out.write("rng", _rng.save());
+	out.write("funds", _funds);
+	out.write("maintenance", _maintenance);
+	out.write("researchScores", _researchScores);
+	out.write("incomes", _incomes);
+	out.write("expenditures", _expenditures);
+	out.write("warned", _warned);
+	out.write("globeLon", _globeLon);
+	out.write("globeLat", _globeLat);
+	out.write("globeZoom", _globeZoom);
+	out.write("ids", _ids);
+	out.write("countries", saveList(_countries));
+	out.write("regions", saveList(_regions));
+	out.write("bases", saveList(_bases));
+	out.write("waypoints", saveList(_waypoints));
+	out.write("terrorSites", saveList(_terrorSites));
 	// Alien bases must be saved before alien missions.
-	for (std::vector<AlienBase*>::const_iterator i = _alienBases.begin(); i != _alienBases.end(); ++i)
-	{
-		node["alienBases"].push_back((*i)->save());
-	}
+	out.write("alienBases", saveList(_alienBases));
 	// Missions must be saved before UFOs, but after alien bases.
-	for (std::vector<AlienMission *>::const_iterator i = _activeMissions.begin(); i != _activeMissions.end(); ++i)
-	{
-		node["alienMissions"].push_back((*i)->save());
-	}
+	out.write("alienMissions", saveList(_activeMissions));
 	// UFOs must be after missions
+	YAML::Node ufos;
 	for (std::vector<Ufo*>::const_iterator i = _ufos.begin(); i != _ufos.end(); ++i)
 	{
-		node["ufos"].push_back((*i)->save(getMonthsPassed() == -1));
-	}
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
-	{
-		node["discovered"].push_back((*i)->getName());
+		ufos.push_back((*i)->save(getMonthsPassed() == -1));
 	}
-	for (std::vector<const RuleResearch *>::const_iterator i = _poppedResearch.begin(); i != _poppedResearch.end(); ++i)
-	{
-		node["poppedResearch"].push_back((*i)->getName());
-	}
-	node["alienStrategy"] = _alienStrategy->save();
-	for (std::vector<Soldier*>::const_iterator i = _deadSoldiers.begin(); i != _deadSoldiers.end(); ++i)
+	out.write("ufos", ufos);
+	out.write("discovered", saveNames(_discovered));
+	out.write("poppedResearch", saveNames(_poppedResearch));
+	out.write("alienStrategy", _alienStrategy->save());
+	out.write("deadSoldiers", saveList(_deadSoldiers));
+	if (_battleGame != 0)
 	{
-		node["deadSoldiers"].push_back((*i)->save());
+		out.write("battleGame", _battleGame->save());
 	}
-	if (_battleGame != 0)
+	if (!out.finish())
 	{
-		node["battleGame"] = _battleGame->save();
+		throw Exception("Failed to save " + filename);
 	}
-	out << node;
-	sav << out.c_str();
 	sav.close();
 }
 
@@ -889,8 +1101,24 @@ SavedBattleGame *SavedGame::getSavedBattle()
  */
 void SavedGame::setBattleGame(SavedBattleGame *battleGame)
 {
+	// keep drawing from whichever stream is in play, if this game is the one in play
+	bool active = RNG::getStream() == getRNG();
 	delete _battleGame;
 	_battleGame = battleGame;
+	if (active)
+	{
+		RNG::setStream(getRNG());
+	}
+}
+
+/**
+ * Returns the random stream the game should be drawing from:
+ * the battle's while one is in progress, the geoscape's otherwise.
+ * @return Pointer to the stream.
+ */
+RNG::Stream *SavedGame::getRNG()
+{
+	return _battleGame ? _battleGame->getRNG() : &_rng;
 }
 
 /**
@@ -900,10 +1128,9 @@ void SavedGame::setBattleGame(SavedBattleGame *battleGame)
  */
 void SavedGame::addFinishedResearch (const RuleResearch * r, const Ruleset * ruleset)
 {
-	std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(_discovered.begin (), _discovered.end (), r);
-	if(itDiscovered == _discovered.end())
+	if(!isDiscovered(r))
 	{
-		_discovered.push_back(r);
+		markResearched(r);
 		removePoppedResearch(r);
 		addResearchScore(r->getPoints());
 	}
@@ -936,6 +1163,48 @@ void SavedGame::addFinishedResearch (const RuleResearch * r, const Ruleset * rul
 	}
 }
 
+/**
+ * Adds a research to the discovered list and to the
+ * index and name lookups kept alongside it.
+ * @param r The discovered research.
+ */
+void SavedGame::markResearched (const RuleResearch * r)
+{
+	_discovered.push_back(r);
+	int index = r->getIndex();
+	if (index >= 0)
+	{
+		if ((size_t)index >= _researched.size())
+		{
+			_researched.resize(index + 1, false);
+		}
+		_researched[index] = true;
+	}
+	_researchedNames.insert(r->getName());
+}
+
+/**
+ * Checks if the research with a given ruleset index has been discovered.
+ * Unlike isResearched(), this ignores debug mode.
+ * @param index Research index (-1 for unknown research).
+ * @return Whether it's been discovered.
+ */
+bool SavedGame::isDiscovered (int index) const
+{
+	return index >= 0 && (size_t)index < _researched.size() && _researched[index];
+}
+
+/**
+ * Checks if a research has been discovered.
+ * Unlike isResearched(), this ignores debug mode.
+ * @param r The research to check, can be null.
+ * @return Whether it's been discovered.
+ */
+bool SavedGame::isDiscovered (const RuleResearch * r) const
+{
+	return r != 0 && isDiscovered(r->getIndex());
+}
+
 /**
  *  Returns the list of already discovered ResearchProject
  * @return the list of already discovered ResearchProject
@@ -953,15 +1222,17 @@ const std::vector<const RuleResearch *> & SavedGame::getDiscoveredResearch() con
  */
 void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & projects, const Ruleset * ruleset, Base * base) const
 {
-	const std::vector<const RuleResearch *> & discovered(getDiscoveredResearch());
-	std::vector<std::string> researchProjects = ruleset->getResearchList();
+	const std::vector<std::string> & researchProjects = ruleset->getResearchList();
 	const std::vector<ResearchProject *> & baseResearchProjects = base->getResearch();
-	std::vector<const RuleResearch *> unlocked;
-	for(std::vector<const RuleResearch *>::const_iterator it = discovered.begin (); it != discovered.end (); ++it)
+	std::vector<bool> unlocked(researchProjects.size(), false);
+	for(std::vector<const RuleResearch *>::const_iterator it = _discovered.begin (); it != _discovered.end (); ++it)
 	{
-		for(std::vector<std::string>::const_iterator itUnlocked = (*it)->getUnlocked ().begin (); itUnlocked != (*it)->getUnlocked ().end (); ++itUnlocked)
+		for(std::vector<int>::const_iterator itUnlocked = (*it)->getUnlockedIndices ().begin (); itUnlocked != (*it)->getUnlockedIndices ().end (); ++itUnlocked)
 		{
-			unlocked.push_back(ruleset->getResearch(*itUnlocked));
+			if (*itUnlocked != -1)
+			{
+				unlocked[*itUnlocked] = true;
+			}
 		}
 	}
 	for(std::vector<std::string>::const_iterator iter = researchProjects.begin (); iter != researchProjects.end (); ++iter)
@@ -971,23 +1242,17 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 		{
 			continue;
 		}
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		
 		bool liveAlien = ruleset->getUnit(research->getName()) != 0;
 
-		if (itDiscovered != discovered.end ())
+		if (isDiscovered(research))
 		{
 			bool cull = true;
-			if (research->getGetOneFree().size() != 0)
+			for (std::vector<int>::const_iterator ohBoy = research->getGetOneFreeIndices().begin(); ohBoy != research->getGetOneFreeIndices().end(); ++ohBoy)
 			{
-				for (std::vector<std::string>::const_iterator ohBoy = research->getGetOneFree().begin(); ohBoy != research->getGetOneFree().end(); ++ohBoy)
+				if (!isDiscovered(*ohBoy))
 				{
-					std::vector<const RuleResearch *>::const_iterator more_iteration = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(*ohBoy));
-					if (more_iteration == discovered.end ())
-					{
-						cull = false;
-						break;
-					}
+					cull = false;
+					break;
 				}
 			}
 			if (!liveAlien && cull)
@@ -1002,19 +1267,11 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 				bool leader ( leaderCheck != research->getUnlocked().end());
 				bool cmnder ( cmnderCheck != research->getUnlocked().end());
 
-				if (leader)
-				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-					if (found == discovered.end())
-						cull = false;
-				}
+				if (leader && !isDiscovered(ruleset->getResearch("STR_LEADER_PLUS")))
+					cull = false;
 
-				if (cmnder)
-				{
-					std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_COMMANDER_PLUS"));
-					if (found == discovered.end())
-						cull = false;
-				}
+				if (cmnder && !isDiscovered(ruleset->getResearch("STR_COMMANDER_PLUS")))
+					cull = false;
 
 				if (cull)
 					continue;
@@ -1029,24 +1286,41 @@ void SavedGame::getAvailableResearchProjects (std::vector<RuleResearch *> & proj
 		{
 			continue;
 		}
-		if (research->getRequirements().size() != 0)
+		bool requirements = true;
+		for (std::vector<int>::const_iterator itreq = research->getRequirementIndices().begin(); itreq != research->getRequirementIndices().end(); ++itreq)
 		{
-			size_t tally(0);
-			for(size_t itreq = 0; itreq != research->getRequirements().size(); ++itreq)
+			if (!isDiscovered(*itreq))
 			{
-				itDiscovered = std::find(discovered.begin (), discovered.end (), ruleset->getResearch(research->getRequirements().at(itreq)));
-				if (itDiscovered != discovered.end ())
-				{
-					tally++;
-				}
+				requirements = false;
+				break;
 			}
-			if(tally != research->getRequirements().size())
+		}
+		if (!requirements)
+		{
 			continue;
 		}
 		projects.push_back (research);
 	}
 }
 
+/**
+ * Get the RuleResearch which can be researched in a Base,
+ * indexed by their position in the ruleset's research list.
+ * @param possible the list to fill, with null for projects which aren't available.
+ * @param ruleset the game Ruleset
+ * @param base a pointer to a Base
+ */
+void SavedGame::getPossibleResearch (std::vector<RuleResearch *> & possible, const Ruleset * ruleset, Base * base) const
+{
+	std::vector<RuleResearch *> projects;
+	getAvailableResearchProjects(projects, ruleset, base);
+	possible.assign(ruleset->getResearchList().size(), 0);
+	for (std::vector<RuleResearch *>::const_iterator i = projects.begin(); i != projects.end(); ++i)
+	{
+		possible[(*i)->getIndex()] = *i;
+	}
+}
+
 /**
  * Get the list of RuleManufacture which can be manufacture in a Base.
  * @param productions the list of Productions which are available.
@@ -1083,15 +1357,33 @@ void SavedGame::getAvailableProductions (std::vector<RuleManufacture *> & produc
  * @return true if the RuleResearch can be researched
  */
 bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const RuleResearch *> & unlocked, const Ruleset * ruleset) const
+{
+	std::vector<bool> unlockedIndices(ruleset->getResearchList().size(), false);
+	for (std::vector<const RuleResearch *>::const_iterator i = unlocked.begin(); i != unlocked.end(); ++i)
+	{
+		if (*i != 0 && (*i)->getIndex() != -1)
+		{
+			unlockedIndices[(*i)->getIndex()] = true;
+		}
+	}
+	return isResearchAvailable(r, unlockedIndices, ruleset);
+}
+
+/**
+ * Check whether a ResearchProject can be researched.
+ * @param r the RuleResearch to test.
+ * @param unlocked which RuleResearch are currently unlocked, by research index
+ * @param ruleset the current Ruleset
+ * @return true if the RuleResearch can be researched
+ */
+bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<bool> & unlocked, const Ruleset * ruleset) const
 {
 	if (r == 0)
 	{
 		return false;
 	}
-	std::vector<std::string> deps = r->getDependencies();
-	const std::vector<const RuleResearch *> & discovered(getDiscoveredResearch());
 	bool liveAlien = ruleset->getUnit(r->getName()) != 0;
-	if(_debug || std::find(unlocked.begin (), unlocked.end (), r) != unlocked.end ())
+	if(_debug || (r->getIndex() != -1 && unlocked[r->getIndex()]))
 	{
 		return true;
 	}
@@ -1105,34 +1397,24 @@ bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const R
 			bool leader ( leaderCheck != r->getUnlocked().end());
 			bool cmnder ( cmnderCheck != r->getUnlocked().end());
 
-			if (leader)
-			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_LEADER_PLUS"));
-				if (found == discovered.end())
-					return true;
-			}
+			if (leader && !isDiscovered(ruleset->getResearch("STR_LEADER_PLUS")))
+				return true;
 
-			if (cmnder)
-			{
-				std::vector<const RuleResearch*>::const_iterator found = std::find(discovered.begin(), discovered.end(), ruleset->getResearch("STR_COMMANDER_PLUS"));
-				if (found == discovered.end())
-					return true;
-			}
+			if (cmnder && !isDiscovered(ruleset->getResearch("STR_COMMANDER_PLUS")))
+				return true;
 		}
 	}
-	for (std::vector<std::string>::const_iterator itFree = r->getGetOneFree().begin(); itFree != r->getGetOneFree().end(); ++itFree)
+	for (std::vector<int>::const_iterator itFree = r->getGetOneFreeIndices().begin(); itFree != r->getGetOneFreeIndices().end(); ++itFree)
 	{
-		if(std::find(unlocked.begin (), unlocked.end (), ruleset->getResearch(*itFree)) == unlocked.end ())
+		if (*itFree == -1 || !unlocked[*itFree])
 		{
 			return true;
 		}
 	}
 
-	for(std::vector<std::string>::const_iterator iter = deps.begin (); iter != deps.end (); ++ iter)
+	for(std::vector<int>::const_iterator iter = r->getDependencyIndices().begin (); iter != r->getDependencyIndices().end (); ++ iter)
 	{
-		RuleResearch *research = ruleset->getResearch(*iter);
-		std::vector<const RuleResearch *>::const_iterator itDiscovered = std::find(discovered.begin (), discovered.end (), research);
-		if (itDiscovered == discovered.end ())
+		if (!isDiscovered(*iter))
 		{
 			return false;
 		}
@@ -1150,14 +1432,16 @@ bool SavedGame::isResearchAvailable (RuleResearch * r, const std::vector<const R
  */
 void SavedGame::getDependableResearch (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const
 {
-	getDependableResearchBasic(dependables, research, ruleset, base);
+	std::vector<RuleResearch *> possible;
+	getPossibleResearch(possible, ruleset, base);
+	getDependableResearchBasic(dependables, research, possible);
 	for(std::vector<const RuleResearch *>::const_iterator iter = _discovered.begin (); iter != _discovered.end (); ++iter)
 	{
 		if((*iter)->getCost() == 0)
 		{
-			if (std::find((*iter)->getDependencies().begin (), (*iter)->getDependencies().end (), research->getName()) != (*iter)->getDependencies().end ())
+			if (std::find((*iter)->getDependencyIndices().begin (), (*iter)->getDependencyIndices().end (), research->getIndex()) != (*iter)->getDependencyIndices().end ())
 			{
-				getDependableResearchBasic(dependables, *iter, ruleset, base);
+				getDependableResearchBasic(dependables, *iter, possible);
 			}
 		}
 	}
@@ -1172,17 +1456,29 @@ void SavedGame::getDependableResearch (std::vector<RuleResearch *> & dependables
  */
 void SavedGame::getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const
 {
-	std::vector<RuleResearch *> possibleProjects;
-	getAvailableResearchProjects(possibleProjects, ruleset, base);
-	for(std::vector<RuleResearch *>::iterator iter = possibleProjects.begin (); iter != possibleProjects.end (); ++iter)
+	std::vector<RuleResearch *> possible;
+	getPossibleResearch(possible, ruleset, base);
+	getDependableResearchBasic(dependables, research, possible);
+}
+
+/**
+ * Get the list of newly available research projects once a ResearchProject has been completed,
+ * walking the ruleset's dependency graph down through any fake ResearchProject.
+ * @param dependables the list of RuleResearch which are now available.
+ * @param research The RuleResearch which has just been discovered
+ * @param possible the RuleResearch which can be researched, by research index
+ */
+void SavedGame::getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const std::vector<RuleResearch *> & possible) const
+{
+	for(std::vector<int>::const_iterator iter = research->getDependents().begin (); iter != research->getDependents().end (); ++iter)
 	{
-		if (std::find((*iter)->getDependencies().begin (), (*iter)->getDependencies().end (), research->getName()) != (*iter)->getDependencies().end ()
-			|| std::find((*iter)->getUnlocked().begin (), (*iter)->getUnlocked().end (), research->getName()) != (*iter)->getUnlocked().end ())
+		RuleResearch *dependable = possible[*iter];
+		if (dependable != 0)
 		{
-			dependables.push_back(*iter);
-			if ((*iter)->getCost() == 0)
+			dependables.push_back(dependable);
+			if (dependable->getCost() == 0)
 			{
-				getDependableResearchBasic(dependables, *iter, ruleset, base);
+				getDependableResearchBasic(dependables, dependable, possible);
 			}
 		}
 	}
@@ -1202,7 +1498,7 @@ void SavedGame::getDependableManufacture (std::vector<RuleManufacture *> & depen
 	{
 		RuleManufacture *m = ruleset->getManufacture(*iter);
 		const std::vector<std::string> &reqs = m->getRequirements();
-		if(isResearched(m->getRequirements()) && std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end())
+		if(std::find(reqs.begin(), reqs.end(), research->getName()) != reqs.end() && isResearched(reqs))
 		{
 			dependables.push_back(m);
 		}
@@ -1218,13 +1514,7 @@ bool SavedGame::isResearched(const std::string &research) const
 {
 	if (research.empty() || _debug)
 		return true;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
-	{
-		if ((*i)->getName() == research)
-			return true;
-	}
-
-	return false;
+	return _researchedNames.find(research) != _researchedNames.end();
 }
 
 /**
@@ -1236,22 +1526,12 @@ bool SavedGame::isResearched(const std::vector<std::string> &research) const
 {
 	if (research.empty() || _debug)
 		return true;
-	std::vector<std::string> matches = research;
-	for (std::vector<const RuleResearch *>::const_iterator i = _discovered.begin(); i != _discovered.end(); ++i)
+	for (std::vector<std::string>::const_iterator i = research.begin(); i != research.end(); ++i)
 	{
-		for (std::vector<std::string>::iterator j = matches.begin(); j != matches.end(); ++j)
-		{
-			if ((*i)->getName() == *j)
-			{
-				j = matches.erase(j);
-				break;
-			}
-		}
-		if (matches.empty())
-			return true;
+		if (_researchedNames.find(*i) == _researchedNames.end())
+			return false;
 	}
-
-	return false;
+	return true;
 }
 
 /**
@@ -1519,32 +1799,34 @@ void SavedGame::setWarned(bool warned)
 	_warned = warned;
 }
 
-/** @brief Check if a point is contained in a region.
- * This function object checks if a point is contained inside a region.
- */
-class ContainsPoint: public std::unary_function<const Region *, bool>
-{
-public:
-	/// Remember the coordinates.
-	ContainsPoint(double lon, double lat) : _lon(lon), _lat(lat) { /* Empty by design. */ }
-	/// Check is the region contains the stored point.
-	bool operator()(const Region *region) const { return region->getRules()->insideRegion(_lon, _lat); }
-private:
-	double _lon, _lat;
-};
-
 /**
  * Find the region containing this location.
+ * If the ruleset's globe index doesn't lead to one of
+ * the game's regions, every region is checked instead.
  * @param lon The longtitude.
  * @param lat The latitude.
+ * @param ruleset The ruleset, used to look up the region's area.
  * @return Pointer to the region, or 0.
  */
-Region *SavedGame::locateRegion(double lon, double lat) const
+Region *SavedGame::locateRegion(double lon, double lat, const Ruleset *ruleset) const
 {
-	std::vector<Region *>::const_iterator found = std::find_if(_regions.begin(), _regions.end(), ContainsPoint(lon, lat));
-	if (found != _regions.end())
+	const RuleRegion *rules = ruleset->locateRegion(lon, lat);
+	if (rules != 0)
+	{
+		for (std::vector<Region*>::const_iterator i = _regions.begin(); i != _regions.end(); ++i)
+		{
+			if ((*i)->getRules() == rules)
+			{
+				return *i;
+			}
+		}
+	}
+	for (std::vector<Region*>::const_iterator i = _regions.begin(); i != _regions.end(); ++i)
 	{
-		return *found;
+		if ((*i)->getRules()->insideRegion(lon, lat))
+		{
+			return *i;
+		}
 	}
 	return 0;
 }
@@ -1552,11 +1834,55 @@ Region *SavedGame::locateRegion(double lon, double lat) const
 /**
  * Find the region containing this target.
  * @param target The target to locate.
+ * @param ruleset The ruleset, used to look up the region's area.
  * @return Pointer to the region, or 0.
  */
-Region *SavedGame::locateRegion(const Target &target) const
+Region *SavedGame::locateRegion(const Target &target, const Ruleset *ruleset) const
+{
+	return locateRegion(target.getLongitude(), target.getLatitude(), ruleset);
+}
+
+/**
+ * Find the country containing this location.
+ * If the ruleset's globe index doesn't lead to one of
+ * the game's countries, every country is checked instead.
+ * @param lon The longtitude.
+ * @param lat The latitude.
+ * @param ruleset The ruleset, used to look up the country's area.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(double lon, double lat, const Ruleset *ruleset) const
+{
+	const RuleCountry *rules = ruleset->locateCountry(lon, lat);
+	if (rules != 0)
+	{
+		for (std::vector<Country*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
+		{
+			if ((*i)->getRules() == rules)
+			{
+				return *i;
+			}
+		}
+	}
+	for (std::vector<Country*>::const_iterator i = _countries.begin(); i != _countries.end(); ++i)
+	{
+		if ((*i)->getRules()->insideCountry(lon, lat))
+		{
+			return *i;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Find the country containing this target.
+ * @param target The target to locate.
+ * @param ruleset The ruleset, used to look up the country's area.
+ * @return Pointer to the country, or 0.
+ */
+Country *SavedGame::locateCountry(const Target &target, const Ruleset *ruleset) const
 {
-	return locateRegion(target.getLongitude(), target.getLatitude());
+	return locateCountry(target.getLongitude(), target.getLatitude(), ruleset);
 }
 
 /*
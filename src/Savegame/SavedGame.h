@@ -20,9 +20,11 @@
 #define OPENXCOM_SAVEDGAME_H
 
 #include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <time.h>
+#include "../Engine/RNG.h"
 
 namespace OpenXcom
 {
@@ -98,6 +100,8 @@ private:
 	AlienStrategy *_alienStrategy;
 	SavedBattleGame *_battleGame;
 	std::vector<const RuleResearch *> _discovered;
+	std::vector<bool> _researched;
+	std::set<std::string> _researchedNames;
 	std::vector<AlienMission*> _activeMissions;
 	bool _debug, _warned;
 	int _monthsPassed;
@@ -107,8 +111,15 @@ private:
 	std::vector<const RuleResearch *> _poppedResearch;
 	std::vector<Soldier*> _deadSoldiers;
 	size_t _selectedBase;
+	RNG::Stream _rng;
 
 	void getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const Ruleset * ruleset, Base * base) const;
+	void getDependableResearchBasic (std::vector<RuleResearch *> & dependables, const RuleResearch *research, const std::vector<RuleResearch *> & possible) const;
+	void getPossibleResearch (std::vector<RuleResearch *> & possible, const Ruleset * ruleset, Base * base) const;
+	bool isResearchAvailable (RuleResearch * r, const std::vector<bool> & unlocked, const Ruleset * ruleset) const;
+	void markResearched (const RuleResearch * r);
+	bool isDiscovered (int index) const;
+	bool isDiscovered (const RuleResearch * r) const;
 	static SaveInfo getSaveInfo(const std::string &file, Language *lang);
 public:
 	static const std::string AUTOSAVE_GEOSCAPE, AUTOSAVE_BATTLESCAPE, QUICKSAVE;
@@ -183,6 +194,8 @@ public:
 	SavedBattleGame *getSavedBattle();
 	/// Sets the current battle game.
 	void setBattleGame(SavedBattleGame *battleGame);
+	/// Gets the random stream the game is drawing from.
+	RNG::Stream *getRNG();
 	/// Add a finished ResearchProject
 	void addFinishedResearch (const RuleResearch * r, const Ruleset * ruleset = NULL);
 	/// Get the list of already discovered research projects
@@ -238,9 +251,13 @@ public:
 	/// Gets a mission matching region and type.
 	AlienMission *getAlienMission(const std::string &region, const std::string &type) const;
 	/// Locate a region containing a position.
-	Region *locateRegion(double lon, double lat) const;
+	Region *locateRegion(double lon, double lat, const Ruleset *ruleset) const;
 	/// Locate a region containing a Target.
-	Region *locateRegion(const Target &target) const;
+	Region *locateRegion(const Target &target, const Ruleset *ruleset) const;
+	/// Locate a country containing a position.
+	Country *locateCountry(double lon, double lat, const Ruleset *ruleset) const;
+	/// Locate a country containing a Target.
+	Country *locateCountry(const Target &target, const Ruleset *ruleset) const;
 	/// Return the month counter.
 	int getMonthsPassed() const;
 	/// Return the GraphRegionToggles.
@@ -44,27 +44,50 @@ Tile::SerializationKey Tile::serializationKey =
  4 + 2*4 + 2*4 + 1 + 1 + 1 // total bytes to save one tile
 };
 
+/**
+ * Resizes the arrays to hold a number of tiles, and resets every field of every tile.
+ * @param size Number of tiles.
+ */
+void TileStore::resize(int size)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		objects[i].assign(size, 0);
+		currentFrame[i].assign(size, 0);
+	}
+	for (int layer = 0; layer < LIGHTLAYERS; ++layer)
+	{
+		light[layer].assign(size, 0);
+		lastLight[layer].assign(size, -1);
+	}
+	discovered.assign(size, 0);
+	smoke.assign(size, 0);
+	fire.assign(size, 0);
+	visible.assign(size, 0);
+}
+
+/**
+ * Resets a light layer of every tile to zero, like Tile::resetLight does for one tile.
+ * @param layer Light layer.
+ */
+void TileStore::resetLight(int layer)
+{
+	std::fill(light[layer].begin(), light[layer].end(), 0);
+	std::fill(lastLight[layer].begin(), lastLight[layer].end(), 0);
+}
+
 /**
 * constructor
 * @param pos Position.
+* @param store Store holding the fields of the tiles, already sized for the map.
+* @param index Index of this tile in the store.
 */
-Tile::Tile(const Position& pos): _smoke(0), _fire(0), _explosive(0), _pos(pos), _unit(0), _animationOffset(0), _markerColor(0), _visible(false), _preview(-1), _TUMarker(-1), _overlaps(0), _danger(false)
+Tile::Tile(const Position& pos, TileStore *store, int index): _store(store), _index(index), _unit(0), _danger(false), _pos(pos), _explosive(0), _animationOffset(0), _markerColor(0), _preview(-1), _TUMarker(-1), _overlaps(0)
 {
 	for (int i = 0; i < 4; ++i)
 	{
-		_objects[i] = 0;
 		_mapDataID[i] = -1;
 		_mapDataSetID[i] = -1;
-		_currentFrame[i] = 0;
-	}
-	for (int layer = 0; layer < LIGHTLAYERS; layer++)
-	{
-		_light[layer] = 0;
-		_lastLight[layer] = -1;
-	}
-	for (int i = 0; i < 3; ++i)
-	{
-		_discovered[i] = false;
 	}
 }
 
@@ -88,19 +111,23 @@ void Tile::load(const YAML::Node &node)
 		_mapDataID[i] = node["mapDataID"][i].as<int>(_mapDataID[i]);
 		_mapDataSetID[i] = node["mapDataSetID"][i].as<int>(_mapDataSetID[i]);
 	}
-	_fire = node["fire"].as<int>(_fire);
-	_smoke = node["smoke"].as<int>(_smoke);
+	_store->fire[_index] = node["fire"].as<int>(_store->fire[_index]);
+	_store->smoke[_index] = node["smoke"].as<int>(_store->smoke[_index]);
+	Uint8 &discovered = _store->discovered[_index];
 	for (int i = 0; i < 3; i++)
 	{
-		_discovered[i] = node["discovered"][i].as<bool>();
+		if (node["discovered"][i].as<bool>())
+			discovered |= (1 << i);
+		else
+			discovered &= ~(1 << i);
 	}
 	if (node["openDoorWest"])
 	{
-		_currentFrame[1] = 7;
+		_store->currentFrame[1][_index] = 7;
 	}
 	if (node["openDoorNorth"])
 	{
-		_currentFrame[2] = 7;
+		_store->currentFrame[2][_index] = 7;
 	}
 }
 
@@ -120,15 +147,13 @@ void Tile::loadBinary(Uint8 *buffer, Tile::SerializationKey& serKey)
 	_mapDataSetID[2] = unserializeInt(&buffer, serKey._mapDataSetID);
 	_mapDataSetID[3] = unserializeInt(&buffer, serKey._mapDataSetID);
 
-	_smoke = unserializeInt(&buffer, serKey._smoke);
-	_fire = unserializeInt(&buffer, serKey._fire);
+	_store->smoke[_index] = unserializeInt(&buffer, serKey._smoke);
+	_store->fire[_index] = unserializeInt(&buffer, serKey._fire);
 
     Uint8 boolFields = unserializeInt(&buffer, serKey.boolFields);
-	_discovered[0] = (boolFields & 1) ? true : false;
-	_discovered[1] = (boolFields & 2) ? true : false;
-	_discovered[2] = (boolFields & 4) ? true : false;
-	_currentFrame[1] = (boolFields & 8) ? 7 : 0;
-	_currentFrame[2] = (boolFields & 0x10) ? 7 : 0;
+	_store->discovered[_index] = boolFields & 7;
+	_store->currentFrame[1][_index] = (boolFields & 8) ? 7 : 0;
+	_store->currentFrame[2][_index] = (boolFields & 0x10) ? 7 : 0;
 }
 
 
@@ -145,15 +170,15 @@ YAML::Node Tile::save() const
 		node["mapDataID"].push_back(_mapDataID[i]);
 		node["mapDataSetID"].push_back(_mapDataSetID[i]);
 	}
-	if (_smoke)
-		node["smoke"] = _smoke;
-	if (_fire)
-		node["fire"] = _fire;
-	if (_discovered[0] || _discovered[1] || _discovered[2])
+	if (_store->smoke[_index])
+		node["smoke"] = _store->smoke[_index];
+	if (_store->fire[_index])
+		node["fire"] = _store->fire[_index];
+	if (_store->discovered[_index])
 	{
 		for (int i = 0; i < 3; i++)
 		{
-			node["discovered"].push_back(_discovered[i]);
+			node["discovered"].push_back(isDiscovered(i));
 		}
 	}
 	if (isUfoDoorOpen(1))
@@ -182,10 +207,10 @@ void Tile::saveBinary(Uint8** buffer) const
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[2]);
 	serializeInt(buffer, serializationKey._mapDataSetID, _mapDataSetID[3]);
 
-	serializeInt(buffer, serializationKey._smoke, _smoke);
-	serializeInt(buffer, serializationKey._fire, _fire);
+	serializeInt(buffer, serializationKey._smoke, _store->smoke[_index]);
+	serializeInt(buffer, serializationKey._fire, _store->fire[_index]);
 
-	Uint8 boolFields = (_discovered[0]?1:0) + (_discovered[1]?2:0) + (_discovered[2]?4:0);
+	Uint8 boolFields = _store->discovered[_index];
 	boolFields |= isUfoDoorOpen(1) ? 8 : 0; // west
 	boolFields |= isUfoDoorOpen(2) ? 0x10 : 0; // north?
 	serializeInt(buffer, serializationKey.boolFields, boolFields);
@@ -200,7 +225,7 @@ void Tile::saveBinary(Uint8** buffer) const
  */
 void Tile::setMapData(MapData *dat, int mapDataID, int mapDataSetID, int part)
 {
-	_objects[part] = dat;
+	_store->objects[part][_index] = dat;
 	_mapDataID[part] = mapDataID;
 	_mapDataSetID[part] = mapDataSetID;
 }
@@ -224,7 +249,7 @@ void Tile::getMapData(int *mapDataID, int *mapDataSetID, int part) const
  */
 bool Tile::isVoid() const
 {
-	return _objects[0] == 0 && _objects[1] == 0 && _objects[2] == 0 && _objects[3] == 0 && _smoke == 0 && _inventory.empty();
+	return _store->objects[0][_index] == 0 && _store->objects[1][_index] == 0 && _store->objects[2][_index] == 0 && _store->objects[3][_index] == 0 && _store->smoke[_index] == 0 && _inventory.empty();
 }
 
 /**
@@ -235,13 +260,13 @@ bool Tile::isVoid() const
  */
 int Tile::getTUCost(int part, MovementType movementType) const
 {
-	if (_objects[part])
+	if (_store->objects[part][_index])
 	{
-		if (_objects[part]->isUFODoor() && _currentFrame[part] == 7)
+		if (_store->objects[part][_index]->isUFODoor() && _store->currentFrame[part][_index] == 7)
 			return 0;
-		if (_objects[part]->getBigWall() >= 4)
+		if (_store->objects[part][_index]->getBigWall() >= 4)
 			return 0;
-		return _objects[part]->getTUCost(movementType);
+		return _store->objects[part][_index]->getTUCost(movementType);
 	}
 	else
 		return 0;
@@ -256,8 +281,8 @@ bool Tile::hasNoFloor(Tile *tileBelow) const
 {
 	if (tileBelow != 0 && tileBelow->getTerrainLevel() == -24)
 		return false;
-	if (_objects[MapData::O_FLOOR])
-		return _objects[MapData::O_FLOOR]->isNoFloor();
+	if (_store->objects[MapData::O_FLOOR][_index])
+		return _store->objects[MapData::O_FLOOR][_index]->isNoFloor();
 	else
 		return true;
 }
@@ -268,8 +293,8 @@ bool Tile::hasNoFloor(Tile *tileBelow) const
  */
 bool Tile::isBigWall() const
 {
-	if (_objects[MapData::O_OBJECT])
-		return (_objects[MapData::O_OBJECT]->getBigWall() != 0);
+	if (_store->objects[MapData::O_OBJECT][_index])
+		return (_store->objects[MapData::O_OBJECT][_index]->getBigWall() != 0);
 	else
 		return false;
 }
@@ -282,10 +307,10 @@ int Tile::getTerrainLevel() const
 {
 	int level = 0;
 
-	if (_objects[MapData::O_FLOOR])
-		level = _objects[MapData::O_FLOOR]->getTerrainLevel();
-	if (_objects[MapData::O_OBJECT])
-		level += _objects[MapData::O_OBJECT]->getTerrainLevel();
+	if (_store->objects[MapData::O_FLOOR][_index])
+		level = _store->objects[MapData::O_FLOOR][_index]->getTerrainLevel();
+	if (_store->objects[MapData::O_OBJECT][_index])
+		level += _store->objects[MapData::O_OBJECT][_index]->getTerrainLevel();
 
 	return level;
 }
@@ -299,11 +324,11 @@ int Tile::getFootstepSound(Tile *tileBelow) const
 {
 	int sound = 0;
 
-	if (_objects[MapData::O_FLOOR])
-		sound = _objects[MapData::O_FLOOR]->getFootstepSound();
-	if (_objects[MapData::O_OBJECT] && _objects[MapData::O_OBJECT]->getBigWall() == 0)
-		sound = _objects[MapData::O_OBJECT]->getFootstepSound();
-	if (!_objects[MapData::O_FLOOR] && !_objects[MapData::O_OBJECT] && tileBelow != 0 && tileBelow->getTerrainLevel() == -24)
+	if (_store->objects[MapData::O_FLOOR][_index])
+		sound = _store->objects[MapData::O_FLOOR][_index]->getFootstepSound();
+	if (_store->objects[MapData::O_OBJECT][_index] && _store->objects[MapData::O_OBJECT][_index]->getBigWall() == 0)
+		sound = _store->objects[MapData::O_OBJECT][_index]->getFootstepSound();
+	if (!_store->objects[MapData::O_FLOOR][_index] && !_store->objects[MapData::O_OBJECT][_index] && tileBelow != 0 && tileBelow->getTerrainLevel() == -24)
 		sound = tileBelow->getMapData(MapData::O_OBJECT)->getFootstepSound();
 
 	return sound;
@@ -319,27 +344,27 @@ int Tile::getFootstepSound(Tile *tileBelow) const
  */
 int Tile::openDoor(int part, BattleUnit *unit, BattleActionType reserve)
 {
-	if (!_objects[part]) return -1;
+	if (!_store->objects[part][_index]) return -1;
 
-	if (_objects[part]->isDoor())
+	if (_store->objects[part][_index]->isDoor())
 	{
-		if (unit && unit->getTimeUnits() < _objects[part]->getTUCost(unit->getArmor()->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
+		if (unit && unit->getTimeUnits() < _store->objects[part][_index]->getTUCost(unit->getArmor()->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
 			return 4;
 		if (_unit && _unit != unit && _unit->getPosition() != getPosition())
 			return -1;
-		setMapData(_objects[part]->getDataset()->getObjects()->at(_objects[part]->getAltMCD()), _objects[part]->getAltMCD(), _mapDataSetID[part],
-				   _objects[part]->getDataset()->getObjects()->at(_objects[part]->getAltMCD())->getObjectType());
+		setMapData(_store->objects[part][_index]->getDataset()->getObjects()->at(_store->objects[part][_index]->getAltMCD()), _store->objects[part][_index]->getAltMCD(), _mapDataSetID[part],
+				   _store->objects[part][_index]->getDataset()->getObjects()->at(_store->objects[part][_index]->getAltMCD())->getObjectType());
 		setMapData(0, -1, -1, part);
 		return 0;
 	}
-	if (_objects[part]->isUFODoor() && _currentFrame[part] == 0) // ufo door part 0 - door is closed
+	if (_store->objects[part][_index]->isUFODoor() && _store->currentFrame[part][_index] == 0) // ufo door part 0 - door is closed
 	{
-		if (unit &&	unit->getTimeUnits() < _objects[part]->getTUCost(unit->getArmor()->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
+		if (unit &&	unit->getTimeUnits() < _store->objects[part][_index]->getTUCost(unit->getArmor()->getMovementType()) + unit->getActionTUs(reserve, unit->getMainHandWeapon(false)))
 			return 4;
-		_currentFrame[part] = 1; // start opening door
+		_store->currentFrame[part][_index] = 1; // start opening door
 		return 1;
 	}
-	if (_objects[part]->isUFODoor() && _currentFrame[part] != 7) // ufo door != part 7 - door is still opening
+	if (_store->objects[part][_index]->isUFODoor() && _store->currentFrame[part][_index] != 7) // ufo door != part 7 - door is still opening
 	{
 		return 3;
 	}
@@ -354,7 +379,7 @@ int Tile::closeUfoDoor()
 	{
 		if (isUfoDoorOpen(part))
 		{
-			_currentFrame[part] = 0;
+			_store->currentFrame[part][_index] = 0;
 			retval = 1;
 		}
 	}
@@ -369,13 +394,16 @@ int Tile::closeUfoDoor()
  */
 void Tile::setDiscovered(bool flag, int part)
 {
-	if (_discovered[part] != flag)
+	Uint8 &discovered = _store->discovered[_index];
+	if (isDiscovered(part) != flag)
 	{
-		_discovered[part] = flag;
+		if (flag)
+			discovered |= (1 << part);
+		else
+			discovered &= ~(1 << part);
 		if (part == 2 && flag == true)
 		{
-			_discovered[0] = true;
-			_discovered[1] = true;
+			discovered |= 3; // walls too
 		}
 		// if light on tile changes, units and objects on it change light too
 		if (_unit != 0)
@@ -392,7 +420,7 @@ void Tile::setDiscovered(bool flag, int part)
  */
 bool Tile::isDiscovered(int part) const
 {
-	return _discovered[part];
+	return (_store->discovered[_index] & (1 << part)) != 0;
 }
 
 
@@ -402,8 +430,8 @@ bool Tile::isDiscovered(int part) const
  */
 void Tile::resetLight(int layer)
 {
-	_light[layer] = 0;
-	_lastLight[layer] = _light[layer];
+	_store->light[layer][_index] = 0;
+	_store->lastLight[layer][_index] = _store->light[layer][_index];
 }
 
 /**
@@ -413,8 +441,8 @@ void Tile::resetLight(int layer)
  */
 void Tile::addLight(int light, int layer)
 {
-	if (_light[layer] < light)
-		_light[layer] = light;
+	if (_store->light[layer][_index] < light)
+		_store->light[layer][_index] = light;
 }
 
 /**
@@ -428,8 +456,8 @@ int Tile::getShade() const
 
 	for (int layer = 0; layer < LIGHTLAYERS; layer++)
 	{
-		if (_light[layer] > light)
-			light = _light[layer];
+		if (_store->light[layer][_index] > light)
+			light = _store->light[layer][_index];
 	}
 
 	return std::max(0, 15 - light);
@@ -445,12 +473,12 @@ int Tile::getShade() const
 bool Tile::destroy(int part)
 {
 	bool _objective = false;
-	if (_objects[part])
+	if (_store->objects[part][_index])
 	{
-		if (_objects[part]->isGravLift())
+		if (_store->objects[part][_index]->isGravLift())
 			return false;
-		_objective = _objects[part]->getSpecialType() == MUST_DESTROY;
-		MapData *originalPart = _objects[part];
+		_objective = _store->objects[part][_index]->getSpecialType() == MUST_DESTROY;
+		MapData *originalPart = _store->objects[part][_index];
 		int originalMapDataSetID = _mapDataSetID[part];
 		setMapData(0, -1, -1, part);
 		if (originalPart->getDieMCD())
@@ -464,7 +492,7 @@ bool Tile::destroy(int part)
 		}
 	}
 	/* check if the floor on the lowest level is gone */
-	if (part == MapData::O_FLOOR && getPosition().z == 0 && _objects[MapData::O_FLOOR] == 0)
+	if (part == MapData::O_FLOOR && getPosition().z == 0 && _store->objects[MapData::O_FLOOR][_index] == 0)
 	{
 		/* replace with scorched earth */
 		setMapData(MapDataSet::getScorchedEarthTile(), 1, 0, MapData::O_FLOOR);
@@ -481,7 +509,7 @@ bool Tile::destroy(int part)
 bool Tile::damage(int part, int power)
 {
 	bool objective = false;
-	if (power >= _objects[part]->getArmor())
+	if (power >= _store->objects[part][_index]->getArmor())
 		objective = destroy(part);
 	return objective;
 }
@@ -518,13 +546,13 @@ int Tile::getFlammability() const
 {
 	int flam = 255;
 
-	if (_objects[3])
+	if (_store->objects[3][_index])
 	{
-		flam = _objects[3]->getFlammable();
+		flam = _store->objects[3][_index]->getFlammable();
 	}
-	else if (_objects[0])
+	else if (_store->objects[0][_index])
 	{
-		flam = _objects[0]->getFlammable();
+		flam = _store->objects[0][_index]->getFlammable();
 	}
 
 	return flam;
@@ -538,13 +566,13 @@ int Tile::getFuel() const
 {
 	int fuel = 0;
 
-	if (_objects[3])
+	if (_store->objects[3][_index])
 	{
-		fuel = _objects[3]->getFuel();
+		fuel = _store->objects[3][_index]->getFuel();
 	}
-	else if (_objects[0])
+	else if (_store->objects[0][_index])
 	{
-		fuel = _objects[0]->getFuel();
+		fuel = _store->objects[0][_index]->getFuel();
 	}
 
 	return fuel;
@@ -564,11 +592,11 @@ void Tile::ignite(int power)
 		}
 		if (RNG::percent(power) && getFuel())
 		{
-			if (_fire == 0)
+			if (_store->fire[_index] == 0)
 			{
-				_smoke = 15 - std::max(1, std::min((getFlammability() / 10), 12));
+				_store->smoke[_index] = 15 - std::max(1, std::min((getFlammability() / 10), 12));
 				_overlaps = 1;
-				_fire = getFuel() + 1;
+				_store->fire[_index] = getFuel() + 1;
 				_animationOffset = RNG::generate(0,3);
 			}
 		}
@@ -585,14 +613,14 @@ void Tile::animate()
 	int newframe;
 	for (int i=0; i < 4; ++i)
 	{
-		if (_objects[i])
+		if (_store->objects[i][_index])
 		{
-			if (_objects[i]->isUFODoor() && (_currentFrame[i] == 0 || _currentFrame[i] == 7)) // ufo door is static
+			if (_store->objects[i][_index]->isUFODoor() && (_store->currentFrame[i][_index] == 0 || _store->currentFrame[i][_index] == 7)) // ufo door is static
 			{
 				continue;
 			}
-			newframe = _currentFrame[i] + 1;
-			if (_objects[i]->isUFODoor() && _objects[i]->getSpecialType() == START_POINT && newframe == 3)
+			newframe = _store->currentFrame[i][_index] + 1;
+			if (_store->objects[i][_index]->isUFODoor() && _store->objects[i][_index]->getSpecialType() == START_POINT && newframe == 3)
 			{
 				newframe = 7;
 			}
@@ -600,7 +628,7 @@ void Tile::animate()
 			{
 				newframe = 0;
 			}
-			_currentFrame[i] = newframe;
+			_store->currentFrame[i][_index] = newframe;
 		}
 	}
 }
@@ -612,10 +640,10 @@ void Tile::animate()
  */
 Surface *Tile::getSprite(int part) const
 {
-	if (_objects[part] == 0)
+	if (_store->objects[part][_index] == 0)
 		return 0;
 
-	return _objects[part]->getDataset()->getSurfaceset()->getFrame(_objects[part]->getSprite(_currentFrame[part]));
+	return _store->objects[part][_index]->getDataset()->getSurfaceset()->getFrame(_store->objects[part][_index]->getSprite(_store->currentFrame[part][_index]));
 }
 
 /**
@@ -638,7 +666,7 @@ void Tile::setUnit(BattleUnit *unit, Tile *tileBelow)
  */
 void Tile::setFire(int fire)
 {
-	_fire = fire;
+	_store->fire[_index] = fire;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -648,7 +676,7 @@ void Tile::setFire(int fire)
  */
 int Tile::getFire() const
 {
-	return _fire;
+	return _store->fire[_index];
 }
 
 /**
@@ -657,15 +685,15 @@ int Tile::getFire() const
  */
 void Tile::addSmoke(int smoke)
 {
-	if (_fire == 0)
+	if (_store->fire[_index] == 0)
 	{
 		if (_overlaps == 0)
 		{
-			_smoke = std::max(1, std::min(_smoke + smoke, 15));
+			_store->smoke[_index] = std::max(1, std::min(_store->smoke[_index] + smoke, 15));
 		}
 		else
 		{
-			_smoke += smoke;
+			_store->smoke[_index] += smoke;
 		}
 		_animationOffset = RNG::generate(0,3);
 		addOverlap();
@@ -678,7 +706,7 @@ void Tile::addSmoke(int smoke)
  */
 void Tile::setSmoke(int smoke)
 {
-	_smoke = smoke;
+	_store->smoke[_index] = smoke;
 	_animationOffset = RNG::generate(0,3);
 }
 
@@ -689,7 +717,7 @@ void Tile::setSmoke(int smoke)
  */
 int Tile::getSmoke() const
 {
-	return _smoke;
+	return _store->smoke[_index];
 }
 
 /**
@@ -758,23 +786,23 @@ int Tile::getTopItemSprite()
 void Tile::prepareNewTurn()
 {
 	// we've recieved new smoke in this turn, but we're not on fire, average out the smoke.
-	if ( _overlaps != 0 && _smoke != 0 && _fire == 0)
+	if ( _overlaps != 0 && _store->smoke[_index] != 0 && _store->fire[_index] == 0)
 	{
-		_smoke = std::max(0, std::min((_smoke / _overlaps)- 1, 15));
+		_store->smoke[_index] = std::max(0, std::min((_store->smoke[_index] / _overlaps)- 1, 15));
 	}
 	// if we still have smoke/fire
-	if (_smoke)
+	if (_store->smoke[_index])
 	{
 		if (_unit && !_unit->isOut())
 		{
-			if (_fire)
+			if (_store->fire[_index])
 			{
 				// this is how we avoid hitting the same unit multiple times.
 				if (_unit->getArmor()->getSize() == 1 || !_unit->tookFireDamage())
 				{
 					_unit->toggleFireDamage();
-					// _smoke becomes our damage value
-					_unit->damage(Position(0, 0, 0), _smoke, DT_IN, true);
+					// smoke becomes our damage value
+					_unit->damage(Position(0, 0, 0), _store->smoke[_index], DT_IN, true);
 					// try to set the unit on fire.
 					if (RNG::percent(40 * _unit->getArmor()->getDamageModifier(DT_IN)))
 					{
@@ -795,7 +823,7 @@ void Tile::prepareNewTurn()
 					// try to knock this guy out.
 					if (_unit->getArmor()->getDamageModifier(DT_SMOKE) > 0.0 && _unit->getArmor()->getSize() == 1)
 					{
-						_unit->damage(Position(0,0,0), (_smoke / 4) + 1, DT_SMOKE, true);
+						_unit->damage(Position(0,0,0), (_store->smoke[_index] / 4) + 1, DT_SMOKE, true);
 					}
 				}
 			}
@@ -839,7 +867,7 @@ int Tile::getMarkerColor()
  */
 void Tile::setVisible(int visibility)
 {
-	_visible += visibility;
+	_store->visible[_index] += visibility;
 }
 
 /**
@@ -848,7 +876,7 @@ void Tile::setVisible(int visibility)
  */
 int Tile::getVisible()
 {
-	return _visible;
+	return _store->visible[_index];
 }
 
 /**
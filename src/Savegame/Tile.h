@@ -36,6 +36,25 @@ class BattleUnit;
 class BattleItem;
 class RuleInventory;
 
+/**
+ * The tile fields read by the full map sweeps (lighting, FOV, drawing), kept in one array per field
+ * and indexed like the tiles of the map, so a sweep over one field walks contiguous memory.
+ */
+struct TileStore
+{
+	static const int LIGHTLAYERS = 3;
+	std::vector<MapData*> objects[4];
+	std::vector<Uint8> currentFrame[4];
+	std::vector<Sint16> light[LIGHTLAYERS], lastLight[LIGHTLAYERS];
+	std::vector<Uint8> discovered; // one bit per part
+	std::vector<int> smoke, fire, visible;
+
+	/// Resizes the arrays and resets every field.
+	void resize(int size);
+	/// Resets a light layer of every tile to zero.
+	void resetLight(int layer);
+};
+
 /**
  * Basic element of which a battle map is build.
  * @sa http://www.ufopaedia.org/index.php?title=MAPS
@@ -58,29 +77,25 @@ public:
 	static const int NOT_CALCULATED = -1;
 
 protected:
-	static const int LIGHTLAYERS = 3;
-	MapData *_objects[4];
-	int _mapDataID[4];
-	int _mapDataSetID[4];
-	int _currentFrame[4];
-	bool _discovered[3];
-	int _light[LIGHTLAYERS], _lastLight[LIGHTLAYERS];
-	int _smoke;
-	int _fire;
-	int _explosive;
-	Position _pos;
+	static const int LIGHTLAYERS = TileStore::LIGHTLAYERS;
+	// the fields read by the full map sweeps live in the store, at this tile's index
+	TileStore *_store;
+	int _index;
 	BattleUnit *_unit;
-	std::vector<BattleItem *> _inventory;
+	bool _danger;
+	Position _pos;
+	Sint16 _mapDataID[4];
+	Sint16 _mapDataSetID[4];
+	int _explosive;
 	int _animationOffset;
 	int _markerColor;
-	int _visible;
 	int _preview;
 	int _TUMarker;
 	int _overlaps;
-	bool _danger;
+	std::vector<BattleItem *> _inventory;
 public:
 	/// Creates a tile.
-	Tile(const Position& pos);
+	Tile(const Position& pos, TileStore *store, int index);
 	/// Cleans up a tile.
 	~Tile();
 	/// Load the tile from yaml
@@ -103,7 +118,7 @@ public:
 		{
 			return NULL;
 		}
-		return _objects[part];
+		return _store->objects[part][_index];
 	}
 
 	/// Sets the pointer to the mapdata for a specific part of the tile
@@ -143,7 +158,8 @@ public:
 	 */
 	bool isUfoDoorOpen(int part) const
 	{
-		return (_objects[part] && _objects[part]->isUFODoor() && _currentFrame[part] != 0);
+		MapData *object = _store->objects[part][_index];
+		return (object && object->isUFODoor() && _store->currentFrame[part][_index] != 0);
 	}
 
 	/// Close ufo door.
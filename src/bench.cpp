@@ -0,0 +1,159 @@
+/*
+ * Copyright 2010-2014 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <exception>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <map>
+#include <algorithm>
+#include <SDL.h>
+#include "version.h"
+#include "Engine/Logger.h"
+#include "Engine/Game.h"
+#include "Engine/State.h"
+#include "Engine/Options.h"
+#include "Engine/Exception.h"
+#include "Resource/XcomResourcePack.h"
+#include "Ruleset/Ruleset.h"
+#include "Battlescape/BattlescapeBenchmark.h"
+
+/**
+ * Headless battlescape benchmark. Loads the game data, generates
+ * a battle, lets the AI play every side for a number of turns
+ * and writes how long each engine phase took as JSON.
+ * Takes the same folder options as the game, plus its own.
+ */
+
+using namespace OpenXcom;
+
+static void showUsage()
+{
+	std::cout << "OpenXcom benchmark v" << OPENXCOM_VERSION_SHORT << std::endl;
+	std::cout << "Usage: openxcom-bench [OPTION]..." << std::endl << std::endl;
+	std::cout << "-data PATH, -user PATH, -cfg PATH" << std::endl;
+	std::cout << "        same as the game" << std::endl;
+	std::cout << "-ruleset NAME" << std::endl;
+	std::cout << "        load ruleset NAME instead of the configured ones" << std::endl;
+	std::cout << "-mission ID" << std::endl;
+	std::cout << "        UFO type or alien deployment to play (default: first UFO)" << std::endl;
+	std::cout << "-terrain ID, -race ID, -craft ID" << std::endl;
+	std::cout << "        terrain, alien race and craft to use (default: first in ruleset)" << std::endl;
+	std::cout << "-seed N" << std::endl;
+	std::cout << "        random seed (default: 0)" << std::endl;
+	std::cout << "-turns N" << std::endl;
+	std::cout << "        number of full turns to play (default: 10)" << std::endl;
+	std::cout << "-difficulty N, -darkness N" << std::endl;
+	std::cout << "        game difficulty 0-4 and battlescape darkness 0-15 (default: 0)" << std::endl;
+	std::cout << "-out FILE" << std::endl;
+	std::cout << "        write the JSON results to FILE instead of standard output" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	std::map<std::string, std::string> args;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg.length() > 1 && arg[0] == '-')
+		{
+			std::string argname = arg.substr(arg[1] == '-' ? 2 : 1);
+			std::transform(argname.begin(), argname.end(), argname.begin(), ::tolower);
+			if (argname == "help" || argname == "?")
+			{
+				showUsage();
+				return EXIT_SUCCESS;
+			}
+			if (i + 1 < argc)
+			{
+				args[argname] = argv[++i];
+			}
+		}
+	}
+
+	Game *game = 0;
+	try
+	{
+		Logger::reportingLevel() = LOG_WARNING;
+		if (!Options::init(argc, argv))
+			return EXIT_SUCCESS;
+		if (args.find("ruleset") != args.end())
+		{
+			Options::rulesets.clear();
+			Options::rulesets.push_back(args["ruleset"]);
+		}
+
+		// No window or sound, the battle is never drawn
+		SDL_putenv(const_cast<char*>("SDL_VIDEODRIVER=dummy"));
+		SDL_putenv(const_cast<char*>("SDL_AUDIODRIVER=dummy"));
+		Options::fullscreen = false;
+		Options::useOpenGL = false;
+		Options::baseXResolution = Options::displayWidth;
+		Options::baseYResolution = Options::displayHeight;
+		game = new Game("OpenXcom Benchmark");
+		State::setGamePtr(game);
+		Options::mute = true;
+
+		game->loadRuleset();
+		game->setResourcePack(new XcomResourcePack(game->getRuleset()->getExtraSprites(), game->getRuleset()->getExtraSounds(), game->getThreadPool()));
+		game->defaultLanguage();
+
+		BattlescapeBenchmark bench(game);
+		bench.setMission(args["mission"]);
+		bench.setTerrain(args["terrain"]);
+		bench.setAlienRace(args["race"]);
+		bench.setCraft(args["craft"]);
+		if (args.find("seed") != args.end())
+		{
+			uint64_t seed = 0;
+			std::istringstream(args["seed"]) >> seed;
+			bench.setSeed(seed);
+		}
+		if (args.find("turns") != args.end())
+			bench.setTurns(atoi(args["turns"].c_str()));
+		if (args.find("difficulty") != args.end())
+			bench.setDifficulty(std::min(std::max(atoi(args["difficulty"].c_str()), 0), 4));
+		if (args.find("darkness") != args.end())
+			bench.setDarkness(std::min(std::max(atoi(args["darkness"].c_str()), 0), 15));
+		bench.run();
+
+		if (args.find("out") != args.end())
+		{
+			std::ofstream out(args["out"].c_str());
+			if (!out)
+			{
+				throw Exception("Failed to write " + args["out"]);
+			}
+			bench.save(out);
+		}
+		else
+		{
+			bench.save(std::cout);
+		}
+	}
+	catch (std::exception &e)
+	{
+		std::cerr << "openxcom-bench: " << e.what() << std::endl;
+		delete game;
+		return EXIT_FAILURE;
+	}
+
+	delete game;
+	return EXIT_SUCCESS;
+}